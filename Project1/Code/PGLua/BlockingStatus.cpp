@@ -42,9 +42,11 @@
 
 #pragma hdrstop
 #include "BlockingStatus.h"
+#include "LuaScript.h"
 
 PG_IMPLEMENT_RTTI(BlockingStatus, LuaUserVar);
 LUA_IMPLEMENT_FACTORY(LUA_CHUNK_NEVER_BLOCK, BlockingStatus);
+LUA_IMPLEMENT_MEMBER_TABLE(BlockingStatus, LuaUserVar);
 
 /**
  * Constructor
@@ -52,10 +54,17 @@ LUA_IMPLEMENT_FACTORY(LUA_CHUNK_NEVER_BLOCK, BlockingStatus);
  * @param command Command for this blocking status.
  * @since 4/22/2004 2:01:58 PM -- BMH
  */
-BlockingStatus::BlockingStatus()
+BlockingStatus::BlockingStatus() :
+	FinishedSignaled(false)
+,	WaitTimeout(0)
+{
+}
+
+void BlockingStatus::Register_Members(LuaMemberTableClass *table)
 {
 	LUA_REGISTER_MEMBER_FUNCTION(BlockingStatus, "IsFinished", &BlockingStatus::Is_Finished);
 	LUA_REGISTER_MEMBER_FUNCTION(BlockingStatus, "Result", &BlockingStatus::Result);
+	LUA_REGISTER_MEMBER_FUNCTION(BlockingStatus, "Set_Wait_Timeout", &BlockingStatus::Lua_Set_Wait_Timeout);
 }
 
 /**
@@ -72,6 +81,112 @@ LuaTable* BlockingStatus::Is_Finished(LuaScriptClass * /*script*/, LuaTable * /*
 	return Return_Variable(new LuaBool(true));
 }
 
+/**
+ * Check from C++ whether the blocking call has finished, the same way a
+ * script testing IsFinished() would.  Used to decide when a thread parked
+ * on this status can be resumed.  The default goes through Is_Finished,
+ * derived classes should override this with a direct check.  Statuses that
+ * report Signals_Completion are only asked when a thread parks on them and
+ * call Signal_Finished once they finish.
+ * 
+ * @param script script the status belongs to
+ * 
+ * @return true if the blocking call has finished.
+ */
+bool BlockingStatus::Poll_Finished(LuaScriptClass *script)
+{
+	if (Signals_Completion())
+	{
+		return FinishedSignaled;
+	}
+
+	SmartPtr<LuaTable> params = Alloc_Lua_Table();
+	SmartPtr<LuaTable> rval = Is_Finished(script, params);
+	Free_Lua_Table(params);
+
+	// Lua truth: nothing, nil and false are not finished.
+	bool finished = false;
+	if (rval && rval->Value.size())
+	{
+		LuaVar *var = rval->Value[0];
+		LuaBool *bval = PG_Dynamic_Cast<LuaBool>(var);
+		if (bval)
+		{
+			finished = bval->Value;
+		}
+		else
+		{
+			finished = var->Get_Var_Type() != LUA_VAR_TYPE_VOID;
+		}
+	}
+	Free_Lua_Table(rval);
+	return finished;
+}
+
+/**
+ * Mark the blocking call finished and wake any threads parked on it.
+ * Statuses that report Signals_Completion must call this once they finish,
+ * parked threads aren't polled.
+ */
+void BlockingStatus::Signal_Finished(void)
+{
+	FinishedSignaled = true;
+
+	// Waking only queues the thread for its script's next pump, nothing
+	// can park on this status while we walk the list.
+	for (int i = 0; i < (int)WaitingThreads.size(); i++)
+	{
+		LuaScriptClass::Wake_Parked_Thread(WaitingThreads[i].ScriptID, WaitingThreads[i].ThreadID, WaitingThreads[i].ParkSerial);
+	}
+	WaitingThreads.resize(0);
+}
+
+/**
+ * Remember a thread parked on this status so Signal_Finished can wake it.
+ * 
+ * @param script_id   script the thread belongs to
+ * @param thread_id   thread parked on the status
+ * @param park_serial serial of the parking
+ */
+void BlockingStatus::Add_Waiting_Thread(int script_id, int thread_id, int park_serial)
+{
+	WaitingThreadStruct waiting;
+	waiting.ScriptID = script_id;
+	waiting.ThreadID = thread_id;
+	waiting.ParkSerial = park_serial;
+	WaitingThreads.push_back(waiting);
+}
+
+/**
+ * Limit how long a thread that yields this status stays parked.  Once the
+ * thread has been skipped this many pumps it is resumed even though the
+ * blocking call has not finished, and the script is expected to check
+ * IsFinished itself.
+ * 
+ * @param script script for this object
+ * @param params number of pumps to wait, 0 waits until finished
+ * 
+ * @return NULL
+ */
+LuaTable* BlockingStatus::Lua_Set_Wait_Timeout(LuaScriptClass *script, LuaTable *params)
+{
+	if (params->Value.size() != 1)
+	{
+		script->Script_Error("BlockingStatus::Set_Wait_Timeout -- invalid number of parameters.  Expected 1, got %d.", params->Value.size());
+		return NULL;
+	}
+
+	SmartPtr<LuaNumber> pumps = PG_Dynamic_Cast<LuaNumber>(params->Value[0]);
+	if (!pumps || pumps->Value < 0.0f)
+	{
+		script->Script_Error("BlockingStatus::Set_Wait_Timeout -- expected a non-negative number of pumps.");
+		return NULL;
+	}
+
+	WaitTimeout = (int)pumps->Value;
+	return NULL;
+}
+
 /**
  * Default Result virtual function.
  * 
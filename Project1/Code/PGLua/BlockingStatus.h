@@ -44,6 +44,7 @@
 #define __BLOCKINGSTATUS_H__
 
 #include "LuaScriptVariable.h"
+#include <vector>
 
 /**
  * Base class of a Blocking Status.  BlockingStatus objects are returned
@@ -56,11 +57,20 @@ class BlockingStatus : public LuaUserVar
 public:
 	PG_DECLARE_RTTI();
 	LUA_DECLARE_FACTORY(LUA_CHUNK_NEVER_BLOCK, BlockingStatus);
+	LUA_DECLARE_MEMBER_TABLE(BlockingStatus);
 	BlockingStatus();
 
 	LuaUserVar *Get_Command(void) const;
 	void Set_Command(LuaUserVar *command);
 	virtual LuaTable* Is_Finished(LuaScriptClass *script, LuaTable *params);
+	virtual bool Poll_Finished(LuaScriptClass *script);
+	virtual bool Signals_Completion(void) const { return false; }
+	void Signal_Finished(void);
+	void Add_Waiting_Thread(int script_id, int thread_id, int park_serial);
+	bool Is_Finished_Signaled(void) const { return FinishedSignaled; }
+	void Set_Wait_Timeout(int pumps) { WaitTimeout = pumps; }
+	int Get_Wait_Timeout(void) const { return WaitTimeout; }
+	LuaTable* Lua_Set_Wait_Timeout(LuaScriptClass *script, LuaTable *params);
 	virtual LuaTable* Result(LuaScriptClass *, LuaTable *);
 	virtual bool Save(LuaScriptClass * /*script*/, ChunkWriterClass * /*writer*/);
 	virtual bool Load(LuaScriptClass * /*script*/, ChunkReaderClass * /*reader*/);
@@ -68,7 +78,16 @@ public:
 	virtual LuaTable *Is_Pool_Safe(LuaScriptClass *, LuaTable *) { return Return_Variable(new LuaBool(false)); }
 
 private:
+	struct WaitingThreadStruct {
+		int										ScriptID;
+		int										ThreadID;
+		int										ParkSerial;
+	};
+
 	SmartPtr<LuaUserVar>				Command;
+	bool										FinishedSignaled;
+	int										WaitTimeout;
+	std::vector<WaitingThreadStruct>	WaitingThreads;	// Threads parked on this status, woken by Signal_Finished.
 };
 
 #endif // __BLOCKINGSTATUS_H__
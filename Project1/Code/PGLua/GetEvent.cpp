@@ -46,6 +46,7 @@
 
 PG_IMPLEMENT_RTTI(GetEvent, LuaUserVar);
 LUA_IMPLEMENT_FACTORY(LUA_CHUNK_SCRIPT_GETEVENT, GetEvent);
+LUA_IMPLEMENT_MEMBER_TABLE(GetEvent, LuaUserVar);
 
 
 
@@ -61,6 +62,10 @@ enum GetEventChunks {
  * @since 5/28/2004 12:10:12 PM -- BMH
  */
 GetEvent::GetEvent()
+{
+}
+
+void GetEvent::Register_Members(LuaMemberTableClass *table)
 {
 	LUA_REGISTER_MEMBER_FUNCTION(GetEvent, "Params", &GetEvent::Lua_Params);
 	LUA_REGISTER_MEMBER_FUNCTION(GetEvent, "Reset", &GetEvent::Lua_Reset);
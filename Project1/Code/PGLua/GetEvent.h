@@ -68,6 +68,7 @@ public:
 
 	PG_DECLARE_RTTI();
 	LUA_DECLARE_FACTORY(LUA_CHUNK_SCRIPT_GETEVENT, GetEvent);
+	LUA_DECLARE_MEMBER_TABLE(GetEvent);
 
 	GetEvent();
 
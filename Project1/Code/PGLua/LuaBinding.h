@@ -0,0 +1,451 @@
+// $Id: //depot/Projects/StarWars_Steam/FOC/Code/PGLua/LuaBinding.h#1 $
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Petroglyph Games, Inc.
+//
+//
+//  *****           **                          *                   *
+//  *   **          *                           *                   *
+//  *    *          *                           *                   *
+//  *    *          *     *                 *   *          *        *
+//  *   *     *** ******  * **  ****      ***   * *      * *****    * ***
+//  *  **    *  *   *     **   *   **   **  *   *  *    * **   **   **   *
+//  ***     *****   *     *   *     *  *    *   *  *   **  *    *   *    *
+//  *       *       *     *   *     *  *    *   *   *  *   *    *   *    *
+//  *       *       *     *   *     *  *    *   *   * **   *   *    *    *
+//  *       **       *    *   **   *   **   *   *    **    *  *     *   *
+// **        ****     **  *    ****     *****   *    **    ***      *   *
+//                                          *        *     *
+//                                          *        *     *
+//                                          *       *      *
+//                                      *  *        *      *
+//                                      ****       *       *
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// C O N F I D E N T I A L   S O U R C E   C O D E -- D O   N O T   D I S T R I B U T E
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//              $File: //depot/Projects/StarWars_Steam/FOC/Code/PGLua/LuaBinding.h $
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/** @file */
+
+#ifndef __LUA_BINDING_H__
+#define __LUA_BINDING_H__
+
+#include "LuaScriptVariable.h"
+#include "LuaScript.h"
+#include <string>
+
+/**
+ * Typed member function bindings.
+ *
+ * LUA_BIND registers a member function whose parameters are ordinary C++
+ * types.  The argument checks, conversions and error messages are generated
+ * from the function's signature, and the call goes through the stack calling
+ * convention so no LuaTable or per argument LuaVar is built.
+ *
+ *   float Get_Health_Impl(LuaScriptClass *script);
+ *   void Set_Speed_Impl(LuaScriptClass *script, float speed, LuaOptionalArg<bool> instant);
+ *
+ *   LUA_BIND(GameObjectWrapper, "Set_Speed", &GameObjectWrapper::Set_Speed_Impl);
+ *
+ * The first parameter is always the calling script.  Up to four further
+ * parameters are supported.  As with table convention commands, arguments
+ * past the last parameter are ignored.  A parameter type needs a LuaArgTraits
+ * specialization and a return type a LuaReturnTraits specialization; using
+ * an unsupported type is a compile error.  Returning a LuaVar pointer
+ * passes the object back to Lua, returning NULL returns nil.
+ *
+ * Only valid inside Register_Members.
+ */
+#define LUA_BIND(type, name, func) \
+	table->Register_Member(name, Lua_Bind_Member<type>(func, #type "::" name))
+
+/**
+ * Typed bindings for global function call commands.
+ *
+ * A command object mapped with Map_Global_To_Lua can take the same kind of
+ * typed function in place of Function_Call.  The class declares the stack
+ * call with LUA_DECLARE_BOUND_FUNCTION_CALL and the source file binds it,
+ * in the same way as PG_DECLARE_RTTI and PG_IMPLEMENT_RTTI:
+ *
+ *   class IsPointInNebulaClass : public LuaUserVar
+ *   {
+ *      PG_DECLARE_RTTI();
+ *      LUA_DECLARE_BOUND_FUNCTION_CALL();
+ *      bool Is_Point_In(LuaScriptClass *script, Vector3 position);
+ *   };
+ *
+ *   LUA_BIND_FUNCTION_CALL(IsPointInNebulaClass, "Is_Point_In_Nebula", &IsPointInNebulaClass::Is_Point_In);
+ *
+ * Commands whose parameters change meaning with their Lua type, such as
+ * Find_Nearest, can't be described by one signature and keep Function_Call.
+ */
+#define LUA_DECLARE_BOUND_FUNCTION_CALL() \
+	virtual bool Has_Stack_Function_Call(void) const { return true; } \
+	virtual void Stack_Function_Call(LuaScriptClass *script, LuaStackArgsClass &args)
+
+#define LUA_BIND_FUNCTION_CALL(type, name, func) \
+	void type::Stack_Function_Call(LuaScriptClass *script, LuaStackArgsClass &args) \
+	{ \
+		Lua_Call_Bound(script, args, this, func, name); \
+	}
+
+
+/**
+ * Optional trailing argument.  Missing or nil arguments leave Is_Set false
+ * and Value default constructed.
+ */
+template <typename T>
+class LuaOptionalArg
+{
+public:
+	LuaOptionalArg() : IsSet(false), Value() {}
+
+	bool Is_Set(void) const { return IsSet; }
+	const T &Get(void) const { assert(IsSet); return Value; }
+	const T &Get(const T &default_value) const { return IsSet ? Value : default_value; }
+
+	bool				IsSet;
+	T					Value;
+};
+
+/**
+ * Argument conversion for a bound parameter type.  Get returns false if the
+ * argument can't be converted, the binder reports the error.
+ */
+template <typename T>
+struct LuaArgTraits;
+
+template <>
+struct LuaArgTraits<float>
+{
+	static const char *Get_Type_Name(void) { return "number"; }
+	static bool Get(LuaScriptClass *, LuaStackArgsClass &args, int index, float &value)
+	{
+		if (!args.Is_Number(index)) return false;
+		value = args.Get_Number(index);
+		return true;
+	}
+};
+
+template <>
+struct LuaArgTraits<int>
+{
+	static const char *Get_Type_Name(void) { return "number"; }
+	static bool Get(LuaScriptClass *, LuaStackArgsClass &args, int index, int &value)
+	{
+		if (!args.Is_Number(index)) return false;
+		value = (int)args.Get_Number(index);
+		return true;
+	}
+};
+
+template <>
+struct LuaArgTraits<bool>
+{
+	static const char *Get_Type_Name(void) { return "boolean"; }
+	static bool Get(LuaScriptClass *, LuaStackArgsClass &args, int index, bool &value)
+	{
+		if (!args.Is_Bool(index)) return false;
+		value = args.Get_Bool(index);
+		return true;
+	}
+};
+
+template <>
+struct LuaArgTraits<std::string>
+{
+	static const char *Get_Type_Name(void) { return "string"; }
+	static bool Get(LuaScriptClass *, LuaStackArgsClass &args, int index, std::string &value)
+	{
+		size_t length = 0;
+		const char *str = args.Get_String(index, &length);
+		if (!str) return false;
+		value.assign(str, length);
+		return true;
+	}
+};
+
+template <typename T>
+struct LuaArgTraits<LuaOptionalArg<T> >
+{
+	static const char *Get_Type_Name(void) { return LuaArgTraits<T>::Get_Type_Name(); }
+	static bool Get(LuaScriptClass *script, LuaStackArgsClass &args, int index, LuaOptionalArg<T> &value)
+	{
+		if (args.Is_Nil(index))
+		{
+			value.IsSet = false;
+			return true;
+		}
+		value.IsSet = LuaArgTraits<T>::Get(script, args, index, value.Value);
+		return value.IsSet;
+	}
+};
+
+/**
+ * Return value conversion for a bound function's return type.
+ */
+template <typename T>
+struct LuaReturnTraits;
+
+template <>
+struct LuaReturnTraits<float>
+{
+	static void Push(LuaScriptClass *, LuaStackArgsClass &args, float value) { args.Return_Number(value); }
+};
+
+template <>
+struct LuaReturnTraits<int>
+{
+	static void Push(LuaScriptClass *, LuaStackArgsClass &args, int value) { args.Return_Number((float)value); }
+};
+
+template <>
+struct LuaReturnTraits<bool>
+{
+	static void Push(LuaScriptClass *, LuaStackArgsClass &args, bool value) { args.Return_Bool(value); }
+};
+
+template <>
+struct LuaReturnTraits<std::string>
+{
+	static void Push(LuaScriptClass *, LuaStackArgsClass &args, const std::string &value) { args.Return_String(value.c_str(), value.size()); }
+};
+
+template <>
+struct LuaReturnTraits<LuaVar *>
+{
+	static void Push(LuaScriptClass *, LuaStackArgsClass &args, LuaVar *value) { args.Return_Var(value); }
+};
+
+/**
+ * Strip const and reference from a parameter type so it can be stored.
+ */
+template <typename T> struct LuaArgStorage { typedef T Type; };
+template <typename T> struct LuaArgStorage<const T> { typedef T Type; };
+template <typename T> struct LuaArgStorage<T &> { typedef T Type; };
+template <typename T> struct LuaArgStorage<const T &> { typedef T Type; };
+
+/**
+ * Convert one bound argument, reporting a script error on failure.
+ */
+template <typename T>
+inline bool Lua_Get_Bound_Arg(LuaScriptClass *script, LuaStackArgsClass &args, int index, T &value, const char *name)
+{
+	if (LuaArgTraits<T>::Get(script, args, index, value)) return true;
+	script->Script_Error("%s -- parameter %d is not a valid %s.", name, index + 1, LuaArgTraits<T>::Get_Type_Name());
+	return false;
+}
+
+/**
+ * Calls a bound member function pointer.  Specialized on the member
+ * function signature, with separate specializations for void returns.
+ */
+template <typename F>
+struct LuaBindCaller;
+
+template <typename T, typename R>
+struct LuaBindCaller<R (T::*)(LuaScriptClass *)>
+{
+	static void Call(LuaScriptClass *script, LuaStackArgsClass &args, T *object, R (T::*func)(LuaScriptClass *), const char *)
+	{
+		LuaReturnTraits<R>::Push(script, args, (object->*func)(script));
+	}
+};
+
+template <typename T>
+struct LuaBindCaller<void (T::*)(LuaScriptClass *)>
+{
+	static void Call(LuaScriptClass *script, LuaStackArgsClass &, T *object, void (T::*func)(LuaScriptClass *), const char *)
+	{
+		(object->*func)(script);
+	}
+};
+
+template <typename T, typename R, typename A1>
+struct LuaBindCaller<R (T::*)(LuaScriptClass *, A1)>
+{
+	static void Call(LuaScriptClass *script, LuaStackArgsClass &args, T *object, R (T::*func)(LuaScriptClass *, A1), const char *name)
+	{
+		typename LuaArgStorage<A1>::Type a1;
+		if (!Lua_Get_Bound_Arg(script, args, 0, a1, name)) return;
+		LuaReturnTraits<R>::Push(script, args, (object->*func)(script, a1));
+	}
+};
+
+template <typename T, typename A1>
+struct LuaBindCaller<void (T::*)(LuaScriptClass *, A1)>
+{
+	static void Call(LuaScriptClass *script, LuaStackArgsClass &args, T *object, void (T::*func)(LuaScriptClass *, A1), const char *name)
+	{
+		typename LuaArgStorage<A1>::Type a1;
+		if (!Lua_Get_Bound_Arg(script, args, 0, a1, name)) return;
+		(object->*func)(script, a1);
+	}
+};
+
+template <typename T, typename R, typename A1, typename A2>
+struct LuaBindCaller<R (T::*)(LuaScriptClass *, A1, A2)>
+{
+	static void Call(LuaScriptClass *script, LuaStackArgsClass &args, T *object, R (T::*func)(LuaScriptClass *, A1, A2), const char *name)
+	{
+		typename LuaArgStorage<A1>::Type a1;
+		typename LuaArgStorage<A2>::Type a2;
+		if (!Lua_Get_Bound_Arg(script, args, 0, a1, name)) return;
+		if (!Lua_Get_Bound_Arg(script, args, 1, a2, name)) return;
+		LuaReturnTraits<R>::Push(script, args, (object->*func)(script, a1, a2));
+	}
+};
+
+template <typename T, typename A1, typename A2>
+struct LuaBindCaller<void (T::*)(LuaScriptClass *, A1, A2)>
+{
+	static void Call(LuaScriptClass *script, LuaStackArgsClass &args, T *object, void (T::*func)(LuaScriptClass *, A1, A2), const char *name)
+	{
+		typename LuaArgStorage<A1>::Type a1;
+		typename LuaArgStorage<A2>::Type a2;
+		if (!Lua_Get_Bound_Arg(script, args, 0, a1, name)) return;
+		if (!Lua_Get_Bound_Arg(script, args, 1, a2, name)) return;
+		(object->*func)(script, a1, a2);
+	}
+};
+
+template <typename T, typename R, typename A1, typename A2, typename A3>
+struct LuaBindCaller<R (T::*)(LuaScriptClass *, A1, A2, A3)>
+{
+	static void Call(LuaScriptClass *script, LuaStackArgsClass &args, T *object, R (T::*func)(LuaScriptClass *, A1, A2, A3), const char *name)
+	{
+		typename LuaArgStorage<A1>::Type a1;
+		typename LuaArgStorage<A2>::Type a2;
+		typename LuaArgStorage<A3>::Type a3;
+		if (!Lua_Get_Bound_Arg(script, args, 0, a1, name)) return;
+		if (!Lua_Get_Bound_Arg(script, args, 1, a2, name)) return;
+		if (!Lua_Get_Bound_Arg(script, args, 2, a3, name)) return;
+		LuaReturnTraits<R>::Push(script, args, (object->*func)(script, a1, a2, a3));
+	}
+};
+
+template <typename T, typename A1, typename A2, typename A3>
+struct LuaBindCaller<void (T::*)(LuaScriptClass *, A1, A2, A3)>
+{
+	static void Call(LuaScriptClass *script, LuaStackArgsClass &args, T *object, void (T::*func)(LuaScriptClass *, A1, A2, A3), const char *name)
+	{
+		typename LuaArgStorage<A1>::Type a1;
+		typename LuaArgStorage<A2>::Type a2;
+		typename LuaArgStorage<A3>::Type a3;
+		if (!Lua_Get_Bound_Arg(script, args, 0, a1, name)) return;
+		if (!Lua_Get_Bound_Arg(script, args, 1, a2, name)) return;
+		if (!Lua_Get_Bound_Arg(script, args, 2, a3, name)) return;
+		(object->*func)(script, a1, a2, a3);
+	}
+};
+
+template <typename T, typename R, typename A1, typename A2, typename A3, typename A4>
+struct LuaBindCaller<R (T::*)(LuaScriptClass *, A1, A2, A3, A4)>
+{
+	static void Call(LuaScriptClass *script, LuaStackArgsClass &args, T *object, R (T::*func)(LuaScriptClass *, A1, A2, A3, A4), const char *name)
+	{
+		typename LuaArgStorage<A1>::Type a1;
+		typename LuaArgStorage<A2>::Type a2;
+		typename LuaArgStorage<A3>::Type a3;
+		typename LuaArgStorage<A4>::Type a4;
+		if (!Lua_Get_Bound_Arg(script, args, 0, a1, name)) return;
+		if (!Lua_Get_Bound_Arg(script, args, 1, a2, name)) return;
+		if (!Lua_Get_Bound_Arg(script, args, 2, a3, name)) return;
+		if (!Lua_Get_Bound_Arg(script, args, 3, a4, name)) return;
+		LuaReturnTraits<R>::Push(script, args, (object->*func)(script, a1, a2, a3, a4));
+	}
+};
+
+template <typename T, typename A1, typename A2, typename A3, typename A4>
+struct LuaBindCaller<void (T::*)(LuaScriptClass *, A1, A2, A3, A4)>
+{
+	static void Call(LuaScriptClass *script, LuaStackArgsClass &args, T *object, void (T::*func)(LuaScriptClass *, A1, A2, A3, A4), const char *name)
+	{
+		typename LuaArgStorage<A1>::Type a1;
+		typename LuaArgStorage<A2>::Type a2;
+		typename LuaArgStorage<A3>::Type a3;
+		typename LuaArgStorage<A4>::Type a4;
+		if (!Lua_Get_Bound_Arg(script, args, 0, a1, name)) return;
+		if (!Lua_Get_Bound_Arg(script, args, 1, a2, name)) return;
+		if (!Lua_Get_Bound_Arg(script, args, 2, a3, name)) return;
+		if (!Lua_Get_Bound_Arg(script, args, 3, a4, name)) return;
+		(object->*func)(script, a1, a2, a3, a4);
+	}
+};
+
+/**
+ * Call a typed member function with arguments taken off the stack.
+ * @see LUA_BIND_FUNCTION_CALL
+ */
+template <typename T, typename F>
+inline void Lua_Call_Bound(LuaScriptClass *script, LuaStackArgsClass &args, T *object, F func, const char *name)
+{
+	LuaBindCaller<F>::Call(script, args, object, func, name);
+}
+
+/**
+ * Wrapper object for a typed member function bound to one object.
+ */
+template <typename T, typename F>
+class LuaBoundMemberWrapper : public LuaUserVar
+{
+public:
+	LuaBoundMemberWrapper(T *obj, F func, const char *name) :
+			LuaUserVar(LUA_CHUNK_INVALID, false), Function(func), Object(obj), Name(name) {}
+
+	virtual bool Has_Stack_Function_Call(void) const { return true; }
+
+	virtual void Stack_Function_Call(LuaScriptClass *script, LuaStackArgsClass &args)
+	{
+		assert(Object);
+		assert(Function);
+		LuaBindCaller<F>::Call(script, args, Object, Function, Name);
+	}
+
+private:
+	F							Function;
+	T *						Object;
+	const char *			Name;
+};
+
+/**
+ * Descriptor for a typed member function.
+ */
+template <typename T, typename F>
+class LuaBoundMemberDescriptor : public LuaMemberDescriptorClass
+{
+public:
+	LuaBoundMemberDescriptor(F func, const char *name) :
+			LuaMemberDescriptorClass(false), Function(func), Name(name) {}
+
+	virtual LuaUserVar *Bind(LuaUserVar *object) const
+	{
+		assert(object);
+		return new LuaBoundMemberWrapper<T, F>(static_cast<T *>(object), Function, Name);
+	}
+
+private:
+	F							Function;
+	const char *			Name;
+};
+
+/**
+ * Create the member descriptor for a typed member function.  The class is
+ * given explicitly and the rest of the signature is deduced.
+ *
+ * @param func   member function
+ * @param name   name used in script errors, must be a string literal
+ *
+ * @return new member descriptor.
+ * @see LUA_BIND
+ */
+template <typename T, typename F>
+inline LuaMemberDescriptorClass *Lua_Bind_Member(F func, const char *name)
+{
+	return new LuaBoundMemberDescriptor<T, F>(func, name);
+}
+
+#endif // __LUA_BINDING_H__
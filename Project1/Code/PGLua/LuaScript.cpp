@@ -52,9 +52,11 @@
 #include "UtilityCommands.h"
 #include "../SecuROM/securom_api.h"
 #include <algorithm>
+#include <stdio.h>
 #include "LuaNetworkDebugger.h"
 #include "LuaScriptWrapper.h"
 #include "LuaExternalFunction.h"
+#include "BlockingStatus.h"
 
 extern "C"
 {
@@ -67,6 +69,12 @@ std::vector<std::string>	LuaScriptClass::ScriptPaths;
 std::string						LuaScriptClass::ScriptPathString("./?.lua;./?.lc");
 int								LuaScriptClass::NextScriptID = 1;
 LuaScriptClass::ScriptPoolListType			LuaScriptClass::ScriptPool;
+LuaScriptClass::ChunkCacheType				LuaScriptClass::ChunkCache;
+LuaScriptClass::ScriptPoolHistoryType		LuaScriptClass::ScriptPoolHistory;
+double											LuaScriptClass::ScriptPoolStatsStart = 0.0;
+bool												LuaScriptClass::ScriptPoolsPreloaded = false;
+std::vector<std::string>					LuaScriptClass::ScriptPoolTopUpList;
+bool												LuaScriptClass::ChunkCacheEnabled = true;
 LuaScriptClass::ActiveScriptListType		LuaScriptClass::ActiveScriptList;
 
 LuaScriptClass::LogCallbackType						LuaScriptClass::LogMessageCallback = NULL;
@@ -78,6 +86,7 @@ LuaScriptClass::FileRegistrationCallbackType		LuaScriptClass::UnregisterScriptCa
 bool LuaScriptClass::ResetPerformed = false;
 
 PG_IMPLEMENT_RTTI(LuaScriptClass, LuaUserVar);
+LUA_IMPLEMENT_MEMBER_TABLE(LuaScriptClass, LuaUserVar);
 
 /**
  * Lua Error Handler
@@ -414,6 +423,7 @@ void LuaScriptClass::Add_Script_Path(const char *path)
  */
 void LuaScriptClass::Service(void)
 {
+	Reset_Lua_Temporary_Arena();
 	Manage_Lua_Tables();
 }
 
@@ -536,14 +546,19 @@ LuaScriptClass::LuaScriptClass(const std::string &script) :
 ,	SaveID(0)
 ,	ScriptID(NextScriptID++)
 ,	DebugTarget(0)
+,	NextPumpThread(0)
+,	ThreadResumeBudget(0)
+,	RunnableThreadsDirty(true)
+,	RunnableThreadsSize(0)
+,	NextParkSerial(0)
+,	PumpResumes(0)
+,	PumpTime(0.0)
 ,	ScriptShouldReload(false)
 {
 	FAIL_IF(!Init_State()) return;
 
 	Load_From_File(script);
 
-	LUA_REGISTER_MEMBER_FUNCTION(LuaScriptClass, "Debug_Should_Issue_Event_Alert", &LuaScriptClass::Debug_Should_Issue_Event_Alert);
-
 	UtilityCommandsClass::Register_Commands(this);
 }
 
@@ -565,15 +580,25 @@ LuaScriptClass::LuaScriptClass() :
 ,	SaveID(0)
 ,	ScriptID(NextScriptID++)
 ,	DebugTarget(0)
+,	NextPumpThread(0)
+,	ThreadResumeBudget(0)
+,	RunnableThreadsDirty(true)
+,	RunnableThreadsSize(0)
+,	NextParkSerial(0)
+,	PumpResumes(0)
+,	PumpTime(0.0)
 ,	ScriptShouldReload(false)
 {
 	FAIL_IF(!Init_State()) return;
 
-	LUA_REGISTER_MEMBER_FUNCTION(LuaScriptClass, "Debug_Should_Issue_Event_Alert", &LuaScriptClass::Debug_Should_Issue_Event_Alert);
-
 	UtilityCommandsClass::Register_Commands(this);
 }
 
+void LuaScriptClass::Register_Members(LuaMemberTableClass *table)
+{
+	LUA_REGISTER_MEMBER_FUNCTION(LuaScriptClass, "Debug_Should_Issue_Event_Alert", &LuaScriptClass::Debug_Should_Issue_Event_Alert);
+}
+
 /**
  * Destructor
  * @since 4/23/2005 5:37:31 PM -- BMH
@@ -600,6 +625,38 @@ void LuaScriptClass::Set_Name_From_Filename(const std::string &filename)
 	Name = Strip_Path_And_Extension(filename.c_str());
 }
 
+/**
+ * File object handed to lua by the file handler.  Lua sources are read
+ * up front into Buffer, which may then hold their compiled chunk instead,
+ * any other file is read straight from File.
+ */
+struct LuaFileStruct
+{
+	LuaFileStruct(FileClass *file) : File(file), Position(0) {}
+	FileClass								*File;
+	std::vector<char>						Buffer;
+	size_t									Position;
+};
+
+/**
+ * lua_dump writer that appends the chunk to a buffer.
+ * 
+ * @param p      data to write
+ * @param sz     size of the data
+ * @param ud     std::vector<char> to append to
+ * 
+ * @return 0
+ */
+static int Lua_Write_Chunk(lua_State * /*L*/, const void *p, size_t sz, void *ud)
+{
+	std::vector<char> *chunk = (std::vector<char> *)ud;
+	if (p && sz)
+	{
+		chunk->insert(chunk->end(), (const char *)p, (const char *)p + sz);
+	}
+	return 0;
+}
+
 /**
  * Function to override the internal lua file handler.  This allows
  * us to intercept the lua file management calls and remap file 
@@ -654,7 +711,6 @@ LuaScriptClass *LuaScriptClass::Get_Script_From_State(lua_State *state)
 void *LuaScriptClass::Internal_Open_File(lua_filehandler_t *handler, const char *name, const char *mode)
 {
 	mode;
-	handler;
 	FAIL_IF(!name) return NULL;
 
 	FileClass *newfile = new FileClass();
@@ -663,7 +719,83 @@ void *LuaScriptClass::Internal_Open_File(lua_filehandler_t *handler, const char
 		delete newfile;
 		return NULL;
 	}
-	return newfile;
+
+	LuaFileStruct *lfile = new LuaFileStruct(newfile);
+	size_t len = strlen(name);
+	if (ChunkCacheEnabled && len > 4 && _stricmp(name + len - 4, ".lua") == 0)
+	{
+		// Read the whole source so it can be replaced with the compiled chunk.
+		char buff[4096];
+		unsigned int rcnt;
+		while ((rcnt = newfile->Read(buff, sizeof(buff))) != FILE_READ_ERROR && rcnt != 0)
+		{
+			lfile->Buffer.insert(lfile->Buffer.end(), buff, buff + rcnt);
+		}
+		newfile->Close();
+		delete newfile;
+		lfile->File = NULL;
+
+		Load_Cached_Chunk(handler->L, name, lfile->Buffer);
+	}
+	return lfile;
+}
+
+/**
+ * Swap the source of a lua file for its compiled chunk.  The chunk is
+ * looked up by file name and source CRC, so an edited file never uses a
+ * stale chunk.  On a miss the source is compiled and dumped into the
+ * cache.  Sources that fail to compile are left alone so lua reports the
+ * error as usual.
+ * 
+ * @param L      lua state the file is being loaded into
+ * @param name   name of the file
+ * @param buffer file contents, replaced with the compiled chunk on success
+ * 
+ * @return true if buffer now holds a compiled chunk.
+ */
+bool LuaScriptClass::Load_Cached_Chunk(lua_State *L, const char *name, std::vector<char> &buffer)
+{
+	if (buffer.empty() || buffer[0] == LUA_SIGNATURE[0]) return false;
+
+	CRCValue crc = CRCClass::Calculate_CRC(&buffer[0], buffer.size());
+	std::string key = Build_Uppercase_String(name);
+	ChunkCacheType::iterator it = ChunkCache.find(key);
+	if (it != ChunkCache.end() && it->second.SourceCRC == crc)
+	{
+		buffer = it->second.Chunk;
+		return true;
+	}
+
+	// Match the chunk name luaL_loadfile would use so debug info is unchanged.
+	std::string chunk_name = std::string("@") + name;
+	if (luaL_loadbuffer(L, &buffer[0], buffer.size(), chunk_name.c_str()) != 0)
+	{
+		lua_pop(L, 1);
+		return false;
+	}
+
+	LuaChunkCacheStruct &entry = ChunkCache[key];
+	entry.SourceCRC = crc;
+	entry.Chunk.resize(0);
+	lua_dump(L, Lua_Write_Chunk, &entry.Chunk);
+	lua_pop(L, 1);
+	if (entry.Chunk.empty())
+	{
+		ChunkCache.erase(key);
+		return false;
+	}
+
+	buffer = entry.Chunk;
+	return true;
+}
+
+/**
+ * Drop all compiled chunks.  The next load of every script compiles its
+ * source again.
+ */
+void LuaScriptClass::Flush_Chunk_Cache(void)
+{
+	ChunkCache.clear();
 }
 
 /**
@@ -678,9 +810,13 @@ void *LuaScriptClass::Internal_Open_File(lua_filehandler_t *handler, const char
 int LuaScriptClass::Internal_Close_File(lua_filehandler_t *handler, void *file)
 {
 	handler;
-	FileClass *newfile = (FileClass *)file;
-	bool retval = newfile->Close();
-	delete newfile;
+	LuaFileStruct *lfile = (LuaFileStruct *)file;
+	bool retval = true;
+	if (lfile->File)
+	{
+		retval = lfile->File->Close();
+	}
+	delete lfile;
 	if (retval) return 0;
 	return EOF;
 }
@@ -697,7 +833,20 @@ int LuaScriptClass::Internal_Close_File(lua_filehandler_t *handler, void *file)
  */
 const char *LuaScriptClass::Internal_Read_File(lua_filehandler_t *handler, void *file, size_t *size)
 {
-	FileClass *newfile = (FileClass *)file;
+	LuaFileStruct *lfile = (LuaFileStruct *)file;
+	if (!lfile->File)
+	{
+		if (lfile->Position >= lfile->Buffer.size())
+		{
+			return NULL;
+		}
+		*size = lfile->Buffer.size() - lfile->Position;
+		const char *data = &lfile->Buffer[lfile->Position];
+		lfile->Position = lfile->Buffer.size();
+		return data;
+	}
+
+	FileClass *newfile = lfile->File;
 	LuaScriptClass *script = (LuaScriptClass *)handler->ud;
 	unsigned int rcnt = newfile->Read(&script->HandlerBuff, sizeof(script->HandlerBuff));
 	if (rcnt == FILE_READ_ERROR || rcnt == 0)
@@ -721,7 +870,17 @@ const char *LuaScriptClass::Internal_Read_File(lua_filehandler_t *handler, void
 char LuaScriptClass::Internal_Peek_Char(lua_filehandler_t *handler, void *file)
 {
 	handler;
-	FileClass *newfile = (FileClass *)file;
+	LuaFileStruct *lfile = (LuaFileStruct *)file;
+	if (!lfile->File)
+	{
+		if (lfile->Position >= lfile->Buffer.size())
+		{
+			return 0;
+		}
+		return lfile->Buffer[lfile->Position];
+	}
+
+	FileClass *newfile = lfile->File;
 	char cval = 0;
 	unsigned int rcnt = newfile->Read(&cval, 1);
 	if (rcnt != FILE_READ_ERROR)
@@ -1017,6 +1176,11 @@ bool LuaScriptClass::Load_State(ChunkReaderClass *reader)
 	{
 		ScriptShouldCRC = should_crc->Value;
 	}
+	LuaNumber::Pointer resume_budget = LUA_SAFE_CAST(LuaNumber, Map_Global_From_Lua("ThreadResumeBudget"));
+	if (resume_budget)
+	{
+		ThreadResumeBudget = resume_budget->Value > 0.0f ? (int)resume_budget->Value : 0;
+	}
 
 	if (LuaDebugCallbacks) LuaDebugCallbacks->Script_Added(this);
 
@@ -1088,6 +1252,11 @@ void LuaScriptClass::Shutdown(void)
 
 	ExitFlag = true;
 	ThreadData.resize(0);
+	WokenThreads.resize(0);
+	PolledThreads.resize(0);
+	TimedThreads.resize(0);
+	RunnableThreads.resize(0);
+	RunnableThreadsDirty = true;
 
 	// Clear the thread table.
 	static const char lua_threadtable[] = "LuaThreadTable";
@@ -1116,6 +1285,7 @@ void LuaScriptClass::Shutdown(void)
 		Set_Thread_Event_Handler(NULL);
 		if (State) lua_close(State);
 		State = NULL;
+		LuaMemberTableReg::Flush_Interned_Symbols();
 
 		ActiveScriptListType::iterator it = ActiveScriptList.find(ScriptID);
 		if (it != ActiveScriptList.end())
@@ -1309,9 +1479,223 @@ void LuaScriptClass::Register_Thread(void)
 	lua_pop(State, 2);
 }
 
+/**
+ * Time stamp for the thread and pool statistics.  Only ever reported, never
+ * used to decide what runs, since wall time differs from machine to machine.
+ * 
+ * @return time in milliseconds
+ */
+static double Get_Thread_Time_Stamp(void)
+{
+	return (double)TIMEGETTIME();
+}
+
+/**
+ * Park a thread on the BlockingStatus it yielded.  A status that signals
+ * its completion is checked once here, then remembers the thread and wakes
+ * it through Wake_Parked_Thread, so the thread isn't looked at again until
+ * then.  Others go on the polled list.  A thread with a wait timeout also
+ * goes on the timed list.
+ * 
+ * @param id     thread to park
+ * @param block  status the thread yielded
+ */
+void LuaScriptClass::Park_Thread(int id, BlockingStatus *block)
+{
+	assert(block);
+	if (block->Signals_Completion() && block->Poll_Finished(this))
+	{
+		return;
+	}
+
+	ParkedThreadStruct parked;
+	parked.ThreadID = id;
+	parked.ParkSerial = ++NextParkSerial;
+
+	ThreadData[id].Parked_On = block;
+	ThreadData[id].Park_Timeout = block->Get_Wait_Timeout();
+	ThreadData[id].Park_Serial = parked.ParkSerial;
+	RunnableThreadsDirty = true;
+
+	if (block->Signals_Completion())
+	{
+		block->Add_Waiting_Thread(ScriptID, id, parked.ParkSerial);
+	}
+	else
+	{
+		PolledThreads.push_back(parked);
+	}
+
+	if (ThreadData[id].Park_Timeout > 0)
+	{
+		TimedThreads.push_back(parked);
+	}
+}
+
+/**
+ * Make a parked thread runnable again.
+ * 
+ * @param id     thread to unpark
+ */
+void LuaScriptClass::Unpark_Thread(int id)
+{
+	ThreadData[id].Parked_On = NULL;
+	ThreadData[id].Park_Timeout = 0;
+	ThreadData[id].Park_Serial = 0;
+	RunnableThreadsDirty = true;
+}
+
+/**
+ * Whether a parked list entry still refers to the same parking of a live
+ * thread.  Entries aren't removed when a thread is unparked some other way
+ * or killed, they're dropped the next time the list is walked.
+ */
+bool LuaScriptClass::Is_Park_Current(const ParkedThreadStruct &parked) const
+{
+	return parked.ThreadID < (int)ThreadData.size() &&
+			 ThreadData[parked.ThreadID].Thread != NULL &&
+			 ThreadData[parked.ThreadID].Park_Serial == parked.ParkSerial;
+}
+
+/**
+ * Called by a BlockingStatus when it signals completion to wake a thread
+ * parked on it.  The thread is resumed the next time its script pumps.
+ * 
+ * @param script_id   script the thread belongs to
+ * @param id          thread parked on the status
+ * @param park_serial serial of the parking, so a thread that has since
+ *                    been unparked or replaced isn't woken.
+ */
+void LuaScriptClass::Wake_Parked_Thread(int script_id, int id, int park_serial)
+{
+	ActiveScriptListType::iterator it = ActiveScriptList.find(script_id);
+	if (it == ActiveScriptList.end()) return;
+
+	ParkedThreadStruct parked;
+	parked.ThreadID = id;
+	parked.ParkSerial = park_serial;
+	if (it->second->Is_Park_Current(parked))
+	{
+		it->second->WokenThreads.push_back(parked);
+	}
+}
+
+/**
+ * Wake parked threads whose status has finished or whose wait timeout has
+ * run out.  Only threads woken by a signal and those on the polled and
+ * timed lists are looked at.  Every timed thread counts down every pump.
+ */
+void LuaScriptClass::Wake_Parked_Threads(void)
+{
+	for (int i = 0; i < (int)WokenThreads.size(); i++)
+	{
+		if (Is_Park_Current(WokenThreads[i]))
+		{
+			Unpark_Thread(WokenThreads[i].ThreadID);
+		}
+	}
+	WokenThreads.resize(0);
+
+	int kept = 0;
+	for (int i = 0; i < (int)PolledThreads.size(); i++)
+	{
+		ParkedThreadStruct parked = PolledThreads[i];
+		if (!Is_Park_Current(parked)) continue;
+
+		BlockingStatus *block = PG_Dynamic_Cast<BlockingStatus>(ThreadData[parked.ThreadID].Parked_On);
+		Set_Current_Thread(ThreadData[parked.ThreadID].Thread);
+		bool finished = !block || block->Poll_Finished(this);
+		Set_Current_Thread(State);
+		if (finished)
+		{
+			Unpark_Thread(parked.ThreadID);
+			continue;
+		}
+		PolledThreads[kept++] = parked;
+	}
+	PolledThreads.resize(kept);
+
+	kept = 0;
+	for (int i = 0; i < (int)TimedThreads.size(); i++)
+	{
+		ParkedThreadStruct parked = TimedThreads[i];
+		if (!Is_Park_Current(parked)) continue;
+
+		if (--ThreadData[parked.ThreadID].Park_Timeout <= 0)
+		{
+			Unpark_Thread(parked.ThreadID);
+			continue;
+		}
+		TimedThreads[kept++] = parked;
+	}
+	TimedThreads.resize(kept);
+}
+
+/**
+ * Resume one thread until it exits or yields, and park it if it yielded
+ * a BlockingStatus.
+ * 
+ * @param i      thread to resume
+ */
+void LuaScriptClass::Resume_Thread(int i)
+{
+	double start_time = Get_Thread_Time_Stamp();
+	Map_Var_To_Lua(ThreadData[i].Thread, ThreadData[i].Thread_Function);
+	int nargs = 0;
+	if (ThreadData[i].Thread_Param)
+	{
+		nargs = 1;
+		Map_Var_To_Lua(ThreadData[i].Thread, ThreadData[i].Thread_Param);
+		ThreadData[i].Thread_Param = NULL;
+	}
+	int res = lua_presume(ThreadData[i].Thread, nargs, ThreadData[i].Thread_Alert_ID);
+	double elapsed = Get_Thread_Time_Stamp() - start_time;
+	PumpTime += elapsed;
+	PumpResumes++;
+	if (res) {
+		Lua_Alert_Handler(ThreadData[i].Thread);
+		Unregister_Thread(ThreadData[i].Thread);
+		ThreadData[i] = LuaThreadStruct();
+		return;
+	}
+	ThreadData[i].Total_Time += (float)elapsed;
+	ThreadData[i].Resume_Count++;
+
+	SmartPtr<LuaVar> var = Map_Var_From_Lua(ThreadData[i].Thread);
+	SmartPtr<BlockingStatus> block = PG_Dynamic_Cast<BlockingStatus>(var);
+	SmartPtr<LuaBool> bval = PG_Dynamic_Cast<LuaBool>(var);
+	if (block)
+	{
+		Park_Thread(i, block);
+	}
+	else if (!bval || !bval->Value)
+	{
+		Unregister_Thread(ThreadData[i].Thread);
+		ThreadData[i] = LuaThreadStruct();
+	} 
+}
+
 /**
  * Execute each Lua thread in turn until each thread either exits
  * or yields.
+ * 
+ * A thread that yields a BlockingStatus instead of true is parked and
+ * not resumed again until the BlockingStatus reports it is finished.
+ * Parking is only a hint, scripts should still check IsFinished after
+ * the yield since parking is not saved.  Statuses that signal their
+ * completion wake the thread themselves and parked threads on them are
+ * never looked at, any others are polled through Poll_Finished each pump.
+ * A wait timeout set on the status resumes the thread after that many
+ * pumps even if it has not finished.  Every timed thread counts down
+ * every pump, so timeouts don't depend on how many threads got to run.
+ * 
+ * Only runnable threads are walked.  The list of them is rebuilt when a
+ * thread parks, wakes or is added.
+ * 
+ * A script that sets the global ThreadResumeBudget resumes at most that
+ * many threads a pump.  The next pump starts at the first thread that was
+ * skipped.  The budget counts resumes rather than time so every machine
+ * in a multiplayer game runs the same threads on the same frame.
  * @since 4/22/2004 2:46:25 PM -- BMH
  */
 void LuaScriptClass::Pump_Threads(void)
@@ -1320,33 +1704,65 @@ void LuaScriptClass::Pump_Threads(void)
 		Shutdown();
 		return;
 	}
-	for (int i = 0; i < (int)ThreadData.size(); i++) {
-		if (ThreadData[i].Thread == NULL)
+
+	Wake_Parked_Threads();
+
+	if (RunnableThreadsDirty || RunnableThreadsSize != (int)ThreadData.size())
+	{
+		RunnableThreads.resize(0);
+		for (int i = 0; i < (int)ThreadData.size(); i++) {
+			if (ThreadData[i].Thread && !ThreadData[i].Parked_On)
+				RunnableThreads.push_back(i);
+		}
+		RunnableThreadsSize = (int)ThreadData.size();
+		RunnableThreadsDirty = false;
+	}
+
+	int start = 0;
+	if (ThreadResumeBudget > 0)
+	{
+		start = (int)(std::lower_bound(RunnableThreads.begin(), RunnableThreads.end(), NextPumpThread) - RunnableThreads.begin());
+		if (start >= (int)RunnableThreads.size()) start = 0;
+	}
+	NextPumpThread = 0;
+
+	// Threads the pump creates are resumed this pump too, as long as no
+	// budget cut it short.
+	int thread_count = (int)ThreadData.size();
+	int runnable_count = (int)RunnableThreads.size();
+	int resumes = 0;
+	bool budget_spent = false;
+	for (int n = 0; n < runnable_count; n++) {
+		int i = RunnableThreads[(start + n) % runnable_count];
+		if (i >= (int)ThreadData.size() || ThreadData[i].Thread == NULL || ThreadData[i].Parked_On)
 			continue;
-		Map_Var_To_Lua(ThreadData[i].Thread, ThreadData[i].Thread_Function);
-		int nargs = 0;
-		if (ThreadData[i].Thread_Param)
+
+		if (ThreadResumeBudget > 0 && resumes >= ThreadResumeBudget)
 		{
-			nargs = 1;
-			Map_Var_To_Lua(ThreadData[i].Thread, ThreadData[i].Thread_Param);
-			ThreadData[i].Thread_Param = NULL;
+			NextPumpThread = i;
+			budget_spent = true;
+			break;
 		}
-		int res = lua_presume(ThreadData[i].Thread, nargs, ThreadData[i].Thread_Alert_ID);
-		if (res) {
-			Lua_Alert_Handler(ThreadData[i].Thread);
-			Unregister_Thread(ThreadData[i].Thread);
-			ThreadData[i] = LuaThreadStruct();
+		resumes++;
+
+		Resume_Thread(i);
+		if (ExitFlag) break;
+	}
+
+	for (int i = thread_count; !budget_spent && !ExitFlag && i < (int)ThreadData.size(); i++) {
+		if (ThreadData[i].Thread == NULL || ThreadData[i].Parked_On)
 			continue;
-		}
-		SmartPtr<LuaVar> var = Map_Var_From_Lua(ThreadData[i].Thread);
-		SmartPtr<LuaBool> bval = PG_Dynamic_Cast<LuaBool>(var);
-		if (!bval || !bval->Value)
+
+		if (ThreadResumeBudget > 0 && resumes >= ThreadResumeBudget)
 		{
-			Unregister_Thread(ThreadData[i].Thread);
-			ThreadData[i] = LuaThreadStruct();
-		} 
-		if (ExitFlag) break;
+			NextPumpThread = i;
+			break;
+		}
+		resumes++;
+
+		Resume_Thread(i);
 	}
+
 	if (ExitFlag) {
 		Shutdown();
 		return;
@@ -1374,6 +1790,8 @@ CRCValue LuaScriptClass::Calculate_CRC(CRCValue seed)
 void LuaScriptClass::System_Initialize(void)
 {
 	Init_Lua_Table_Pool();
+	LuaMemberTableReg::Build_Member_Tables();
+	Reset_Script_Pool_Stats();
 	ActiveScriptListType::iterator it = ActiveScriptList.begin();
 	while (it != ActiveScriptList.end())
 	{
@@ -1396,6 +1814,8 @@ void LuaScriptClass::System_Shutdown(void)
 {
 	Free_Script_Pool();
 	Shutdown_Lua_Table_Pool();
+	Shutdown_Lua_Temporary_Arena();
+	Flush_Chunk_Cache();
 	ActiveScriptListType::iterator it = ActiveScriptList.begin();
 	while (it != ActiveScriptList.end())
 	{
@@ -1407,6 +1827,7 @@ void LuaScriptClass::System_Shutdown(void)
 
 	LuaExternalFunction::Shutdown_Wrapper_Cache();
 	LuaScriptWrapper::Shutdown_Wrapper_Cache();
+	LuaMemberTableReg::Free_Member_Tables();
 }
 
 /**
@@ -1440,6 +1861,8 @@ void LuaScriptClass::Free_Script_Pool(void)
 		}
 	}
 	ScriptPool.clear();
+	ScriptPoolTopUpList.clear();
+	ScriptPoolsPreloaded = false;
 }
 
 /**
@@ -1449,7 +1872,7 @@ void LuaScriptClass::Free_Script_Pool(void)
 void LuaScriptClass::Dump_Lua_Script_Pool_Counts(void)
 {
 	Debug_Print("LuaScriptClass::Dump_Lua_Script_Pool_Counts\n");
-	Debug_Print("%50s%8s%8s%8s%8s%8s\n", "ScriptName", "InUse", "Total", "Threads", "CRCCnt", "CRCMiss");
+	Debug_Print("%50s%8s%8s%8s%8s%8s%8s\n", "ScriptName", "InUse", "Total", "Peak", "Threads", "CRCCnt", "CRCMiss");
 
 	ScriptPoolListType::iterator it = ScriptPool.begin();
 	for (; it != ScriptPool.end(); it++)
@@ -1476,7 +1899,194 @@ void LuaScriptClass::Dump_Lua_Script_Pool_Counts(void)
 			pcount++;
 			pthread_count += script->Get_Thread_Count();
 		}
-		Debug_Print("%50s%8d%8d%8d%8d%8d\n", it->first.c_str(), pinuse, pcount, pthread_count, ccnt, cmiss);
+		Debug_Print("%50s%8d%8d%8d%8d%8d%8d\n", it->first.c_str(), pinuse, pcount, ScriptPoolHistory[it->first].Peak, pthread_count, ccnt, cmiss);
+	}
+
+	// Peaks in the format of the ScriptPoolManifest data script.
+	Debug_Print("ScriptPoolManifest = {\n");
+	ScriptPoolHistoryType::iterator peak = ScriptPoolHistory.begin();
+	for (; peak != ScriptPoolHistory.end(); peak++)
+	{
+		Debug_Print("\t[\"%s\"] = %d,\n", peak->first.c_str(), peak->second.Peak);
+	}
+	Debug_Print("}\n");
+}
+
+/**
+ * Print the lua table pool and temporary arena counts.  Misses and escapes
+ * are allocations the pools could not absorb.
+ */
+void LuaScriptClass::Dump_Lua_Value_Pool_Stats(void)
+{
+	LuaValuePoolStatsStruct stats;
+	Get_Lua_Value_Pool_Stats(stats);
+
+	Debug_Print("LuaScriptClass::Dump_Lua_Value_Pool_Stats\n");
+	Debug_Print("%20s%8s%8s%8s%8s%10s%8s%10s\n", "Pool", "Size", "Min", "Max", "Growths", "Allocs", "Misses", "FrameMiss");
+	Debug_Print("%20s%8d%8d%8d%8d%10d%8d%10d\n", "LuaTable", stats.TablePoolSize, stats.TablePoolMin, stats.TablePoolMax,
+		stats.TablePoolGrowths, stats.TableAllocs, stats.TableMisses, stats.FrameTableMisses);
+	Debug_Print("%20s%8s%10s%10s%10s%10s%10s\n", "Arena", "Free", "Allocs", "Reuses", "Escapes", "Frame", "Peak");
+	Debug_Print("%20s%8d%10d%10d%10d%10d%10d\n", "Temporaries", stats.TemporaryFreeCount, stats.TemporaryAllocs,
+		stats.TemporaryReuses, stats.TemporaryEscapes, stats.FrameTemporaryAllocs, stats.PeakFrameTemporaries);
+}
+
+/**
+ * Collect the counters of every script pool.  Rates are over the time
+ * since the last Reset_Script_Pool_Stats.
+ * 
+ * @param stats  filled with one entry per pool
+ */
+void LuaScriptClass::Get_Script_Pool_Stats(std::vector<LuaScriptPoolStatsStruct> &stats)
+{
+	stats.resize(0);
+	float seconds = (float)((Get_Thread_Time_Stamp() - ScriptPoolStatsStart) / 1000.0);
+
+	ScriptPoolListType::iterator it = ScriptPool.begin();
+	for (; it != ScriptPool.end(); it++)
+	{
+		const ScriptPoolHistoryStruct &history = ScriptPoolHistory[it->first];
+
+		LuaScriptPoolStatsStruct entry;
+		entry.Name = it->first;
+		entry.InUse = 0;
+		entry.Total = 0;
+		entry.Peak = history.Peak;
+		entry.Misses = history.Misses;
+		entry.Loads = history.Loads;
+		entry.LoadTime = history.Loads ? (float)(history.LoadTime / history.Loads) : 0.0f;
+		entry.HeapBytes = 0;
+		entry.Threads = 0;
+		entry.Resumes = 0;
+		entry.PumpTime = 0.0f;
+
+		PoolListType::iterator pit = it->second.begin();
+		for (; pit != it->second.end(); pit++)
+		{
+			LuaScriptClass *script = *pit;
+			if (script->PoolInUse) entry.InUse++;
+			entry.Total++;
+			if (script->State) entry.HeapBytes += lua_getgcount(script->State) * 1024;
+			entry.Threads += script->Get_Thread_Count();
+			entry.Resumes += script->PumpResumes;
+			entry.PumpTime += (float)script->PumpTime;
+		}
+		entry.ResumesPerSecond = seconds > 0.0f ? entry.Resumes / seconds : 0.0f;
+
+		stats.push_back(entry);
+	}
+}
+
+/**
+ * Escape a string for use inside a JSON string literal.
+ * 
+ * @param value  string to escape
+ * @param out    receives the escaped string, without the quotes
+ */
+static void Escape_Json_String(const std::string &value, std::string &out)
+{
+	out.resize(0);
+	for (int i = 0; i < (int)value.size(); i++)
+	{
+		unsigned char c = (unsigned char)value[i];
+		switch (c)
+		{
+			case '"':	out += "\\\""; break;
+			case '\\':	out += "\\\\"; break;
+			case '\n':	out += "\\n"; break;
+			case '\r':	out += "\\r"; break;
+			case '\t':	out += "\\t"; break;
+			default:
+				if (c < 0x20)
+				{
+					char code[8];
+					sprintf(code, "\\u%4.4x", c);
+					out += code;
+				}
+				else
+				{
+					out += (char)c;
+				}
+				break;
+		}
+	}
+}
+
+/**
+ * Format the script pool counters as CSV or JSON.
+ * 
+ * @param out    receives the formatted text
+ * @param json   true for JSON, false for CSV
+ */
+void LuaScriptClass::Format_Script_Pool_Stats(std::string &out, bool json)
+{
+	std::vector<LuaScriptPoolStatsStruct> stats;
+	Get_Script_Pool_Stats(stats);
+
+	std::string line;
+	std::string name;
+	out = json ? "[\n" : "Name,InUse,Total,Peak,Misses,Loads,LoadTimeMs,HeapBytes,Threads,Resumes,ResumesPerSecond,PumpTimeMs\n";
+	for (int i = 0; i < (int)stats.size(); i++)
+	{
+		const LuaScriptPoolStatsStruct &entry = stats[i];
+		if (json)
+		{
+			Escape_Json_String(entry.Name, name);
+			String_Printf(line, "\t{\"Name\": \"%s\", \"InUse\": %d, \"Total\": %d, \"Peak\": %d, \"Misses\": %d, \"Loads\": %d, "
+				"\"LoadTimeMs\": %.3f, \"HeapBytes\": %d, \"Threads\": %d, \"Resumes\": %d, \"ResumesPerSecond\": %.3f, \"PumpTimeMs\": %.3f}%s\n",
+				name.c_str(), entry.InUse, entry.Total, entry.Peak, entry.Misses, entry.Loads, entry.LoadTime, entry.HeapBytes,
+				entry.Threads, entry.Resumes, entry.ResumesPerSecond, entry.PumpTime, i + 1 < (int)stats.size() ? "," : "");
+		}
+		else
+		{
+			String_Printf(line, "%s,%d,%d,%d,%d,%d,%.3f,%d,%d,%d,%.3f,%.3f\n",
+				entry.Name.c_str(), entry.InUse, entry.Total, entry.Peak, entry.Misses, entry.Loads, entry.LoadTime, entry.HeapBytes,
+				entry.Threads, entry.Resumes, entry.ResumesPerSecond, entry.PumpTime);
+		}
+		out += line;
+	}
+	if (json) out += "]\n";
+}
+
+/**
+ * Write the script pool counters to a file, typically at the end of a
+ * session.
+ * 
+ * @param filename file to write
+ * @param json     true for JSON, false for CSV
+ * 
+ * @return true if the file was written.
+ */
+bool LuaScriptClass::Export_Script_Pool_Stats(const char *filename, bool json)
+{
+	FAIL_IF(!filename) return false;
+
+	std::string out;
+	Format_Script_Pool_Stats(out, json);
+
+	FileClass file;
+	if (!file.Open(filename, FileClass::FILE_MODE_WRITE)) return false;
+	bool ok = file.Write(out.c_str(), out.size()) == out.size();
+	file.Close();
+	return ok;
+}
+
+/**
+ * Zero the script pool counters and restart the rate timer.
+ */
+void LuaScriptClass::Reset_Script_Pool_Stats(void)
+{
+	ScriptPoolHistory.clear();
+	ScriptPoolStatsStart = Get_Thread_Time_Stamp();
+
+	ScriptPoolListType::iterator it = ScriptPool.begin();
+	for (; it != ScriptPool.end(); it++)
+	{
+		PoolListType::iterator pit = it->second.begin();
+		for (; pit != it->second.end(); pit++)
+		{
+			(*pit)->PumpResumes = 0;
+			(*pit)->PumpTime = 0.0;
+		}
 	}
 }
 
@@ -1621,12 +2231,9 @@ SmartPtr<LuaScriptClass> LuaScriptClass::Create_Script(const std::string &name,
 		if (!script)
 		{
 			// All Pooled scripts are in use, allocate a new one.
-			script = new LuaScriptClass();
-			FAIL_IF(!script->Load_From_File(name))
-			{
-				script->Shutdown();
-				return NULL;
-			}
+			ScriptPoolHistory[name].Misses++;
+			script = Load_Pool_Script(name);
+			if (!script) return NULL;
 			it->second.push_back(script);
 			script->PoolFreshLoad = true;
 		}
@@ -1634,12 +2241,8 @@ SmartPtr<LuaScriptClass> LuaScriptClass::Create_Script(const std::string &name,
 	else
 	{
 		// first occurence of this script
-		script = new LuaScriptClass();
-		FAIL_IF(!script->Load_From_File(name))
-		{
-			script->Shutdown();
-			return NULL;
-		}
+		script = Load_Pool_Script(name);
+		if (!script) return NULL;
 
 		int pool_count = 0;
 		LuaNumber::Pointer poolnum = LUA_SAFE_CAST(LuaNumber, script->Map_Global_From_Lua("ScriptPoolCount"));
@@ -1659,16 +2262,9 @@ SmartPtr<LuaScriptClass> LuaScriptClass::Create_Script(const std::string &name,
 			// load up our initial pool count.
 			for (int i = 1; i < pool_count; i++)
 			{
-				SmartPtr<LuaScriptClass> new_script = new LuaScriptClass();
-				FAIL_IF(!new_script->Load_From_File(name))
-				{
-					new_script->Shutdown();
-					break;
-				}
-				retval.first->second.push_back(new_script);
-				new_script->PoolFreshLoad = true;
-				new_script->ScriptIsPooled = true;
+				if (!Grow_Script_Pool(name, retval.first->second)) break;
 			}
+			it = retval.first;
 		}
 	}
 
@@ -1677,9 +2273,204 @@ SmartPtr<LuaScriptClass> LuaScriptClass::Create_Script(const std::string &name,
 	script->ExitFlag = false;
 	script->CurrentThreadId = -1;
 
+	if (pool_script)
+	{
+		Note_Script_Pool_Use(name, it->second);
+	}
+
 	return script;
 }
 
+/**
+ * Load a new instance of a pooled script and record how long it took.
+ * 
+ * @param name   name of the script
+ * 
+ * @return the loaded script, NULL if it failed to load.
+ */
+SmartPtr<LuaScriptClass> LuaScriptClass::Load_Pool_Script(const std::string &name)
+{
+	double start_time = Get_Thread_Time_Stamp();
+	SmartPtr<LuaScriptClass> script = new LuaScriptClass();
+	FAIL_IF(!script->Load_From_File(name))
+	{
+		script->Shutdown();
+		return NULL;
+	}
+
+	ScriptPoolHistoryStruct &history = ScriptPoolHistory[name];
+	history.Loads++;
+	history.LoadTime += Get_Thread_Time_Stamp() - start_time;
+	return script;
+}
+
+/**
+ * Load one more unused instance of a script into its pool.
+ * 
+ * @param name   name of the script
+ * @param pool   pool list for the script
+ * 
+ * @return true if the instance loaded.
+ */
+bool LuaScriptClass::Grow_Script_Pool(const std::string &name, PoolListType &pool)
+{
+	SmartPtr<LuaScriptClass> new_script = Load_Pool_Script(name);
+	if (!new_script) return false;
+	pool.push_back(new_script);
+	new_script->PoolFreshLoad = true;
+	new_script->ScriptIsPooled = true;
+	return true;
+}
+
+/**
+ * Count the scripts of a pool that are handed out.
+ * 
+ * @param pool   pool list for the script
+ * 
+ * @return number of scripts in use
+ */
+int LuaScriptClass::Get_Script_Pool_In_Use_Count(const PoolListType &pool)
+{
+	int in_use = 0;
+	PoolListType::const_iterator pit = pool.begin();
+	for (; pit != pool.end(); pit++)
+	{
+		if ((*pit)->PoolInUse) in_use++;
+	}
+	return in_use;
+}
+
+/**
+ * Record how many scripts of a pool are in use after one was handed out.
+ * The peak is printed by Dump_Lua_Script_Pool_Counts for updating the
+ * ScriptPoolManifest data script.  A pool with nothing left free, either
+ * because the script isn't in the manifest or it's over its manifest count,
+ * is queued for Top_Up_Script_Pools.
+ * 
+ * @param name   name of the script
+ * @param pool   pool list for the script
+ */
+void LuaScriptClass::Note_Script_Pool_Use(const std::string &name, PoolListType &pool)
+{
+	int in_use = Get_Script_Pool_In_Use_Count(pool);
+	int &peak = ScriptPoolHistory[name].Peak;
+	peak = max(peak, in_use);
+
+	if (in_use == (int)pool.size() &&
+		 std::find(ScriptPoolTopUpList.begin(), ScriptPoolTopUpList.end(), name) == ScriptPoolTopUpList.end())
+	{
+		ScriptPoolTopUpList.push_back(name);
+	}
+}
+
+/**
+ * Load one spare script for the first pool that ran out, so the next
+ * Create_Script for it doesn't have to load one.  Pools are part of the sync
+ * CRC, so this is called from the game logic frame (StoryModeClass::Check_Plots)
+ * rather than Service, which keeps every machine growing the same pools on
+ * the same frame.
+ */
+void LuaScriptClass::Top_Up_Script_Pools(void)
+{
+	if (ScriptPoolTopUpList.empty()) return;
+
+	std::string name = ScriptPoolTopUpList.front();
+	ScriptPoolTopUpList.erase(ScriptPoolTopUpList.begin());
+
+	ScriptPoolListType::iterator it = ScriptPool.find(name);
+	if (it == ScriptPool.end()) return;
+	if (Get_Script_Pool_In_Use_Count(it->second) < (int)it->second.size()) return;
+
+	Grow_Script_Pool(name, it->second);
+}
+
+/**
+ * Load a script's pool up to count instances ahead of time.  A script that
+ * isn't loaded yet gets at least its ScriptPoolCount.  Scripts that set
+ * ScriptPoolCount to 0 aren't pooled and are left alone.  Pools are part
+ * of the sync CRC, so in multiplayer this has to be called the same way on
+ * every machine.
+ * 
+ * @param name   name of the script
+ * @param count  number of instances the pool should hold
+ */
+void LuaScriptClass::Preload_Script_Pool(const std::string &name, int count)
+{
+	ScriptPoolListType::iterator it = ScriptPool.find(name);
+	if (it == ScriptPool.end())
+	{
+		SmartPtr<LuaScriptClass> script = Load_Pool_Script(name);
+		if (!script) return;
+
+		LuaNumber::Pointer poolnum = LUA_SAFE_CAST(LuaNumber, script->Map_Global_From_Lua("ScriptPoolCount"));
+		if (poolnum)
+		{
+			if ((int)poolnum->Value == 0)
+			{
+				script->Shutdown();
+				return;
+			}
+			count = max(count, (int)poolnum->Value);
+		}
+
+		it = ScriptPool.insert(std::make_pair(name, PoolListType())).first;
+		it->second.push_back(script);
+		script->PoolFreshLoad = true;
+		script->ScriptIsPooled = true;
+	}
+
+	while ((int)it->second.size() < count)
+	{
+		if (!Grow_Script_Pool(name, it->second)) break;
+	}
+}
+
+/**
+ * Preload the script pools listed in the ScriptPoolManifest data script.
+ * It sets a global ScriptPoolManifest table of script name to pool count,
+ * the format Dump_Lua_Script_Pool_Counts prints the session peaks in.
+ * 
+ * Pooled scripts are CRC'd for multiplayer sync, so every machine has to
+ * hold the same pools.  The manifest ships with the data rather than being
+ * written locally, and it's read once per mode from StoryModeClass::Load_Plots,
+ * behind the loading screen.  Past that, pools grow in Top_Up_Script_Pools
+ * or, when a pool runs dry before it's topped up, inside Create_Script.
+ */
+void LuaScriptClass::Preload_Script_Pools(void)
+{
+	static const char manifest[] = "ScriptPoolManifest";
+
+	if (ScriptPoolsPreloaded) return;
+	ScriptPoolsPreloaded = true;
+
+	// Not every game ships a manifest.
+	std::string full_name;
+	Generate_Full_Path_Name(manifest, full_name);
+	if (full_name.empty()) return;
+
+	SmartPtr<LuaScriptClass> script = new LuaScriptClass();
+	if (!script->Load_From_File(manifest))
+	{
+		script->Shutdown();
+		return;
+	}
+
+	LuaMap::Pointer counts = LUA_SAFE_CAST(LuaMap, script->Map_Global_From_Lua("ScriptPoolManifest", true));
+	script->Shutdown();
+	if (!counts) return;
+
+	LuaMapType::iterator it = counts->Value.begin();
+	for (; it != counts->Value.end(); it++)
+	{
+		LuaString::Pointer name = PG_Dynamic_Cast<LuaString>(it->first);
+		LuaNumber::Pointer count = PG_Dynamic_Cast<LuaNumber>(it->second);
+		if (name && count)
+		{
+			Preload_Script_Pool(name->Value, (int)count->Value);
+		}
+	}
+}
+
 
 /**
  * Check the reload list for any scripts that are pooled.  If any
@@ -1696,6 +2487,19 @@ void LuaScriptClass::Check_For_Script_Reload(std::vector<std::string> &files)
 		tfiles.push_back(Build_Uppercase_String(Strip_Path_And_Extension(files[i].c_str())));
 	}
 
+	// Drop the compiled chunks of the reloaded files.
+	ChunkCacheType::iterator cit = ChunkCache.begin();
+	while (cit != ChunkCache.end())
+	{
+		std::string chunk_name = Build_Uppercase_String(Strip_Path_And_Extension(cit->first.c_str()));
+		if (std::find(tfiles.begin(), tfiles.end(), chunk_name) != tfiles.end())
+		{
+			cit = ChunkCache.erase(cit);
+			continue;
+		}
+		cit++;
+	}
+
 	ActiveScriptListType::iterator it = ActiveScriptList.begin();
 	for (; it != ActiveScriptList.end(); it++)
 	{
@@ -1838,6 +2642,11 @@ bool LuaScriptClass::Load_From_File(const std::string &name)
 	{
 		ScriptShouldCRC = should_crc->Value;
 	}
+	LuaNumber::Pointer resume_budget = LUA_SAFE_CAST(LuaNumber, Map_Global_From_Lua("ThreadResumeBudget"));
+	if (resume_budget)
+	{
+		ThreadResumeBudget = resume_budget->Value > 0.0f ? (int)resume_budget->Value : 0;
+	}
 	if (LuaDebugCallbacks) LuaDebugCallbacks->Script_Added(this);
 	return true;
 }
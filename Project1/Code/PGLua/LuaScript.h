@@ -59,6 +59,7 @@ class GetEvent;
 struct lua_Debug;
 class LuaNetworkDebuggerClass;
 class LuaDebugCallbackClass;
+class BlockingStatus;
 
 
 struct LuaTableMember
@@ -72,6 +73,25 @@ struct LuaTableMember
 
 typedef std::vector<LuaTableMember> LuaTableMemberList;
 
+/**
+ * Counters for one script pool, see LuaScriptClass::Get_Script_Pool_Stats.
+ */
+struct LuaScriptPoolStatsStruct
+{
+	std::string		Name;
+	int				InUse;
+	int				Total;
+	int				Peak;					// Most instances in use at once.
+	int				Misses;				// Create_Script calls that found no free instance.
+	int				Loads;				// Instances loaded.
+	float				LoadTime;			// Average milliseconds to load an instance.
+	int				HeapBytes;			// Lua heap of all instances.
+	int				Threads;
+	int				Resumes;
+	float				ResumesPerSecond;
+	float				PumpTime;			// Milliseconds spent running threads.
+};
+
 /**
  * Wrapper class for a Lua script.  Also handles variable and function
  * mapping to and from Lua.
@@ -80,6 +100,7 @@ class LuaScriptClass : public LuaUserVar, public SignalGeneratorClass {
 public:
 
 	PG_DECLARE_RTTI();
+	LUA_DECLARE_MEMBER_TABLE(LuaScriptClass);
 
 	friend class LuaNetworkDebuggerClass;
 
@@ -127,6 +148,10 @@ public:
 	void Set_Thread_Event_Handler(GetEvent *hand) { ThreadEventHandler = hand; }
 	const std::string *Get_Thread_Name(int id) const;
 	void Kill_Thread(int id);
+	bool Is_Thread_Parked(int id) const { return ThreadData[id].Parked_On != NULL; }
+	static void Wake_Parked_Thread(int script_id, int id, int park_serial);
+	float Get_Thread_Time(int id) const { return ThreadData[id].Total_Time; }
+	int Get_Thread_Resume_Count(int id) const { return ThreadData[id].Resume_Count; }
 
 	/**
 	 * Script Save / Load
@@ -193,9 +218,19 @@ public:
 	 */
 	bool Pool_Is_Fresh_Load(void) const { return PoolFreshLoad; }
 	static SmartPtr<LuaScriptClass> Create_Script(const std::string &name, bool reload = false);
+	static void Preload_Script_Pool(const std::string &name, int count);
+	static void Preload_Script_Pools(void);
+	static void Top_Up_Script_Pools(void);
 	static void Free_Script_Pool(void);
 	static void Dump_Lua_Script_Pool_Counts(void);
+	static void Dump_Lua_Value_Pool_Stats(void);
+	static void Get_Script_Pool_Stats(std::vector<LuaScriptPoolStatsStruct> &stats);
+	static void Format_Script_Pool_Stats(std::string &out, bool json);
+	static bool Export_Script_Pool_Stats(const char *filename, bool json);
+	static void Reset_Script_Pool_Stats(void);
 	static void Check_For_Script_Reload(std::vector<std::string> &files);
+	static void Set_Chunk_Cache_Enabled(bool onoff) { ChunkCacheEnabled = onoff; if (!onoff) Flush_Chunk_Cache(); }
+	static void Flush_Chunk_Cache(void);
 	static LuaScriptClass *Find_Active_Script(const std::string &name);
 
 	/**
@@ -269,6 +304,22 @@ private:
 	typedef stdext::hash_map<std::string, PoolListType> ScriptPoolListType;
 	typedef stdext::hash_map<int, LuaScriptClass *> ActiveScriptListType;
 
+	struct ScriptPoolHistoryStruct {
+		ScriptPoolHistoryStruct() : Peak(0), Misses(0), Loads(0), LoadTime(0.0) {}
+		int										Peak;
+		int										Misses;
+		int										Loads;
+		double									LoadTime;
+	};
+	typedef stdext::hash_map<std::string, ScriptPoolHistoryStruct> ScriptPoolHistoryType;
+
+	struct LuaChunkCacheStruct {
+		LuaChunkCacheStruct() : SourceCRC(0) {}
+		CRCValue									SourceCRC;		// CRC of the source the chunk was compiled from.
+		std::vector<char>						Chunk;			// Compiled chunk from lua_dump.
+	};
+	typedef stdext::hash_map<std::string, LuaChunkCacheStruct> ChunkCacheType;
+
 
 	void Unregister_Thread(lua_State *thread);
 	void Register_Thread(void);
@@ -282,19 +333,48 @@ private:
 	static char Internal_Peek_Char(struct lua_filehandler_tag *handler, void *file);
 	static const char *Internal_Read_File(struct lua_filehandler_tag *handler, void *file, size_t *size);
 	static const char *Internal_Error_File(struct lua_filehandler_tag *handler, void *file);
+	static bool Load_Cached_Chunk(lua_State *L, const char *name, std::vector<char> &buffer);
+	static SmartPtr<LuaScriptClass> Load_Pool_Script(const std::string &name);
+	static bool Grow_Script_Pool(const std::string &name, PoolListType &pool);
+	static void Note_Script_Pool_Use(const std::string &name, PoolListType &pool);
+	static int Get_Script_Pool_In_Use_Count(const PoolListType &pool);
 
 	struct LuaThreadStruct {
-		LuaThreadStruct() : Thread(NULL), Thread_Alert_ID(0), EventAlert(false) {}
+		LuaThreadStruct() : Thread(NULL), Thread_Alert_ID(0), EventAlert(false), Park_Timeout(0), Park_Serial(0), Total_Time(0.0f), Resume_Count(0) {}
 		lua_State								*Thread;
 		LuaVar::Pointer						Thread_Function;
 		std::string								Thread_Name;
 		int										Thread_Alert_ID;
 		bool										EventAlert;
 		LuaVar::Pointer						Thread_Param;
+		SmartPtr<LuaUserVar>					Parked_On;		// BlockingStatus the thread yielded, not resumed until it finishes.
+		int										Park_Timeout;	// Pumps left before a parked thread is resumed anyway, 0 for none.
+		int										Park_Serial;	// Identifies this parking to the parked lists, 0 when not parked.
+		float										Total_Time;		// Milliseconds spent running the thread.
+		int										Resume_Count;
 	};
 
 	std::vector<LuaThreadStruct>		ThreadData;
 
+	struct ParkedThreadStruct {
+		int										ThreadID;
+		int										ParkSerial;
+	};
+
+	void Park_Thread(int id, BlockingStatus *block);
+	void Unpark_Thread(int id);
+	bool Is_Park_Current(const ParkedThreadStruct &parked) const;
+	void Wake_Parked_Threads(void);
+	void Resume_Thread(int id);
+
+	std::vector<ParkedThreadStruct>	WokenThreads;		// Woken by their status since the last pump.
+	std::vector<ParkedThreadStruct>	PolledThreads;		// Parked on statuses that don't signal completion.
+	std::vector<ParkedThreadStruct>	TimedThreads;		// Parked with a wait timeout.
+	std::vector<int>						RunnableThreads;	// Threads that aren't parked, in thread order.
+	bool										RunnableThreadsDirty;
+	int										RunnableThreadsSize;
+	int										NextParkSerial;
+
 	lua_State *								State;
 	int										CurrentThreadId;
 	std::string								Name;
@@ -316,10 +396,20 @@ private:
 	int										SaveID;
 	int										ScriptID;
 	int										DebugTarget;
+	int										NextPumpThread;
+	int										ThreadResumeBudget;	// Most threads resumed a pump, from the script's ThreadResumeBudget global.  0 for no limit.
+	int										PumpResumes;
+	double									PumpTime;
 	
 	static std::vector<std::string>	ScriptPaths;
 	static std::string					ScriptPathString;
 	static ScriptPoolListType			ScriptPool;
+	static ChunkCacheType				ChunkCache;
+	static ScriptPoolHistoryType		ScriptPoolHistory;
+	static double							ScriptPoolStatsStart;
+	static bool								ScriptPoolsPreloaded;
+	static std::vector<std::string>	ScriptPoolTopUpList;
+	static bool								ChunkCacheEnabled;
 	static int								NextScriptID;
 	static ActiveScriptListType		ActiveScriptList;
 	static bool								DebugShouldAttachAll;
@@ -58,6 +58,9 @@ extern "C"
 
 stdext::hash_map<int, LuaFactoryReg::CreateFunctionType>* LuaFactoryReg::FunctionMap = NULL;
 std::vector<FunctionFixup> LuaWrapper::function_fixups;
+std::vector<LuaMemberTableReg::RegEntry> *LuaMemberTableReg::RegList = NULL;
+bool LuaMemberTableReg::TablesBuilt = false;
+LuaMemberTableClass *LuaUserVar::MemberTable = NULL;
 
 PG_IMPLEMENT_RTTI_ROOT(LuaVar);
 PG_IMPLEMENT_RTTI(LuaUserVar, LuaVar);
@@ -142,12 +145,18 @@ int LuaWrapper::Index_Function (lua_State *L)
 	assert(lua_type(L, 1) == LUA_TUSERDATA);
 	LuaUserVar *uservar = (LuaUserVar *)(((LuaWrapper *)lua_topointer(L, 1))->Var);
 
-	if (uservar->MemberMap) {
-		std::string tstr(lua_tostring(L, 2), lua_strlen(L, 2));
-		LuaUserVar::MemberMapType::iterator it = uservar->MemberMap->find(tstr);
-		if (it != uservar->MemberMap->end() && it->second)
+	if (uservar->HasMembers) {
+		if (!LuaMemberTableReg::Are_Member_Tables_Built())
 		{
-			LuaScriptClass::Map_Var_To_Lua(L, it->second);
+			LuaMemberTableReg::Build_Member_Tables();
+		}
+
+		LuaMemberTableClass *table = uservar->Get_Member_Table();
+		assert(table);
+		LuaMemberDescriptorClass *member = table->Find_Member(L, 2);
+		if (member)
+		{
+			LuaScriptClass::Map_Var_To_Lua(L, uservar->Get_Bound_Member(member));
 			return 1;
 		}
 	}
@@ -207,8 +216,6 @@ void LuaWrapper::Do_Fixup(void *)
 	function_fixups.clear();
 }
 
-//    stdext::hash_map<std::string, SmartPtr<LuaVar> >      *MemberMap;
-
 bool LuaUserVar::Internal_Save(ChunkWriterClass *)
 {
 	bool ok = true;
@@ -700,7 +707,18 @@ std::list<SmartPtr<LuaTable>> *LuaTablePool = NULL;
 
 #define LUA_TABLE_POOL_MIN 256
 #define LUA_TABLE_POOL_MAX 512
+#define LUA_TABLE_POOL_LIMIT 4096
 PG_STATIC_ASSERT(LUA_TABLE_POOL_MAX > LUA_TABLE_POOL_MIN);
+PG_STATIC_ASSERT(LUA_TABLE_POOL_LIMIT >= LUA_TABLE_POOL_MAX);
+
+// The pool bounds grow when a frame runs the pool dry.
+static int LuaTablePoolMin = LUA_TABLE_POOL_MIN;
+static int LuaTablePoolMax = LUA_TABLE_POOL_MAX;
+static int LuaTablePoolGrowths = 0;
+static int LuaTableAllocs = 0;
+static int LuaTableMisses = 0;
+static int LuaFrameTableMisses = 0;
+static int LuaLastFrameTableMisses = 0;
 
 /**
  * Init the lua table pool.
@@ -725,24 +743,36 @@ void Shutdown_Lua_Table_Pool(void)
 		delete LuaTablePool;
 		LuaTablePool = NULL;
 	}
+	LuaTablePoolMin = LUA_TABLE_POOL_MIN;
+	LuaTablePoolMax = LUA_TABLE_POOL_MAX;
 }
 
 /**
- * Maintain a pool of lua tables between Min and Max.
+ * Maintain a pool of lua tables between Min and Max.  If the pool ran
+ * dry during the last frame the bounds are doubled, up to LUA_TABLE_POOL_LIMIT.
  * @since 4/29/2005 1:58:40 PM -- BMH
  */
 void Manage_Lua_Tables(void)
 {
-	if (LuaTablePool->size() < LUA_TABLE_POOL_MIN)
+	if (LuaFrameTableMisses > 0 && LuaTablePoolMax < LUA_TABLE_POOL_LIMIT)
 	{
-		int diff = LUA_TABLE_POOL_MAX - LuaTablePool->size();
+		LuaTablePoolMin = min(LuaTablePoolMin * 2, LUA_TABLE_POOL_LIMIT / 2);
+		LuaTablePoolMax = min(LuaTablePoolMax * 2, LUA_TABLE_POOL_LIMIT);
+		LuaTablePoolGrowths++;
+	}
+	LuaLastFrameTableMisses = LuaFrameTableMisses;
+	LuaFrameTableMisses = 0;
+
+	if ((int)LuaTablePool->size() < LuaTablePoolMin)
+	{
+		int diff = LuaTablePoolMax - LuaTablePool->size();
 		for (int i = 0; i < diff; i++)
 		{
 			SmartPtr<LuaTable> tab = new LuaTable();
 			tab->Value.reserve(8);
 			Free_Lua_Table(tab);
 		}
-		assert(LuaTablePool->size() == LUA_TABLE_POOL_MAX);
+		assert((int)LuaTablePool->size() == LuaTablePoolMax);
 	}
 }
 
@@ -754,6 +784,7 @@ void Manage_Lua_Tables(void)
  */
 LuaTable * Alloc_Lua_Table(void)
 {
+	LuaTableAllocs++;
 	if (LuaTablePool->size() != 0)
 	{
 		LuaTable *retval = LuaTablePool->front();
@@ -766,6 +797,8 @@ LuaTable * Alloc_Lua_Table(void)
 		}
 		retval->Release_Ref();
 	}
+	LuaTableMisses++;
+	LuaFrameTableMisses++;
 	return new LuaTable();
 }
 
@@ -785,6 +818,170 @@ void Free_Lua_Table(const SmartPtr<LuaTable> &table)
 	}
 }
 
+/**
+ * One type of temporary handed out by the temporary arena.  The arena keeps
+ * a reference to every temporary it hands out during a frame.  At the end
+ * of the frame the temporaries only the arena still references go back on
+ * the free list, the rest have escaped the call and are left to their owners.
+ */
+template <class T>
+class LuaTemporaryListClass
+{
+public:
+	LuaTemporaryListClass() : Allocs(0), Reuses(0), Escapes(0) {}
+
+	T *Alloc(void)
+	{
+		SmartPtr<T> var;
+		if (Free.size())
+		{
+			var = Free.back();
+			Free.pop_back();
+			Reuses++;
+		}
+		else
+		{
+			var = new T();
+		}
+		Allocs++;
+		Live.push_back(var);
+		return var;
+	}
+
+	void Reset(void)
+	{
+		for (int i = 0; i < (int)Live.size(); i++)
+		{
+			if (Live[i]->Get_Reference_Count() == 1)
+			{
+				Free.push_back(Live[i]);
+			}
+			else
+			{
+				Escapes++;
+			}
+		}
+		Live.resize(0);
+	}
+
+	void Clear(void)
+	{
+		Live.clear();
+		Free.clear();
+	}
+
+	int Get_Live_Count(void) const { return (int)Live.size(); }
+	int Get_Free_Count(void) const { return (int)Free.size(); }
+
+	int										Allocs;
+	int										Reuses;
+	int										Escapes;
+
+private:
+	std::vector<SmartPtr<T> >			Live;
+	std::vector<SmartPtr<T> >			Free;
+};
+
+static LuaTemporaryListClass<LuaNumber>	LuaTemporaryNumbers;
+static LuaTemporaryListClass<LuaBool>		LuaTemporaryBools;
+static LuaTemporaryListClass<LuaString>	LuaTemporaryStrings;
+static int										LuaFrameTemporaryAllocs = 0;
+static int										LuaLastFrameTemporaryAllocs = 0;
+static int										LuaPeakFrameTemporaries = 0;
+
+/**
+ * Map the value at the top of the stack the way Map_Var_From_Lua does,
+ * but take numbers, bools and strings from the temporary arena.  Only for
+ * call arguments; the result must be held in a SmartPtr like any LuaVar.
+ * 
+ * @param L        lua state
+ * @param use_maps map tables to LuaMap
+ * 
+ * @return LuaVar for the popped value.
+ */
+LuaVar *Map_Temporary_From_Lua(lua_State *L, bool use_maps)
+{
+	LuaVar *retval = NULL;
+	switch (lua_type(L, -1)) {
+	case LUA_TNUMBER:
+		{
+			LuaNumber *num = LuaTemporaryNumbers.Alloc();
+			num->Value = (float)lua_tonumber(L, -1);
+			retval = num;
+			break;
+		}
+	case LUA_TBOOLEAN:
+		{
+			LuaBool *bval = LuaTemporaryBools.Alloc();
+			bval->Value = lua_toboolean(L, -1) == 0 ? false : true;
+			retval = bval;
+			break;
+		}
+	case LUA_TSTRING:
+		{
+			LuaString *str = LuaTemporaryStrings.Alloc();
+			str->Value.assign(lua_tostring(L, -1), lua_strlen(L, -1));
+			retval = str;
+			break;
+		}
+	default:
+		return LuaScriptClass::Map_Var_From_Lua(L, use_maps);
+	}
+	LuaFrameTemporaryAllocs++;
+	lua_pop(L, 1);
+	return retval;
+}
+
+/**
+ * Take back the temporaries handed out since the last reset.  Must only be
+ * called between script calls, LuaScriptClass::Service does it once a frame.
+ */
+void Reset_Lua_Temporary_Arena(void)
+{
+	int live = LuaTemporaryNumbers.Get_Live_Count() + LuaTemporaryBools.Get_Live_Count() + LuaTemporaryStrings.Get_Live_Count();
+	LuaPeakFrameTemporaries = max(LuaPeakFrameTemporaries, live);
+	LuaLastFrameTemporaryAllocs = LuaFrameTemporaryAllocs;
+	LuaFrameTemporaryAllocs = 0;
+
+	LuaTemporaryNumbers.Reset();
+	LuaTemporaryBools.Reset();
+	LuaTemporaryStrings.Reset();
+}
+
+/**
+ * Release everything held by the temporary arena.
+ */
+void Shutdown_Lua_Temporary_Arena(void)
+{
+	LuaTemporaryNumbers.Clear();
+	LuaTemporaryBools.Clear();
+	LuaTemporaryStrings.Clear();
+	LuaFrameTemporaryAllocs = 0;
+}
+
+/**
+ * Fill in the current lua table pool and temporary arena counts.
+ * 
+ * @param stats  stats to fill in
+ */
+void Get_Lua_Value_Pool_Stats(LuaValuePoolStatsStruct &stats)
+{
+	stats.TablePoolSize = LuaTablePool ? (int)LuaTablePool->size() : 0;
+	stats.TablePoolMin = LuaTablePoolMin;
+	stats.TablePoolMax = LuaTablePoolMax;
+	stats.TablePoolGrowths = LuaTablePoolGrowths;
+	stats.TableAllocs = LuaTableAllocs;
+	stats.TableMisses = LuaTableMisses;
+	stats.FrameTableMisses = LuaLastFrameTableMisses;
+
+	stats.TemporaryAllocs = LuaTemporaryNumbers.Allocs + LuaTemporaryBools.Allocs + LuaTemporaryStrings.Allocs;
+	stats.TemporaryReuses = LuaTemporaryNumbers.Reuses + LuaTemporaryBools.Reuses + LuaTemporaryStrings.Reuses;
+	stats.TemporaryEscapes = LuaTemporaryNumbers.Escapes + LuaTemporaryBools.Escapes + LuaTemporaryStrings.Escapes;
+	stats.FrameTemporaryAllocs = LuaLastFrameTemporaryAllocs;
+	stats.PeakFrameTemporaries = LuaPeakFrameTemporaries;
+	stats.TemporaryFreeCount = LuaTemporaryNumbers.Get_Free_Count() + LuaTemporaryBools.Get_Free_Count() + LuaTemporaryStrings.Get_Free_Count();
+}
+
 /**
  * Function call meta-method.  called when an object has the
  * '()' applied to it.
@@ -804,19 +1001,30 @@ int LuaWrapper::Function_Call(lua_State *L)
 
 	int n = lua_gettop(L); // number of arguments
 
+	LuaScriptClass *script = LuaScriptClass::Get_Script_From_State(L);
+	// LuaScriptClass *script = PG_Dynamic_Cast<LuaScriptClass>(LuaScriptClass::Map_Global_From_Lua(L, "Script"));
+	assert(script);
+
+	if (wrapper->Var->Has_Stack_Function_Call())
+	{
+		// Fast path, the function reads its arguments off the stack and
+		// pushes its return values above them.
+		script->Set_Current_Thread(L);
+		LuaStackArgsClass args(L, 2, use_maps);
+		wrapper->Var->Stack_Function_Call(script, args);
+		return args.Get_Return_Count();
+	}
+
 	SmartPtr<LuaTable> params = Alloc_Lua_Table();
 	for (int i = 2; i <= n; i++)
 	{
 		// start at the second argument
 		lua_pushvalue(L, i);
-		params->Value.push_back(LuaScriptClass::Map_Var_From_Lua(L, use_maps));
+		params->Value.push_back(Map_Temporary_From_Lua(L, use_maps));
 		//lua_pop(L, 1);
 	}
 	// Call the function with the table.  If the function returns a table
 	// then iterate the items in the table and return those as parameters.
-	LuaScriptClass *script = LuaScriptClass::Get_Script_From_State(L);
-	// LuaScriptClass *script = PG_Dynamic_Cast<LuaScriptClass>(LuaScriptClass::Map_Global_From_Lua(L, "Script"));
-	assert(script);
 	script->Set_Current_Thread(L);
 	SmartPtr<LuaTable> rval = wrapper->Var->Function_Call(script, params);
 	Free_Lua_Table(params);
@@ -839,6 +1047,155 @@ int LuaWrapper::Function_Call(lua_State *L)
 	return rcnt;
 }
 
+/**
+ * Constructor
+ * 
+ * @param L         lua state of the call
+ * @param first_arg stack index of the first argument
+ * @param use_maps  map table arguments to LuaMap instead of LuaTable in Get_Var
+ */
+LuaStackArgsClass::LuaStackArgsClass(lua_State *L, int first_arg, bool use_maps) :
+	State(L)
+,	FirstArg(first_arg)
+,	Count(0)
+,	ReturnCount(0)
+,	UseMaps(use_maps)
+{
+	assert(L);
+	Count = lua_gettop(L) - first_arg + 1;
+	if (Count < 0) Count = 0;
+}
+
+bool LuaStackArgsClass::Is_Nil(int index) const
+{
+	return index >= Count || lua_isnil(State, Get_Stack_Index(index));
+}
+
+bool LuaStackArgsClass::Is_Number(int index) const
+{
+	return index < Count && lua_type(State, Get_Stack_Index(index)) == LUA_TNUMBER;
+}
+
+bool LuaStackArgsClass::Is_Bool(int index) const
+{
+	return index < Count && lua_type(State, Get_Stack_Index(index)) == LUA_TBOOLEAN;
+}
+
+bool LuaStackArgsClass::Is_String(int index) const
+{
+	return index < Count && lua_type(State, Get_Stack_Index(index)) == LUA_TSTRING;
+}
+
+bool LuaStackArgsClass::Is_User_Var(int index) const
+{
+	return index < Count && lua_type(State, Get_Stack_Index(index)) == LUA_TUSERDATA;
+}
+
+float LuaStackArgsClass::Get_Number(int index) const
+{
+	assert(Is_Number(index));
+	return (float)lua_tonumber(State, Get_Stack_Index(index));
+}
+
+bool LuaStackArgsClass::Get_Bool(int index) const
+{
+	assert(Is_Bool(index));
+	return lua_toboolean(State, Get_Stack_Index(index)) != 0;
+}
+
+/**
+ * Get a string argument.  The string belongs to Lua and is only valid
+ * until the function returns.
+ * 
+ * @param index  argument index
+ * @param length optional, set to the length of the string
+ * 
+ * @return the string or NULL if the argument is not a string.
+ */
+const char *LuaStackArgsClass::Get_String(int index, size_t *length /*= NULL*/) const
+{
+	if (!Is_String(index)) return NULL;
+	if (length) *length = lua_strlen(State, Get_Stack_Index(index));
+	return lua_tostring(State, Get_Stack_Index(index));
+}
+
+/**
+ * Get a user var argument.
+ * 
+ * @param index  argument index
+ * 
+ * @return the LuaUserVar or NULL if the argument is not a user var.
+ */
+LuaUserVar *LuaStackArgsClass::Get_User_Var(int index) const
+{
+	if (!Is_User_Var(index)) return NULL;
+	LuaWrapper *wrap = (LuaWrapper *)lua_topointer(State, Get_Stack_Index(index));
+	assert(lua_issamestate(wrap->State, State)); // This is bad if this hits.
+	return wrap->Var;
+}
+
+/**
+ * Map an argument to a LuaVar the same way LuaTable arguments are mapped.
+ * Allocates for anything but user vars, so hold the result in a SmartPtr.
+ * 
+ * @param index  argument index
+ * 
+ * @return the argument as a LuaVar.
+ */
+LuaVar *LuaStackArgsClass::Get_Var(int index) const
+{
+	if (index >= Count) return new LuaVoid(NULL);
+	lua_pushvalue(State, Get_Stack_Index(index));
+	return Map_Temporary_From_Lua(State, UseMaps);
+}
+
+void LuaStackArgsClass::Return_Nil(void)
+{
+	lua_pushnil(State);
+	ReturnCount++;
+}
+
+void LuaStackArgsClass::Return_Number(float value)
+{
+	lua_pushnumber(State, value);
+	ReturnCount++;
+}
+
+void LuaStackArgsClass::Return_Bool(bool value)
+{
+	lua_pushboolean(State, value);
+	ReturnCount++;
+}
+
+void LuaStackArgsClass::Return_String(const char *value, size_t length)
+{
+	lua_pushlstring(State, value, length);
+	ReturnCount++;
+}
+
+/**
+ * Push any LuaVar as a return value.
+ * 
+ * @param var    return value, NULL returns nil.
+ */
+void LuaStackArgsClass::Return_Var(LuaVar *var)
+{
+	if (!var)
+	{
+		Return_Nil();
+		return;
+	}
+
+	// Hold a reference while mapping in case this is a new object.
+	SmartPtr<LuaVar> hold = var;
+	LuaScriptClass::Map_Var_To_Lua(State, var);
+	if (var->Get_Var_Type() == LUA_VAR_TYPE_TABLE)
+	{
+		Free_Lua_Table((const SmartPtr<LuaTable> &)(hold));
+	}
+	ReturnCount++;
+}
+
 /**
  * Constructor
  * 
@@ -848,12 +1205,9 @@ int LuaWrapper::Function_Call(lua_State *L)
 LuaUserVar::LuaUserVar(int id /*= LUA_CHUNK_INVALID*/, bool register_member_functions /*= true*/) : 
 	ChunkId(id)
 , Wrapper(NULL)
-, MemberMap(NULL)
+, BoundMembers(NULL)
+, HasMembers(register_member_functions)
 {
-	if (register_member_functions)
-	{
-		LUA_REGISTER_MEMBER_FUNCTION(LuaUserVar, "Is_Pool_Safe", &LuaUserVar::Is_Pool_Safe);
-	}
 }
 
 /**
@@ -861,18 +1215,27 @@ LuaUserVar::LuaUserVar(int id /*= LUA_CHUNK_INVALID*/, bool register_member_func
  */
 LuaUserVar::~LuaUserVar() 
 {
-	delete MemberMap;
+	delete BoundMembers;
 }
 
 LuaUserVar::LuaUserVar(const LuaUserVar &other) :
 	ChunkId(other.ChunkId),
 	Wrapper(NULL),
-	MemberMap(NULL)
+	BoundMembers(NULL),
+	HasMembers(other.HasMembers)
 {
-	if (other.MemberMap)
-	{
-		LUA_REGISTER_MEMBER_FUNCTION(LuaUserVar, "Is_Pool_Safe", &LuaUserVar::Is_Pool_Safe);
-	}
+}
+
+/**
+ * Members every script object has.  Derived member tables start as a copy
+ * of their base's, so a class can replace one of these by registering the
+ * same name.
+ * 
+ * @param table  LuaUserVar member table
+ */
+void LuaUserVar::Register_Members(LuaMemberTableClass *table)
+{
+	LUA_REGISTER_MEMBER_FUNCTION(LuaUserVar, "Is_Pool_Safe", &LuaUserVar::Is_Pool_Safe);
 }
 
 /**
@@ -935,19 +1298,399 @@ LuaVar *LuaUserVar::Map_Into_Other_Script(LuaScriptClass *)
 }
 
 /**
- * Register a member with this Object.
+ * Return the wrapper that binds a member of our class's member table to
+ * this object.  The wrapper is created the first time Lua asks for the
+ * member and reused after that.
+ * 
+ * @param member member descriptor from our member table
+ * 
+ * @return LuaVar to hand to Lua for the member.
+ */
+LuaVar *LuaUserVar::Get_Bound_Member(LuaMemberDescriptorClass *member)
+{
+	assert(member);
+	if (!BoundMembers)
+	{
+		BoundMembers = new BoundMemberListType();
+	}
+
+	for (int i = 0; i < (int)BoundMembers->size(); i++)
+	{
+		if ((*BoundMembers)[i].first == member)
+		{
+			return (*BoundMembers)[i].second;
+		}
+	}
+
+	BoundMembers->push_back(std::make_pair(SmartPtr<LuaMemberDescriptorClass>(member), SmartPtr<LuaVar>(member->Bind(this))));
+	return BoundMembers->back().second;
+}
+
+LuaMemberTableClass::LuaMemberTableClass() :
+	SymbolTableDirty(true),
+	InternedCount(0)
+{
+}
+
+/**
+ * Register a member with this table.
  * 
- * @param name     name to associate with this object.  This will result in a key
+ * @param name     name to associate with the member.  This will result in a key
  *                 of LuaString.
- * @param function The LuaVar object to associated with Key.
+ * @param member   descriptor of the member.  Replaces any inherited member of the same name.
  * @since 4/22/2004 2:36:22 PM -- BMH
  */
-void LuaUserVar::Register_Member(const char *name, LuaVar *function)
+void LuaMemberTableClass::Register_Member(const char *name, LuaMemberDescriptorClass *member)
+{
+	Members[name] = member;
+	SymbolTableDirty = true;
+}
+
+/**
+ * Copy all the members of the parent class's table into this table.
+ * 
+ * @param parent member table of the base class
+ */
+void LuaMemberTableClass::Inherit(const LuaMemberTableClass *parent)
 {
-	if (!MemberMap) {
-		MemberMap = new MemberMapType();
+	assert(parent);
+	MemberMapType::const_iterator it = parent->Members.begin();
+	for (; it != parent->Members.end(); it++)
+	{
+		Members[it->first] = it->second;
+	}
+	SymbolTableDirty = true;
+}
+
+/**
+ * Look up a member by name.
+ * 
+ * @param name   name of the member
+ * 
+ * @return member descriptor or NULL if this class has no such member.
+ */
+LuaMemberDescriptorClass *LuaMemberTableClass::Find_Member(const std::string &name) const
+{
+	MemberMapType::const_iterator it = Members.find(name);
+	if (it == Members.end()) return NULL;
+	return it->second;
+}
+
+/**
+ * Look up a member by a Lua string.  Hits and misses alike are answered from
+ * the symbol table without building a std::string.
+ * 
+ * @param symbol string as returned by lua_tostring
+ * @param length length of the string as returned by lua_strlen
+ * 
+ * @return member descriptor or NULL if this class has no such member.
+ */
+LuaMemberDescriptorClass *LuaMemberTableClass::Find_Member(const char *symbol, size_t length)
+{
+	assert(symbol);
+	if (SymbolTableDirty)
+	{
+		Build_Symbol_Table();
+	}
+
+	unsigned int mask = SymbolTable.size() - 1;
+	for (unsigned int slot = Hash_Symbol(symbol, length) & mask; ; slot = (slot + 1) & mask)
+	{
+		const SymbolEntry &entry = SymbolTable[slot];
+		if (entry.Name == NULL)
+		{
+			return NULL;
+		}
+		if (entry.Name->size() == length && memcmp(entry.Name->data(), symbol, length) == 0)
+		{
+			return entry.Member;
+		}
+	}
+}
+
+/**
+ * Look up a member by the Lua string at a stack index.  Hits are answered
+ * from the address Lua interned the string at.  Only a miss falls back on
+ * the characters, after which a member's name is pinned and its address
+ * remembered.
+ * 
+ * @param L      lua state
+ * @param index  absolute stack index of the member name
+ * 
+ * @return member descriptor or NULL if this class has no such member.
+ */
+LuaMemberDescriptorClass *LuaMemberTableClass::Find_Member(lua_State *L, int index)
+{
+	assert(index > 0);
+	if (SymbolTableDirty)
+	{
+		Build_Symbol_Table();
+	}
+
+	const char *symbol = lua_tostring(L, index);
+	if (!symbol) return NULL;
+
+	if (InternedCount)
+	{
+		unsigned int mask = InternedTable.size() - 1;
+		for (unsigned int slot = Hash_Interned_Symbol(symbol) & mask; ; slot = (slot + 1) & mask)
+		{
+			const InternedEntry &entry = InternedTable[slot];
+			if (entry.Symbol == symbol)
+			{
+				return entry.Member;
+			}
+			if (entry.Symbol == NULL)
+			{
+				break;
+			}
+		}
+	}
+
+	LuaMemberDescriptorClass *member = Find_Member(symbol, lua_strlen(L, index));
+	if (!member) return NULL;
+
+	// Pin the name so Lua can't collect it and hand its address to another string.
+	static const char lua_symboltable[] = "LuaMemberSymbols";
+	lua_pushlstring(L, lua_symboltable, sizeof(lua_symboltable)-1);
+	lua_rawget(L, LUA_REGISTRYINDEX);
+	if (!lua_istable(L, -1))
+	{
+		lua_pop(L, 1);
+		lua_newtable(L);
+		lua_pushlstring(L, lua_symboltable, sizeof(lua_symboltable)-1);
+		lua_pushvalue(L, -2);
+		lua_rawset(L, LUA_REGISTRYINDEX);
+	}
+	lua_pushvalue(L, index);
+	lua_pushboolean(L, 1);
+	lua_rawset(L, -3);
+	lua_pop(L, 1);
+
+	Add_Interned_Symbol(symbol, member);
+	return member;
+}
+
+/**
+ * Remember the member an interned Lua string names.  The table is kept a power
+ * of two at least twice the entry count, like the symbol table.
+ * 
+ * @param symbol address of the interned Lua string
+ * @param member member descriptor the string names
+ */
+void LuaMemberTableClass::Add_Interned_Symbol(const char *symbol, LuaMemberDescriptorClass *member)
+{
+	if ((InternedCount + 1) * 2 > (int)InternedTable.size())
+	{
+		std::vector<InternedEntry> old_table;
+		old_table.swap(InternedTable);
+
+		InternedEntry empty = { NULL, NULL };
+		InternedTable.resize(max((unsigned int)16, (unsigned int)old_table.size() * 2), empty);
+		InternedCount = 0;
+		for (int i = 0; i < (int)old_table.size(); i++)
+		{
+			if (old_table[i].Symbol)
+			{
+				Add_Interned_Symbol(old_table[i].Symbol, old_table[i].Member);
+			}
+		}
+	}
+
+	unsigned int mask = InternedTable.size() - 1;
+	unsigned int slot = Hash_Interned_Symbol(symbol) & mask;
+	while (InternedTable[slot].Symbol)
+	{
+		slot = (slot + 1) & mask;
+	}
+	InternedTable[slot].Symbol = symbol;
+	InternedTable[slot].Member = member;
+	InternedCount++;
+}
+
+/**
+ * Forget every interned string address.  Called when a Lua state is closed,
+ * since its strings' addresses can be reused by another state.
+ */
+void LuaMemberTableClass::Flush_Interned_Symbols(void)
+{
+	InternedTable.resize(0);
+	InternedCount = 0;
+}
+
+/**
+ * Rebuild the symbol table from the member map.  The table is a power of two
+ * at least twice the member count, so probe runs stay short and there is
+ * always an empty slot to end a miss.
+ */
+void LuaMemberTableClass::Build_Symbol_Table(void)
+{
+	unsigned int size = 8;
+	while (size < Members.size() * 2)
+	{
+		size <<= 1;
+	}
+
+	SymbolEntry empty = { NULL, NULL };
+	SymbolTable.resize(0);
+	SymbolTable.resize(size, empty);
+
+	unsigned int mask = size - 1;
+	MemberMapType::const_iterator it = Members.begin();
+	for (; it != Members.end(); it++)
+	{
+		unsigned int slot = Hash_Symbol(it->first.data(), it->first.size()) & mask;
+		while (SymbolTable[slot].Name)
+		{
+			slot = (slot + 1) & mask;
+		}
+		SymbolTable[slot].Name = &it->first;
+		SymbolTable[slot].Member = it->second;
+	}
+
+	// The members changed, so the interned addresses may name stale descriptors.
+	Flush_Interned_Symbols();
+	SymbolTableDirty = false;
+}
+
+/**
+ * FNV-1a over the characters of a member name.
+ */
+unsigned int LuaMemberTableClass::Hash_Symbol(const char *symbol, size_t length)
+{
+	unsigned int hash = 2166136261U;
+	for (size_t i = 0; i < length; i++)
+	{
+		hash ^= (unsigned char)symbol[i];
+		hash *= 16777619U;
+	}
+	return hash;
+}
+
+/**
+ * Mix the address of an interned Lua string.  Lua's allocations are aligned,
+ * so the low bits are dropped before mixing.
+ */
+unsigned int LuaMemberTableClass::Hash_Interned_Symbol(const char *symbol)
+{
+	unsigned int hash = (unsigned int)((size_t)symbol >> 3);
+	hash ^= hash >> 16;
+	hash *= 0x45d9f3bU;
+	hash ^= hash >> 16;
+	return hash;
+}
+
+LuaMemberTableReg::LuaMemberTableReg(LuaMemberTableClass **table, LuaMemberTableClass **parent, RegisterFunctionType function)
+{
+	if (!RegList) {
+		RegList = new std::vector<RegEntry>();
+	}
+
+	assert(table && function);
+	assert(table != parent);
+
+	RegEntry entry;
+	entry.Table = table;
+	entry.Parent = parent;
+	entry.Function = function;
+	RegList->push_back(entry);
+}
+
+/**
+ * Build the member table for one registered class, building its
+ * base class's table first.
+ * 
+ * @param index  index into the registration list
+ */
+void LuaMemberTableReg::Build_Member_Table(int index)
+{
+	RegEntry &entry = (*RegList)[index];
+	if (*entry.Table) return;
+
+	LuaMemberTableClass *table = new LuaMemberTableClass();
+	if (entry.Parent)
+	{
+		if (!*entry.Parent)
+		{
+			for (int i = 0; i < (int)RegList->size(); i++)
+			{
+				if ((*RegList)[i].Table == entry.Parent)
+				{
+					Build_Member_Table(i);
+					break;
+				}
+			}
+		}
+		assert(*entry.Parent);
+		if (*entry.Parent)
+		{
+			table->Inherit(*entry.Parent);
+		}
+	}
+	entry.Function(table);
+	*entry.Table = table;
+}
+
+/**
+ * Build the shared member tables of every registered LuaUserVar class.
+ */
+void LuaMemberTableReg::Build_Member_Tables(void)
+{
+	if (TablesBuilt) return;
+
+	// LuaUserVar is the root of every member table.
+	if (!LuaUserVar::MemberTable)
+	{
+		LuaUserVar::MemberTable = new LuaMemberTableClass();
+		LuaUserVar::Register_Members(LuaUserVar::MemberTable);
+	}
+
+	if (RegList)
+	{
+		for (int i = 0; i < (int)RegList->size(); i++)
+		{
+			Build_Member_Table(i);
+		}
+	}
+	TablesBuilt = true;
+}
+
+/**
+ * Free the shared member tables.
+ */
+void LuaMemberTableReg::Free_Member_Tables(void)
+{
+	if (RegList)
+	{
+		for (int i = 0; i < (int)RegList->size(); i++)
+		{
+			delete *(*RegList)[i].Table;
+			*(*RegList)[i].Table = NULL;
+		}
+	}
+	delete LuaUserVar::MemberTable;
+	LuaUserVar::MemberTable = NULL;
+	TablesBuilt = false;
+}
+
+/**
+ * Flush the interned string addresses of every member table.  Must be called
+ * whenever a Lua state is closed.
+ */
+void LuaMemberTableReg::Flush_Interned_Symbols(void)
+{
+	if (RegList)
+	{
+		for (int i = 0; i < (int)RegList->size(); i++)
+		{
+			LuaMemberTableClass *table = *(*RegList)[i].Table;
+			if (table) table->Flush_Interned_Symbols();
+		}
+	}
+	if (LuaUserVar::MemberTable)
+	{
+		LuaUserVar::MemberTable->Flush_Interned_Symbols();
 	}
-	(*MemberMap)[name] = function;
 }
 
 size_t LuaHashCompare::operator()(const SmartPtr<LuaVar>& Left) const
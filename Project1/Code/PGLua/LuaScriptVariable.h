@@ -162,17 +162,49 @@ typedef LuaValue<void *, LUA_VAR_TYPE_POINTER> 											LuaPointer;
 	static LuaUserVar *FactoryCreate(int cid = chunk_id) { LuaUserVar *var = new class_name(); \
 		var->Set_Chunk_Id(cid); return var; }
 
+/**
+ * Declares the shared member table for a LuaUserVar class.  The table is
+ * filled in once by the class's static Register_Members function rather
+ * than per instance.
+ * 
+ * @see LUA_IMPLEMENT_MEMBER_TABLE
+ */
+#define LUA_DECLARE_MEMBER_TABLE(class_name) \
+	public: \
+	static LuaMemberTableClass *MemberTable; \
+	static void Register_Members(LuaMemberTableClass *table); \
+	virtual LuaMemberTableClass *Get_Member_Table(void) const { return MemberTable; }
+
+/**
+ * Defines the shared member table for a LuaUserVar class and registers it
+ * to be built, on top of its base class's table, at System_Initialize.
+ * 
+ * @see LUA_DECLARE_MEMBER_TABLE
+ */
+#define LUA_IMPLEMENT_MEMBER_TABLE(class_name, base_name) \
+	LuaMemberTableClass *class_name::MemberTable = NULL; \
+	LuaMemberTableReg		PG_JOIN(__, PG_JOIN(class_name, MemberTableReg)) (&class_name::MemberTable, &base_name::MemberTable, class_name::Register_Members) 
+
 /**
  * Macro to aid in registering a Member function to Lua.  Takes the type,
- * Lua name, and MemberFunction pointer and creates a Wrapper object that
- * maps the function call to the Member.
+ * Lua name, and MemberFunction pointer and adds a descriptor for the member
+ * to the class's shared member table.  Only valid inside Register_Members.
  * @since 4/22/2004 2:16:14 PM -- BMH
  */
 #define LUA_REGISTER_MEMBER_FUNCTION(type, name, func) \
-	Register_Member(name, new LuaMemberFunctionWrapper<type>(this, func))
+	table->Register_Member(name, new LuaMemberFunctionDescriptor<type>(func))
 	
 #define LUA_REGISTER_MEMBER_FUNCTION_USE_MAPS(type, name, func) \
-	Register_Member(name, new LuaMemberFunctionWrapper<type>(this, func, true))
+	table->Register_Member(name, new LuaMemberFunctionDescriptor<type>(func, true))
+
+/**
+ * Macro to aid in registering a stack Member function to Lua.  Stack member
+ * functions read their arguments straight off the Lua stack and push their
+ * return values through a LuaStackArgsClass instead of a LuaTable.
+ * Only valid inside Register_Members.
+ */
+#define LUA_REGISTER_MEMBER_STACK_FUNCTION(type, name, func) \
+	table->Register_Member(name, new LuaMemberStackFunctionDescriptor<type>(func))
 
 /**
  * Utility macro for use in setting up Lua meta-tables.
@@ -246,6 +278,154 @@ private:
 	static stdext::hash_map<int, CreateFunctionType>		*FunctionMap;
 };
 
+/**
+ * Unbound description of a member registered with a LuaMemberTableClass.
+ * A descriptor is shared by every instance of the class that registered it
+ * and is only bound to a particular object when Lua indexes that object.
+ */
+class LuaMemberDescriptorClass : public RefCountClass
+{
+public:
+	LuaMemberDescriptorClass(bool use_maps) : UseMaps(use_maps) {}
+	virtual ~LuaMemberDescriptorClass() {}
+
+	virtual LuaUserVar *Bind(LuaUserVar *object) const = 0;
+	bool Get_Use_Maps(void) const { return UseMaps; }
+
+private:
+	bool						UseMaps;
+};
+
+/**
+ * Per-class table of Lua visible members.  Built once per class, with the
+ * base class's members merged in, and shared by all of the class's instances.
+ */
+class LuaMemberTableClass
+{
+public:
+	LuaMemberTableClass();
+
+	void Register_Member(const char *name, LuaMemberDescriptorClass *member);
+	void Inherit(const LuaMemberTableClass *parent);
+	LuaMemberDescriptorClass *Find_Member(const std::string &name) const;
+	LuaMemberDescriptorClass *Find_Member(const char *symbol, size_t length);
+	LuaMemberDescriptorClass *Find_Member(lua_State *L, int index);
+	void Flush_Interned_Symbols(void);
+	int Get_Member_Count(void) const { return (int)Members.size(); }
+
+private:
+	void Build_Symbol_Table(void);
+	void Add_Interned_Symbol(const char *symbol, LuaMemberDescriptorClass *member);
+	static unsigned int Hash_Symbol(const char *symbol, size_t length);
+	static unsigned int Hash_Interned_Symbol(const char *symbol);
+
+	typedef stdext::hash_map<std::string, SmartPtr<LuaMemberDescriptorClass>, stdext::hash_compare<std::string, std::less<std::string> >> MemberMapType;
+	MemberMapType				Members;
+
+	// Open addressed copy of Members, hashed on the name's characters so a
+	// raw Lua string can be looked up without building a std::string.  Sized
+	// from the member count, so every member has a home and nothing is
+	// evicted.  Rebuilt on the first lookup after Members changes.
+	struct SymbolEntry
+	{
+		const std::string				*Name;
+		LuaMemberDescriptorClass	*Member;
+	};
+	std::vector<SymbolEntry>	SymbolTable;
+	bool							SymbolTableDirty;
+
+	// Members found from Lua, keyed on the address of the interned Lua string
+	// so a hit never reads the name.  Lua keeps one copy of each string per
+	// state, and every name cached here is pinned in its state's registry, so
+	// the address means that name until the state is closed.  Closing a state
+	// flushes every table (LuaMemberTableReg::Flush_Interned_Symbols).
+	struct InternedEntry
+	{
+		const char						*Symbol;
+		LuaMemberDescriptorClass	*Member;
+	};
+	std::vector<InternedEntry>	InternedTable;
+	int							InternedCount;
+};
+
+/**
+ * Member table registration.  Tracks every class that declared a member
+ * table so the tables can be built, parents first, at System_Initialize.
+ * 
+ * @see LUA_IMPLEMENT_MEMBER_TABLE
+ */
+class LuaMemberTableReg
+{
+public:
+	typedef void (*RegisterFunctionType)(LuaMemberTableClass *table);
+
+	LuaMemberTableReg(LuaMemberTableClass **table, LuaMemberTableClass **parent, RegisterFunctionType function);
+
+	static void Build_Member_Tables(void);
+	static void Free_Member_Tables(void);
+	static void Flush_Interned_Symbols(void);
+	static bool Are_Member_Tables_Built(void) { return TablesBuilt; }
+
+private:
+	static void Build_Member_Table(int index);
+
+	struct RegEntry
+	{
+		LuaMemberTableClass		**Table;
+		LuaMemberTableClass		**Parent;
+		RegisterFunctionType		Function;
+	};
+
+	static std::vector<RegEntry>		*RegList;
+	static bool								TablesBuilt;
+};
+
+/**
+ * View of the arguments of a call from Lua as they sit on the Lua stack.
+ * Stack functions read their arguments through the typed accessors and
+ * push their return values with the Return_ functions, so a call needs no
+ * LuaTable and no LuaVar per argument or return value.  Arguments are
+ * indexed from 0 like LuaTable::Value.
+ * 
+ * @see LUA_REGISTER_MEMBER_STACK_FUNCTION
+ */
+class LuaStackArgsClass
+{
+public:
+	LuaStackArgsClass(lua_State *L, int first_arg, bool use_maps);
+
+	int Get_Count(void) const { return Count; }
+	bool Is_Nil(int index) const;
+	bool Is_Number(int index) const;
+	bool Is_Bool(int index) const;
+	bool Is_String(int index) const;
+	bool Is_User_Var(int index) const;
+
+	float Get_Number(int index) const;
+	bool Get_Bool(int index) const;
+	const char *Get_String(int index, size_t *length = NULL) const;
+	LuaUserVar *Get_User_Var(int index) const;
+	LuaVar *Get_Var(int index) const;
+
+	void Return_Nil(void);
+	void Return_Number(float value);
+	void Return_Bool(bool value);
+	void Return_String(const char *value, size_t length);
+	void Return_Var(LuaVar *var);
+	int Get_Return_Count(void) const { return ReturnCount; }
+
+	lua_State *Get_State(void) const { return State; }
+
+private:
+	int Get_Stack_Index(int index) const { return FirstArg + index; }
+
+	lua_State *					State;
+	int							FirstArg;
+	int							Count;
+	int							ReturnCount;
+	bool							UseMaps;
+};
+
 /**
  * Base class representation of a Lua Variable.
  */
@@ -386,6 +566,34 @@ void Manage_Lua_Tables(void);
 void Init_Lua_Table_Pool(void);
 void Shutdown_Lua_Table_Pool(void);
 
+LuaVar *Map_Temporary_From_Lua(lua_State *L, bool use_maps);
+void Reset_Lua_Temporary_Arena(void);
+void Shutdown_Lua_Temporary_Arena(void);
+
+/**
+ * Allocation counts for the lua table pool and the temporary arena.
+ * Per frame counts cover the frame that was last reset.
+ */
+struct LuaValuePoolStatsStruct
+{
+	int		TablePoolSize;
+	int		TablePoolMin;
+	int		TablePoolMax;
+	int		TablePoolGrowths;
+	int		TableAllocs;
+	int		TableMisses;
+	int		FrameTableMisses;
+
+	int		TemporaryAllocs;
+	int		TemporaryReuses;
+	int		TemporaryEscapes;
+	int		FrameTemporaryAllocs;
+	int		PeakFrameTemporaries;
+	int		TemporaryFreeCount;
+};
+
+void Get_Lua_Value_Pool_Stats(LuaValuePoolStatsStruct &stats);
+
 /**
  * Convienent function to stuff a Lua var into a table for return
  * values or as parameters to lua functions.
@@ -420,7 +628,10 @@ public:
 	virtual bool Hash_Compare(const LuaUserVar *val) const;
 	virtual bool Is_Equal(const LuaVar *val) const;
 	virtual LuaTable *Function_Call(LuaScriptClass * /*script*/, LuaTable * /*params*/);
-	void Register_Member(const char *name, LuaVar *function);
+	virtual bool Has_Stack_Function_Call(void) const { return false; }
+	virtual void Stack_Function_Call(LuaScriptClass * /*script*/, LuaStackArgsClass & /*args*/) {}
+	virtual LuaMemberTableClass *Get_Member_Table(void) const { return MemberTable; }
+	LuaVar *Get_Bound_Member(LuaMemberDescriptorClass *member);
 	virtual void To_String(std::string &outstr);
 	const std::string &Get_To_String(void);
 	virtual LuaVar *Map_Into_Other_Script(LuaScriptClass *new_script);
@@ -447,16 +658,19 @@ public:
 
 	virtual LuaTable *Is_Pool_Safe(LuaScriptClass *, LuaTable *) { return Return_Variable(new LuaBool(true)); }
 
-protected:
-	typedef stdext::hash_map<std::string, SmartPtr<LuaVar>, stdext::hash_compare<std::string, std::less<std::string> >> MemberMapType;
-	MemberMapType				*MemberMap;
+	static LuaMemberTableClass *MemberTable;
+	static void Register_Members(LuaMemberTableClass *table);
 
 private:
-//    typedef std::map<std::string, SmartPtr<LuaVar>, std::less<std::string>,
-//       PooledSTLAllocatorClass<std::pair<std::string, SmartPtr<LuaVar> >, 128> > MemberMapType;
+	// Members bound to this object so far.  Only the members Lua has actually
+	// indexed get a wrapper, and most objects only ever use a handful.  The
+	// descriptor is held so it outlives a System_Shutdown of the member tables.
+	typedef std::vector<std::pair<SmartPtr<LuaMemberDescriptorClass>, SmartPtr<LuaVar> > > BoundMemberListType;
+	BoundMemberListType		*BoundMembers;
 
 	LuaWrapper					*Wrapper;
 	int							ChunkId;
+	bool							HasMembers;
 };
 
 /**
@@ -493,6 +707,81 @@ private:
 	bool						UseMaps;
 };
 
+/**
+ * Descriptor for a LuaUserVar member function.  Binding creates the
+ * LuaMemberFunctionWrapper that Lua actually calls.
+ */
+template <typename T>
+class LuaMemberFunctionDescriptor : public LuaMemberDescriptorClass
+{
+public:
+
+	typedef LuaTable * (T::*MemberFunctionPtr)(LuaScriptClass *, LuaTable *);
+
+	LuaMemberFunctionDescriptor(MemberFunctionPtr func, bool use_maps = false) : 
+			LuaMemberDescriptorClass(use_maps), MemberFunction(func) {}
+
+	virtual LuaUserVar *Bind(LuaUserVar *object) const
+	{
+		assert(object);
+		return new LuaMemberFunctionWrapper<T>(static_cast<T *>(object), MemberFunction, Get_Use_Maps());
+	}
+
+private:
+	MemberFunctionPtr		MemberFunction;
+};
+
+/**
+ * Wrapper object for a LuaUserVar stack member function.  Called through
+ * LuaWrapper::Function_Call without marshalling the arguments into a LuaTable.
+ */
+template <typename T>
+class LuaMemberStackFunctionWrapper : public LuaUserVar
+{
+public:
+
+	typedef void (T::*MemberFunctionPtr)(LuaScriptClass *, LuaStackArgsClass &);
+
+	LuaMemberStackFunctionWrapper(T * obj, MemberFunctionPtr func) : 
+			LuaUserVar(LUA_CHUNK_INVALID, false), MemberFunction(func), Object(obj) {}
+
+	virtual bool Has_Stack_Function_Call(void) const { return true; }
+
+	virtual void Stack_Function_Call(LuaScriptClass *script, LuaStackArgsClass &args)
+	{
+		assert(Object);
+		assert(MemberFunction);
+		((*Object).*MemberFunction)(script, args);
+	}
+
+private:
+	MemberFunctionPtr		MemberFunction;
+	T *						Object;
+};
+
+/**
+ * Descriptor for a LuaUserVar stack member function.
+ */
+template <typename T>
+class LuaMemberStackFunctionDescriptor : public LuaMemberDescriptorClass
+{
+public:
+
+	typedef void (T::*MemberFunctionPtr)(LuaScriptClass *, LuaStackArgsClass &);
+
+	LuaMemberStackFunctionDescriptor(MemberFunctionPtr func) : 
+			LuaMemberDescriptorClass(false), MemberFunction(func) {}
+
+	virtual LuaUserVar *Bind(LuaUserVar *object) const
+	{
+		assert(object);
+		return new LuaMemberStackFunctionWrapper<T>(static_cast<T *>(object), MemberFunction);
+	}
+
+private:
+	MemberFunctionPtr		MemberFunction;
+};
+
 struct FunctionFixup
 {
 	FunctionFixup(LuaScriptClass *s, int p, void **var, SmartPtr<LuaVar> *sp) : 
@@ -49,12 +49,17 @@
 PG_IMPLEMENT_RTTI(LuaScriptWrapper, LuaUserVar);
 LUA_IMPLEMENT_FACTORY(LUA_CHUNK_LUA_SCRIPT_WRAPPER, LuaScriptWrapper);
 MEMORY_POOL_INSTANCE(LuaScriptWrapper, LUA_WRAPPER_POOL_SIZE);
+LUA_IMPLEMENT_MEMBER_TABLE(LuaScriptWrapper, LuaUserVar);
 
 LuaScriptWrapper::WrapperCacheType *LuaScriptWrapper::WrapperCache = NULL;
 
 LuaScriptWrapper::LuaScriptWrapper() :
 	Script(NULL),
 	Persistable(true)
+{
+}
+
+void LuaScriptWrapper::Register_Members(LuaMemberTableClass *table)
 {
 	LUA_REGISTER_MEMBER_FUNCTION(LuaScriptWrapper, "Is_Valid", &LuaScriptWrapper::Is_Valid);
 	LUA_REGISTER_MEMBER_FUNCTION_USE_MAPS(LuaScriptWrapper, "Call_Function", &LuaScriptWrapper::Call_Function);
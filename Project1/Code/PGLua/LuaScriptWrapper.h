@@ -55,6 +55,7 @@ class LuaScriptWrapper : public LuaUserVar, public SignalListenerClass, public P
 public:
 	PG_DECLARE_RTTI();
 	LUA_DECLARE_FACTORY(LUA_CHUNK_LUA_SCRIPT_WRAPPER, LuaScriptWrapper);
+	LUA_DECLARE_MEMBER_TABLE(LuaScriptWrapper);
 	LuaScriptWrapper();
 	~LuaScriptWrapper();
 
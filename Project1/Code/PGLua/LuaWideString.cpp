@@ -48,9 +48,14 @@
 PG_IMPLEMENT_RTTI(LuaWideString, LuaUserVar);
 //LUA_IMPLEMENT_FACTORY(LUA_CHUNK_LUA_SCRIPT_WRAPPER, LuaScriptClassWrapper);
 MEMORY_POOL_INSTANCE(LuaWideString, LUA_WRAPPER_POOL_SIZE);
+LUA_IMPLEMENT_MEMBER_TABLE(LuaWideString, LuaUserVar);
 
 LuaWideString::LuaWideString(std::wstring str) :
 	Value(str)
+{
+}
+
+void LuaWideString::Register_Members(LuaMemberTableClass *table)
 {
 	LUA_REGISTER_MEMBER_FUNCTION(LuaWideString, "append", &LuaWideString::Lua_Append);
 	LUA_REGISTER_MEMBER_FUNCTION(LuaWideString, "assign", &LuaWideString::Lua_Assign);
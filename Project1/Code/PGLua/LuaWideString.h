@@ -53,6 +53,7 @@ class LuaWideString : public LuaUserVar
 {
 public:
 	PG_DECLARE_RTTI();
+	LUA_DECLARE_MEMBER_TABLE(LuaWideString);
 	//LuaWideString();
 	LuaWideString::LuaWideString(std::wstring str);
 
@@ -48,6 +48,13 @@
 #include "GetEvent.h"
 #include "LuaScript.h"
 #include "LuaNetworkDebugger.h"
+#include <time.h>
+
+extern "C"
+{
+	#include "lua.h"
+	#include "lauxlib.h"
+}
 
 /**
  * Prints script messages from lua.
@@ -154,14 +161,9 @@ class LuaCreateThread : public LuaUserVar
 {
 public:
 	PG_DECLARE_RTTI();
+	LUA_DECLARE_MEMBER_TABLE(LuaCreateThread);
 	LuaCreateThread()
 	{
-		LUA_REGISTER_MEMBER_FUNCTION(LuaCreateThread, "Create", &LuaCreateThread::Function_Call);
-		LUA_REGISTER_MEMBER_FUNCTION(LuaCreateThread, "Get_Current_ID", &LuaCreateThread::Get_Current_ID);
-		LUA_REGISTER_MEMBER_FUNCTION(LuaCreateThread, "Get_Name", &LuaCreateThread::Get_Name);
-		LUA_REGISTER_MEMBER_FUNCTION(LuaCreateThread, "Kill", &LuaCreateThread::Kill);
-		LUA_REGISTER_MEMBER_FUNCTION(LuaCreateThread, "Kill_All", &LuaCreateThread::Kill_All);
-		LUA_REGISTER_MEMBER_FUNCTION(LuaCreateThread, "Is_Thread_Active", &LuaCreateThread::Is_Thread_Active);
 	}
 	virtual LuaTable* Get_Current_ID(LuaScriptClass *script, LuaTable *)
 	{
@@ -268,6 +270,17 @@ public:
 	}
 };
 PG_IMPLEMENT_RTTI(LuaCreateThread, LuaUserVar);
+LUA_IMPLEMENT_MEMBER_TABLE(LuaCreateThread, LuaUserVar);
+
+void LuaCreateThread::Register_Members(LuaMemberTableClass *table)
+{
+	LUA_REGISTER_MEMBER_FUNCTION(LuaCreateThread, "Create", &LuaCreateThread::Function_Call);
+	LUA_REGISTER_MEMBER_FUNCTION(LuaCreateThread, "Get_Current_ID", &LuaCreateThread::Get_Current_ID);
+	LUA_REGISTER_MEMBER_FUNCTION(LuaCreateThread, "Get_Name", &LuaCreateThread::Get_Name);
+	LUA_REGISTER_MEMBER_FUNCTION(LuaCreateThread, "Kill", &LuaCreateThread::Kill);
+	LUA_REGISTER_MEMBER_FUNCTION(LuaCreateThread, "Kill_All", &LuaCreateThread::Kill_All);
+	LUA_REGISTER_MEMBER_FUNCTION(LuaCreateThread, "Is_Thread_Active", &LuaCreateThread::Is_Thread_Active);
+}
 
 class LuaStringCompare : public LuaUserVar
 {
@@ -419,10 +432,9 @@ class GlobalValue : public LuaUserVar
 {
 public:
 	PG_DECLARE_RTTI();
+	LUA_DECLARE_MEMBER_TABLE(GlobalValue);
 	GlobalValue()
 	{
-		LUA_REGISTER_MEMBER_FUNCTION(GlobalValue, "Get", &GlobalValue::Get);
-		LUA_REGISTER_MEMBER_FUNCTION(GlobalValue, "Set", &GlobalValue::Set);
 	}
 
 	LuaTable* Get(LuaScriptClass *script, LuaTable *params)
@@ -472,6 +484,13 @@ public:
 
 };
 PG_IMPLEMENT_RTTI(GlobalValue, LuaUserVar);
+LUA_IMPLEMENT_MEMBER_TABLE(GlobalValue, LuaUserVar);
+
+void GlobalValue::Register_Members(LuaMemberTableClass *table)
+{
+	LUA_REGISTER_MEMBER_FUNCTION(GlobalValue, "Get", &GlobalValue::Get);
+	LUA_REGISTER_MEMBER_FUNCTION(GlobalValue, "Set", &GlobalValue::Set);
+}
 
 
 
@@ -480,11 +499,9 @@ class ThreadValue : public LuaUserVar
 public:
 	PG_DECLARE_RTTI();
 	LUA_DECLARE_FACTORY(LUA_CHUNK_THREAD_VALUE, ThreadValue);
+	LUA_DECLARE_MEMBER_TABLE(ThreadValue);
 	ThreadValue()
 	{
-		LUA_REGISTER_MEMBER_FUNCTION(ThreadValue, "Get", &ThreadValue::Get);
-		LUA_REGISTER_MEMBER_FUNCTION(ThreadValue, "Set", &ThreadValue::Set);
-		LUA_REGISTER_MEMBER_FUNCTION(ThreadValue, "Reset", &ThreadValue::Reset);
 	}
 	LuaTable* Get(LuaScriptClass *script, LuaTable *params)
 	{
@@ -631,6 +648,14 @@ private:
 };
 PG_IMPLEMENT_RTTI(ThreadValue, LuaUserVar);
 LUA_IMPLEMENT_FACTORY(LUA_CHUNK_THREAD_VALUE, ThreadValue);
+LUA_IMPLEMENT_MEMBER_TABLE(ThreadValue, LuaUserVar);
+
+void ThreadValue::Register_Members(LuaMemberTableClass *table)
+{
+	LUA_REGISTER_MEMBER_FUNCTION(ThreadValue, "Get", &ThreadValue::Get);
+	LUA_REGISTER_MEMBER_FUNCTION(ThreadValue, "Set", &ThreadValue::Set);
+	LUA_REGISTER_MEMBER_FUNCTION(ThreadValue, "Reset", &ThreadValue::Reset);
+}
 
 class LuaMessagePopup : public LuaUserVar
 {
@@ -666,6 +691,114 @@ public:
 };
 PG_IMPLEMENT_RTTI(LuaGetThreadID, LuaUserVar);
 
+#ifndef NDEBUG
+/**
+ * Debug only micro benchmark for Lua member access.  Times the old lookup,
+ * which built and hashed a std::string per access, against the interned
+ * string lookup Index_Function now uses, then times calling the member from
+ * Lua, which is what scripts actually pay for.  The member has to be callable
+ * with no arguments.
+ * 
+ * _BenchmarkMemberLookup(object, "Member_Name", iterations)
+ * 
+ * @return string lookup ms, interned lookup ms, Lua calls ms
+ */
+class LuaBenchmarkMemberLookup : public LuaUserVar
+{
+public:
+	PG_DECLARE_RTTI();
+
+	LuaTable *Function_Call(LuaScriptClass *script, LuaTable *params)
+	{
+		if (params->Value.size() < 2)
+		{
+			script->Script_Error("_BenchmarkMemberLookup -- Expected at least 2 parameters, got %d", params->Value.size());
+			return NULL;
+		}
+
+		LuaUserVar *object = PG_Dynamic_Cast<LuaUserVar>(params->Value[0]);
+		LuaString *name = PG_Dynamic_Cast<LuaString>(params->Value[1]);
+		if (!object || !name)
+		{
+			script->Script_Error("_BenchmarkMemberLookup -- Expected an object and a member name.");
+			return NULL;
+		}
+
+		int iterations = 100000;
+		if (params->Value.size() > 2)
+		{
+			LuaNumber *count = PG_Dynamic_Cast<LuaNumber>(params->Value[2]);
+			if (count) iterations = (int)count->Value;
+		}
+
+		LuaMemberTableReg::Build_Member_Tables();
+		LuaMemberTableClass *table = object->Get_Member_Table();
+		if (!table || !table->Find_Member(name->Value))
+		{
+			script->Script_Error("_BenchmarkMemberLookup -- %s has no member %s.", object->Get_To_String().c_str(), name->Value.c_str());
+			return NULL;
+		}
+
+		// Intern the name the same way the Lua VM hands it to Index_Function.
+		lua_State *L = script->Get_State();
+		int top = lua_gettop(L);
+		lua_pushlstring(L, name->Value.c_str(), name->Value.size());
+		int name_index = lua_gettop(L);
+		const char *symbol = lua_tostring(L, name_index);
+		size_t length = lua_strlen(L, name_index);
+
+		clock_t start = clock();
+		for (int i = 0; i < iterations; i++)
+		{
+			object->Get_Bound_Member(table->Find_Member(std::string(symbol, length)));
+		}
+		clock_t string_ticks = clock() - start;
+
+		start = clock();
+		for (int i = 0; i < iterations; i++)
+		{
+			object->Get_Bound_Member(table->Find_Member(L, name_index));
+		}
+		clock_t interned_ticks = clock() - start;
+
+		// Index and call the member from a Lua loop, through Index_Function.
+		std::string chunk = "return function(object, count) for i = 1, count do object." + name->Value + "() end end";
+		if (luaL_loadbuffer(L, chunk.c_str(), chunk.size(), "=_BenchmarkMemberLookup") != 0 || lua_pcall(L, 0, 1, 0) != 0)
+		{
+			script->Script_Error("_BenchmarkMemberLookup -- %s", lua_tostring(L, -1));
+			lua_settop(L, top);
+			return NULL;
+		}
+		LuaScriptClass::Map_Var_To_Lua(L, object);
+		lua_pushnumber(L, (lua_Number)iterations);
+		start = clock();
+		if (lua_pcall(L, 2, 0, 0) != 0)
+		{
+			script->Script_Error("_BenchmarkMemberLookup -- calling %s: %s", name->Value.c_str(), lua_tostring(L, -1));
+			lua_settop(L, top);
+			return NULL;
+		}
+		clock_t call_ticks = clock() - start;
+
+		lua_settop(L, top);
+
+		float string_ms = string_ticks * 1000.0f / CLOCKS_PER_SEC;
+		float interned_ms = interned_ticks * 1000.0f / CLOCKS_PER_SEC;
+		float call_ms = call_ticks * 1000.0f / CLOCKS_PER_SEC;
+		Debug_Printf("_BenchmarkMemberLookup %s.%s x %d: string lookup %.2fms, interned lookup %.2fms, Lua calls %.2fms (%.0f calls/s)\n", 
+			object->Get_To_String().c_str(), name->Value.c_str(), iterations, string_ms, interned_ms, call_ms,
+			call_ms > 0.0f ? iterations * 1000.0f / call_ms : 0.0f);
+
+		LuaTable *retval = Alloc_Lua_Table();
+		retval->Value.push_back(new LuaNumber(string_ms));
+		retval->Value.push_back(new LuaNumber(interned_ms));
+		retval->Value.push_back(new LuaNumber(call_ms));
+		return retval;
+	}
+};
+PG_IMPLEMENT_RTTI(LuaBenchmarkMemberLookup, LuaUserVar);
+#endif
+
 void UtilityCommandsClass::Register_Commands(LuaScriptClass *script)
 {
 	if (script->Pool_Is_Fresh_Load())
@@ -684,6 +817,9 @@ void UtilityCommandsClass::Register_Commands(LuaScriptClass *script)
 		script->Map_Global_To_Lua(new LuaCreateThread(), "Create_Thread");
 		script->Map_Global_To_Lua(new LuaCreateThread(), "Thread");
 		script->Map_Global_To_Lua(new LuaConsolePrint(), "lc");
+#ifndef NDEBUG
+		script->Map_Global_To_Lua(new LuaBenchmarkMemberLookup(), "_BenchmarkMemberLookup");
+#endif
 
 		LuaUserVar *hand = GetEvent::FactoryCreate();
 		script->Map_Global_To_Lua(hand, "GetEvent");
@@ -51,12 +51,17 @@
 PG_IMPLEMENT_RTTI(AITargetLocationWrapper, LuaUserVar);
 LUA_IMPLEMENT_FACTORY(LUA_CHUNK_AI_TARGET_LOCATION_WRAPPER, AITargetLocationWrapper);
 MEMORY_POOL_INSTANCE(AITargetLocationWrapper, LUA_WRAPPER_POOL_SIZE);
+LUA_IMPLEMENT_MEMBER_TABLE(AITargetLocationWrapper, LuaUserVar);
 
 AITargetLocationWrapper::WrapperCacheType *AITargetLocationWrapper::WrapperCache = NULL;
 
 AITargetLocationWrapper::AITargetLocationWrapper() :
 	Script(NULL),
 	Persistable(true)
+{
+}
+
+void AITargetLocationWrapper::Register_Members(LuaMemberTableClass *table)
 {
 	LUA_REGISTER_MEMBER_FUNCTION(AITargetLocationWrapper, "Get_Game_Object", &AITargetLocationWrapper::Get_Game_Object);
 	LUA_REGISTER_MEMBER_FUNCTION(AITargetLocationWrapper, "Is_Valid", &AITargetLocationWrapper::Is_Valid);
@@ -55,6 +55,7 @@ class AITargetLocationWrapper : public LuaUserVar, public SignalListenerClass, p
 public:
 	PG_DECLARE_RTTI();
 	LUA_DECLARE_FACTORY(LUA_CHUNK_AI_TARGET_LOCATION_WRAPPER, AITargetLocationWrapper);
+	LUA_DECLARE_MEMBER_TABLE(AITargetLocationWrapper);
 	AITargetLocationWrapper();
 	~AITargetLocationWrapper();
 
@@ -62,6 +62,7 @@ public:
 
 	void Init(LuaUserVar *command, PlanBehaviorClass *plan, float resources_to_wait_for, bool block_on_spendable);
 	virtual LuaTable *Is_Finished(LuaScriptClass *, LuaTable *);
+	virtual bool Poll_Finished(LuaScriptClass *script);
 	virtual LuaTable *Result(LuaScriptClass *, LuaTable *);
 	virtual bool Save(LuaScriptClass *script, ChunkWriterClass *writer);
 	virtual bool Load(LuaScriptClass *script, ChunkReaderClass *reader);
@@ -91,18 +92,23 @@ void BudgetBlockStatus::Init(LuaUserVar *command, PlanBehaviorClass *plan, float
 	BlockOnSpendable = block_on_spendable;
 }
 
-LuaTable *BudgetBlockStatus::Is_Finished(LuaScriptClass *, LuaTable *)
+bool BudgetBlockStatus::Poll_Finished(LuaScriptClass *)
 {
 	if (BlockOnSpendable)
 	{
-		return Return_Variable(new LuaBool(Plan->Get_Goal()->Get_Spendable_Resources() - ResourcesToWaitFor >= -FLOAT_EPSILON));
+		return Plan->Get_Goal()->Get_Spendable_Resources() - ResourcesToWaitFor >= -FLOAT_EPSILON;
 	}
 	else
 	{
-		return Return_Variable(new LuaBool(Plan->Get_Goal()->Get_Unallocated_Resource_Value() - ResourcesToWaitFor >= -FLOAT_EPSILON));
+		return Plan->Get_Goal()->Get_Unallocated_Resource_Value() - ResourcesToWaitFor >= -FLOAT_EPSILON;
 	}
 }
 
+LuaTable *BudgetBlockStatus::Is_Finished(LuaScriptClass *script, LuaTable *)
+{
+	return Return_Variable(new LuaBool(Poll_Finished(script)));
+}
+
 LuaTable *BudgetBlockStatus::Result(LuaScriptClass *, LuaTable *)
 {
 	return NULL;
@@ -112,9 +118,14 @@ LuaTable *BudgetBlockStatus::Result(LuaScriptClass *, LuaTable *)
 
 PG_IMPLEMENT_RTTI(BudgetWrapper, LuaUserVar);
 LUA_IMPLEMENT_FACTORY(LUA_CHUNK_BUDGET, BudgetWrapper);
+LUA_IMPLEMENT_MEMBER_TABLE(BudgetWrapper, LuaUserVar);
 
 BudgetWrapper::BudgetWrapper(PlanBehaviorClass *plan) :
 Plan(plan)
+{
+}
+
+void BudgetWrapper::Register_Members(LuaMemberTableClass *table)
 {
 	LUA_REGISTER_MEMBER_FUNCTION(BudgetWrapper, "Get_Unallocated_Resources", &BudgetWrapper::Get_Unallocated_Resources);
 	LUA_REGISTER_MEMBER_FUNCTION(BudgetWrapper, "Get_Spendable_Resources", &BudgetWrapper::Get_Spendable_Resources);
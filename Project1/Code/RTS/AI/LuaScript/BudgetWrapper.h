@@ -51,6 +51,7 @@ class BudgetWrapper : public LuaUserVar
 public:
 	PG_DECLARE_RTTI();
 	LUA_DECLARE_FACTORY(LUA_CHUNK_BUDGET, BudgetWrapper);
+	LUA_DECLARE_MEMBER_TABLE(BudgetWrapper);
 
 	BudgetWrapper(PlanBehaviorClass *plan = 0);
 
@@ -71,6 +71,10 @@ void AbilityBlockStatus::Receive_Signal(SignalGeneratorClass *generator, PGSigna
 	SignalDispatcherClass::Get().Remove_Listener(generator, this, PG_SIGNAL_OBJECT_ABILITY_FINISHED);
 	SignalDispatcherClass::Get().Remove_Listener(generator, this, PG_SIGNAL_OBJECT_DELETE_PENDING);
 	SignalDispatcherClass::Get().Remove_Listener(generator, this, PG_SIGNAL_OBJECT_MOVEMENT_CANCELED);
+	if (UnfinishedAbilityCount == 0)
+	{
+		Signal_Finished();
+	}
 }
 
 enum
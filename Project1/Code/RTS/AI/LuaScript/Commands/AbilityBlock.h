@@ -61,6 +61,8 @@ public:
 	void Init(LuaUserVar *command);
 	void Add_Object(GameObjectClass *object);
 	virtual LuaTable *Is_Finished(LuaScriptClass *, LuaTable *) { return Return_Variable(new LuaBool(UnfinishedAbilityCount == 0)); }
+	virtual bool Poll_Finished(LuaScriptClass *) { return UnfinishedAbilityCount == 0; }
+	virtual bool Signals_Completion(void) const { return true; }
 	virtual LuaTable *Result(LuaScriptClass *, LuaTable *) { return NULL; }
 
 	virtual bool Save(LuaScriptClass *script, ChunkWriterClass *writer);
@@ -72,6 +72,8 @@ public:
 
 	void Init(float value);
 	virtual LuaTable *Is_Finished(LuaScriptClass *, LuaTable *) { return Return_Variable(new LuaBool(false)); }
+	virtual bool Poll_Finished(LuaScriptClass *) { return false; }
+	virtual bool Signals_Completion(void) const { return true; }
 	virtual LuaTable *Result(LuaScriptClass *, LuaTable *) { return NULL; }
 
 	void Register_Evaluator_As_Marked(PerceptualEvaluatorClass *evaluator);
@@ -57,6 +57,7 @@ public:
 	void Init(GameObjectClass *planet, int base_level, bool ground);
 
 	virtual LuaTable *Is_Finished(LuaScriptClass *script, LuaTable *params);
+	virtual bool Poll_Finished(LuaScriptClass *script);
 
 	virtual bool Save(LuaScriptClass *script, ChunkWriterClass *writer);
 	virtual bool Load(LuaScriptClass *script, ChunkReaderClass *reader);
@@ -78,25 +79,30 @@ void BaseBlockStatus::Init(GameObjectClass *planet, int base_level, bool ground)
 	GroundBase = ground;
 }
 
-LuaTable *BaseBlockStatus::Is_Finished(LuaScriptClass *, LuaTable *)
+bool BaseBlockStatus::Poll_Finished(LuaScriptClass *)
 {
 	PlanetaryBehaviorClass *behave = static_cast<PlanetaryBehaviorClass*>(Planet->Get_Behavior(BEHAVIOR_PLANET));
 	if (GroundBase)
 	{
 		if (behave->Get_Current_Ground_Base_Level(Planet) >= BaseLevel)
 		{
-			return Return_Variable(new LuaBool(true));
+			return true;
 		}
 	}
 	else
 	{
 		if (behave->Get_Current_Starbase_Level(Planet) >= BaseLevel)
 		{
-			return Return_Variable(new LuaBool(true));
+			return true;
 		}
 	}
 
-	return Return_Variable(new LuaBool(false));
+	return false;
+}
+
+LuaTable *BaseBlockStatus::Is_Finished(LuaScriptClass *script, LuaTable *)
+{
+	return Return_Variable(new LuaBool(Poll_Finished(script)));
 }
 
 //    GameObjectClass *Planet;
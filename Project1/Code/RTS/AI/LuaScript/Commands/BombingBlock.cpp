@@ -134,6 +134,11 @@ void BombingBlockStatus::Receive_Signal(SignalGeneratorClass *gen, PGSignalType,
 	{
 		--SurvivingBomberCount;
 	}
+
+	if (ActiveBomberCount == 0)
+	{
+		Signal_Finished();
+	}
 }
 
 enum
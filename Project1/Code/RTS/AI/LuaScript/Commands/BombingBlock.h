@@ -60,6 +60,8 @@ public:
 
 	void Init(LuaUserVar *command, int player_id, const DynamicVectorClass<GameObjectClass*> &bombers);
 	virtual LuaTable *Is_Finished(LuaScriptClass *, LuaTable *);
+	virtual bool Poll_Finished(LuaScriptClass *) { return ActiveBomberCount == 0; }
+	virtual bool Signals_Completion(void) const { return true; }
 	virtual LuaTable *Result(LuaScriptClass *, LuaTable *);
 
 	virtual bool Save(LuaScriptClass *script, ChunkWriterClass *writer);
@@ -57,6 +57,7 @@
 #include "AI/LuaScript/AITargetLocationWrapper.h"
 #include "AI/AITargetLocation.h"
 #include "AI/Perception/PerceptionContext.h"
+#include "PerceptionBatch.h"
 
 PG_IMPLEMENT_RTTI(EvaluatePerceptionClass, LuaUserVar);
 
@@ -139,43 +140,30 @@ LuaTable *EvaluatePerceptionClass::Function_Call(LuaScriptClass *script, LuaTabl
 
 	AIPerceptionSystemClass *perception_system = tactical_manager->Get_Perception_System();
 
-	//Set up the context depending on exactly what we got passed
-	PerceptionContextClass context(perception_system);
-	context.Add_Context(PERCEPTION_TOKEN_VARIABLE_SELF, player->Get_Object()->Get_Evaluator_Token());
-	if (perception_system->Get_Manager()->Get_Enemy())
-	{
-		context.Add_Context(PERCEPTION_TOKEN_VARIABLE_ENEMY, perception_system->Get_Manager()->Get_Enemy()->Get_Evaluator_Token());
-	}
-	PlayerClass *human = PlayerList.Get_Human_Player();
-	if (human)
-	{
-		context.Add_Context(PERCEPTION_TOKEN_VARIABLE_HUMAN, human->Get_Evaluator_Token());
-	}
+	//Set up the context depending on exactly what we got passed.  The batch shares results with
+	//every other evaluation of the same question this frame.
+	PerceptionBatchClass batch(perception_system, player->Get_Object());
 	if (target_wrapper)
 	{
-		context.Add_Context(PERCEPTION_TOKEN_VARIABLE_TARGET, target_wrapper->Get_Object()->Get_Evaluator());
-		context.Set_Target(target_wrapper->Get_Object());
+		batch.Add_Target(target_wrapper->Get_Object());
 	}
 	else if (object_wrapper)
 	{
-		if (object_wrapper->Get_Object()->Behaves_Like(BEHAVIOR_PLANET))
-		{
-			context.Add_Context(PERCEPTION_TOKEN_VARIABLE_TARGET, object_wrapper->Get_Object()->Get_Planetary_Data()->Get_Evaluator_Token());
-		}
-		else
-		{
-			context.Add_Context(PERCEPTION_TOKEN_VARIABLE_TARGET, AIPerceptionSystemClass::Build_Game_Object_Token_String(object_wrapper->Get_Object()));
-		}
+		batch.Add_Object(object_wrapper->Get_Object());
+	}
+	else
+	{
+		batch.Add_No_Target();
 	}
 
-	context.Set_Player(player->Get_Object());
+	batch.Evaluate(function);
 
-	float result = 0.0;
-	if (!function->Evaluate(context, result))
+	const PerceptionCandidateStruct &candidate = batch.Get_Candidate(0);
+	if (!candidate.Evaluated)
 	{
 		script->Script_Error("Evaluate_Perception: Error evaluating perception function %s.", function->Get_Name().c_str());
 		return NULL;
 	}
 
-	return Return_Variable(new LuaNumber(static_cast<float>(result)));
+	return Return_Variable(new LuaNumber(static_cast<float>(candidate.Score)));
 }
\ No newline at end of file
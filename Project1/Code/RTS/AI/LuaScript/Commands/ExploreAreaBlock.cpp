@@ -112,7 +112,7 @@ void ExploreAreaBlockStatus::Init(LuaUserVar *command, const AITargetLocationCla
 }
 
 /**************************************************************************************************
-* ExploreAreaBlockStatus::Is_Finished -- Script function to determine whether this order is finished
+* ExploreAreaBlockStatus::Poll_Finished -- Determine whether this order is finished
 *	and update it if not.
 *
 * In:			
@@ -121,7 +121,7 @@ void ExploreAreaBlockStatus::Init(LuaUserVar *command, const AITargetLocationCla
 *
 * History: 9/22/2005 1:39PM JSY
 **************************************************************************************************/
-LuaTable *ExploreAreaBlockStatus::Is_Finished(LuaScriptClass *, LuaTable *)
+bool ExploreAreaBlockStatus::Poll_Finished(LuaScriptClass *)
 {
 	//May need a new move order
 	if (NeedsNewDestination)
@@ -129,7 +129,20 @@ LuaTable *ExploreAreaBlockStatus::Is_Finished(LuaScriptClass *, LuaTable *)
 		Move_To_New_Destination();
 	}
 
-	return Return_Variable(new LuaBool(IsFinished));
+	return IsFinished;
+}
+
+/**************************************************************************************************
+* ExploreAreaBlockStatus::Is_Finished -- Lua version of Poll_Finished
+*
+* In:			
+*
+* Out:		
+*
+**************************************************************************************************/
+LuaTable *ExploreAreaBlockStatus::Is_Finished(LuaScriptClass *script, LuaTable *)
+{
+	return Return_Variable(new LuaBool(Poll_Finished(script)));
 }
 
 /**************************************************************************************************
@@ -58,6 +58,7 @@ public:
 	~ExploreAreaBlockStatus();
 	void Init(LuaUserVar *command, const AITargetLocationClass *target);
 	virtual LuaTable *Is_Finished(LuaScriptClass *, LuaTable *);
+	virtual bool Poll_Finished(LuaScriptClass *script);
 
 	virtual bool Save(LuaScriptClass *script, ChunkWriterClass *writer);
 	virtual bool Load(LuaScriptClass *script, ChunkReaderClass *reader);
@@ -56,9 +56,9 @@ class LuaFOWCellsClass : public LuaUserVar
 public:
 	PG_DECLARE_RTTI();
 	LUA_DECLARE_FACTORY(LUA_CHUNK_FOW_CELLS, LuaFOWCellsClass);
+	LUA_DECLARE_MEMBER_TABLE(LuaFOWCellsClass);
 	LuaFOWCellsClass() : PlayerID(-1)
 	{ 
-		LUA_REGISTER_MEMBER_FUNCTION(LuaFOWCellsClass, "Undo_Reveal", &LuaFOWCellsClass::Undo_Reveal);
 	}
 
 	~LuaFOWCellsClass()
@@ -140,11 +140,22 @@ public:
 
 LUA_IMPLEMENT_FACTORY(LUA_CHUNK_FOW_CELLS, LuaFOWCellsClass);
 PG_IMPLEMENT_RTTI(LuaFOWCellsClass, LuaUserVar);
+LUA_IMPLEMENT_MEMBER_TABLE(LuaFOWCellsClass, LuaUserVar);
+
+void LuaFOWCellsClass::Register_Members(LuaMemberTableClass *table)
+{
+	LUA_REGISTER_MEMBER_FUNCTION(LuaFOWCellsClass, "Undo_Reveal", &LuaFOWCellsClass::Undo_Reveal);
+}
 
 
 PG_IMPLEMENT_RTTI(LuaFOWRevealCommandClass, LuaUserVar);
+LUA_IMPLEMENT_MEMBER_TABLE(LuaFOWRevealCommandClass, LuaUserVar);
 
 LuaFOWRevealCommandClass::LuaFOWRevealCommandClass()
+{
+}
+
+void LuaFOWRevealCommandClass::Register_Members(LuaMemberTableClass *table)
 {
 	LUA_REGISTER_MEMBER_FUNCTION(LuaFOWRevealCommandClass, "Reveal", &LuaFOWRevealCommandClass::Reveal);
 	LUA_REGISTER_MEMBER_FUNCTION(LuaFOWRevealCommandClass, "Reveal_All", &LuaFOWRevealCommandClass::Reveal_All);
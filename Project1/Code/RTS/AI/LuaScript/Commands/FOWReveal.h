@@ -49,6 +49,7 @@ class LuaFOWRevealCommandClass : public LuaUserVar
 {
 public:
 	PG_DECLARE_RTTI();
+	LUA_DECLARE_MEMBER_TABLE(LuaFOWRevealCommandClass);
 	LuaFOWRevealCommandClass();
 	virtual LuaTable* Function_Call(LuaScriptClass *script, LuaTable *params);
 	LuaTable *Disable_Rendering(LuaScriptClass *script, LuaTable *params);
@@ -47,9 +47,27 @@
 #include "AI/LuaScript/PositionWrapper.h"
 
 #include "FrameSynchronizer.h"
+#include <algorithm>
 
 PG_IMPLEMENT_RTTI(FindBestLocalThreatCenterClass, LuaUserVar);
 
+#ifndef NDEBUG
+//Random starting points of the last clustering, so the debug check can replay it without touching the random stream
+static std::vector<Vector2> CheckSeedCenters;
+#endif
+
+/**
+ * Orders objects by ID.  Used with a stable sort so the result is the
+ * same as the bubble sort it replaced.
+ */
+struct ThreatObjectIDLessStruct
+{
+	bool operator()(const GameObjectClass *left, const GameObjectClass *right) const
+	{
+		return left->Get_ID() < right->Get_ID();
+	}
+};
+
 /**************************************************************************************************
 * FindBestLocalThreatCenterClass::Function_Call -- script command to find the location at which to place a circle
 *	of fixed radius in order to cover a subset of the passed objects that generate the maximum threat.
@@ -105,18 +123,16 @@ LuaTable *FindBestLocalThreatCenterClass::Function_Call(LuaScriptClass *script,
 	}
 
 
+#ifndef NDEBUG
+	static std::vector<GameObjectClass*> unsorted_object_list;
+	unsorted_object_list = object_list;
+#endif
+
 	/*
 	** Well, I don't know what the heck is going on here but a mega-kludge seems to be in order. ST - 2/11/2006 3:38AM
+	** Sort by ID so every machine clusters the objects in the same order.
 	*/
-	for (unsigned int bub1=0 ; bub1 < object_list.size() ; bub1++) {
-		for (unsigned int bub2=0 ; bub2 < object_list.size() - 1 ; bub2++) {
-			if (object_list[bub2]->Get_ID() > object_list[bub2+1]->Get_ID()) {
-				GameObjectClass *temp = object_list[bub2];
-				object_list[bub2] = object_list[bub2 + 1];
-				object_list[bub2 + 1] = temp;
-			}
-		}
-	}
+	std::stable_sort(object_list.begin(), object_list.end(), ThreatObjectIDLessStruct());
 
 	FrameSynchronizerClass::Print_Sync_Message_No_Stack(SYNC_LOG_LUA_CRC, "FindBestLocalThreatCenterClass::Function_Call -- object_list.size() = %d, radius = %f\n", object_list.size(), radius->Value);
 	
@@ -126,10 +142,21 @@ LuaTable *FindBestLocalThreatCenterClass::Function_Call(LuaScriptClass *script,
 		return NULL;
 	}
 
+	//Pull positions and combat power out of the objects once
+	static ThreatListStruct threats;
+	threats.Resize(object_list.size());
+	for (unsigned int i = 0; i < object_list.size(); ++i)
+	{
+		const Vector3 &position = object_list[i]->Get_Position();
+		threats.X[i] = position.X;
+		threats.Y[i] = position.Y;
+		threats.Power[i] = object_list[i]->Get_Company_Type()->Get_AI_Combat_Power_Metric();
+	}
+
 	//Take a guess at good center points by doing clustering 
 	static std::vector<Vector2> cluster_centers;
 	cluster_centers.resize(0);
-	Find_Clusters(cluster_centers, object_list);
+	Find_Clusters(cluster_centers, threats);
 
 	FrameSynchronizerClass::Print_Sync_Message_No_Stack(SYNC_LOG_LUA_CRC, "FindBestLocalThreatCenterClass::Function_Call -- cluster_centers.size() = %d\n", cluster_centers.size());
 
@@ -139,15 +166,7 @@ LuaTable *FindBestLocalThreatCenterClass::Function_Call(LuaScriptClass *script,
 	float best_score = 0.0f;
 	for (unsigned int i = 0; i < cluster_centers.size(); ++i)
 	{
-		float score = 0.0f;
-		for (unsigned int j = 0; j < object_list.size(); ++j)
-		{
-			if ((object_list[j]->Get_Position().Project_XY() - cluster_centers[i]).Length2() <= radius2)
-			{
-				score += object_list[j]->Get_Company_Type()->Get_AI_Combat_Power_Metric();
-			}
-		}
-
+		float score = Score_Center(threats, cluster_centers[i], radius2);
 		if (score >= best_score)
 		{
 			best_center = cluster_centers[i];
@@ -157,6 +176,10 @@ LuaTable *FindBestLocalThreatCenterClass::Function_Call(LuaScriptClass *script,
 
 	FrameSynchronizerClass::Print_Sync_Message_No_Stack(SYNC_LOG_LUA_CRC, "FindBestLocalThreatCenterClass::Function_Call -- best_score = %f\n", best_score);
 
+#ifndef NDEBUG
+	Check_Result(unsorted_object_list, radius2, cluster_centers, best_center, best_score);
+#endif
+
 	if (best_score <= 0.0f)
 	{
 		return NULL;
@@ -170,6 +193,35 @@ LuaTable *FindBestLocalThreatCenterClass::Function_Call(LuaScriptClass *script,
 	}
 }
 
+/**************************************************************************************************
+* FindBestLocalThreatCenterClass::Score_Center -- Total the combat power of the objects within the
+*	radius of a center.  The sum runs in object order so the result is identical on every machine.
+*
+* In:				
+*
+* Out:		
+*
+**************************************************************************************************/
+float FindBestLocalThreatCenterClass::Score_Center(const ThreatListStruct &threats, const Vector2 &center, float radius2)
+{
+	const float *x = &threats.X[0];
+	const float *y = &threats.Y[0];
+	const float *power = &threats.Power[0];
+	unsigned int count = threats.Size();
+
+	float score = 0.0f;
+	for (unsigned int j = 0; j < count; ++j)
+	{
+		float dx = x[j] - center.X;
+		float dy = y[j] - center.Y;
+		if (dx * dx + dy * dy <= radius2)
+		{
+			score += power[j];
+		}
+	}
+	return score;
+}
+
 /**************************************************************************************************
 * FindBestLocalThreatCenterClass::Find_Clusters -- Split objects up into a set of clusters and report back
 *	the cluster centers.
@@ -180,14 +232,17 @@ LuaTable *FindBestLocalThreatCenterClass::Function_Call(LuaScriptClass *script,
 *
 * History: 11/9/2005 3:58PM JSY
 **************************************************************************************************/
-void FindBestLocalThreatCenterClass::Find_Clusters(std::vector<Vector2> &clusters, const std::vector<GameObjectClass*> &object_list)
+void FindBestLocalThreatCenterClass::Find_Clusters(std::vector<Vector2> &clusters, const ThreatListStruct &threats)
 {
 	static const unsigned int BUCKET_DIVISOR = 4;
 	static const int ITERATION_COUNT = 5;
 	static const unsigned int MAX_CLUSTERS = 10;
 
 	//Scale the number of clusters to the total number of objects but don't let it get too big.
-	unsigned int num_clusters = (object_list.size() + BUCKET_DIVISOR - 1) / BUCKET_DIVISOR;
+	const float *x = &threats.X[0];
+	const float *y = &threats.Y[0];
+	unsigned int object_count = threats.Size();
+	unsigned int num_clusters = (object_count + BUCKET_DIVISOR - 1) / BUCKET_DIVISOR;
 	num_clusters = Min(num_clusters, MAX_CLUSTERS);
 
 	//If we're only going to generate one cluster then just go with the centroid since it's what the
@@ -195,12 +250,15 @@ void FindBestLocalThreatCenterClass::Find_Clusters(std::vector<Vector2> &cluster
 	if (num_clusters <= 1)
 	{
 		Vector2 centroid = Vector2(0.0f, 0.0f);
-		for (unsigned int i = 0; i < object_list.size(); ++i)
+		for (unsigned int i = 0; i < object_count; ++i)
 		{
-			centroid += object_list[i]->Get_Position().Project_XY();
+			centroid += Vector2(x[i], y[i]);
 		}
-		centroid /= static_cast<float>(object_list.size());
+		centroid /= static_cast<float>(object_count);
 		clusters.push_back(centroid);
+#ifndef NDEBUG
+		CheckSeedCenters.resize(0);
+#endif
 		return;
 	}
 
@@ -210,13 +268,13 @@ void FindBestLocalThreatCenterClass::Find_Clusters(std::vector<Vector2> &cluster
 	float x_max = -BIG_FLOAT;
 	float y_min = BIG_FLOAT;
 	float y_max = -BIG_FLOAT;
-	for (unsigned int i = 0; i < object_list.size(); ++i)
+	for (unsigned int i = 0; i < object_count; ++i)
 	{
-		x_max = Max(x_max, object_list[i]->Get_Position().X);
-		x_min = Min(x_min, object_list[i]->Get_Position().X);
+		x_max = Max(x_max, x[i]);
+		x_min = Min(x_min, x[i]);
 		//y_max = Max(x_max, object_list[i]->Get_Position().Y);	ST - 2/11/2006 3:38AM
-		y_max = Max(y_max, object_list[i]->Get_Position().Y);
-		y_min = Min(y_min, object_list[i]->Get_Position().Y);
+		y_max = Max(y_max, y[i]);
+		y_min = Min(y_min, y[i]);
 	}
 
 	FrameSynchronizerClass::Print_Sync_Message_No_Stack(SYNC_LOG_LUA_CRC, "FindBestLocalThreatCenterClass::Find_Clusters -- clusters.size() = %d\n", clusters.size());
@@ -226,9 +284,13 @@ void FindBestLocalThreatCenterClass::Find_Clusters(std::vector<Vector2> &cluster
 		clusters[i] = Vector2(Get_Random_Uniform_Float(x_min, x_max), Get_Random_Uniform_Float(y_min, y_max));
 	}
 
+#ifndef NDEBUG
+	CheckSeedCenters = clusters;
+#endif
+
 	static std::vector<unsigned int> bucket_assignments;
 	static std::vector<float> normalization_factors;
-	bucket_assignments.resize(object_list.size());
+	bucket_assignments.resize(object_count);
 	normalization_factors.resize(clusters.size());
 
 	/*
@@ -244,12 +306,14 @@ void FindBestLocalThreatCenterClass::Find_Clusters(std::vector<Vector2> &cluster
 	for (int i = 0; i < ITERATION_COUNT; ++i)
 	{
 		//Assign each object to a cluster
-		for (unsigned int object_index = 0; object_index < object_list.size(); ++object_index)
+		for (unsigned int object_index = 0; object_index < object_count; ++object_index)
 		{
 			float best_distance2 = BIG_FLOAT;
 			for (unsigned int cluster_index = 0; cluster_index < clusters.size(); ++cluster_index)
 			{
-				float distance2 = (object_list[object_index]->Get_Position().Project_XY() - clusters[cluster_index]).Length2();
+				float dx = x[object_index] - clusters[cluster_index].X;
+				float dy = y[object_index] - clusters[cluster_index].Y;
+				float distance2 = dx * dx + dy * dy;
 				if (distance2 < best_distance2)
 				{
 					bucket_assignments[object_index] = cluster_index;
@@ -265,7 +329,7 @@ void FindBestLocalThreatCenterClass::Find_Clusters(std::vector<Vector2> &cluster
 		}
 
 		//Move the cluster point to the centroid of the objects that have been assigned to it.
-		for (unsigned int object_index = 0; object_index < object_list.size(); ++object_index)
+		for (unsigned int object_index = 0; object_index < object_count; ++object_index)
 		{
 			unsigned int cluster_index = bucket_assignments[object_index];
 			if (normalization_factors[cluster_index] == 0.0f)
@@ -273,7 +337,7 @@ void FindBestLocalThreatCenterClass::Find_Clusters(std::vector<Vector2> &cluster
 				clusters[cluster_index] = Vector2(0.0f, 0.0f);
 			}
 
-			clusters[cluster_index] += object_list[object_index]->Get_Position().Project_XY();
+			clusters[cluster_index] += Vector2(x[object_index], y[object_index]);
 			++normalization_factors[cluster_index];
 		}
 
@@ -290,3 +354,126 @@ void FindBestLocalThreatCenterClass::Find_Clusters(std::vector<Vector2> &cluster
 		FrameSynchronizerClass::Print_Sync_Message_No_Stack(SYNC_LOG_LUA_CRC, "FindBestLocalThreatCenterClass::Find_Clusters -- returning cluster %f, %f\n", clusters[c].X, clusters[c].Y);
 	}
 }
+
+#ifndef NDEBUG
+/**************************************************************************************************
+* FindBestLocalThreatCenterClass::Check_Result -- Debug check that the sorted, flat array version
+*	picks the same cluster centers, best center and score as the original bubble sort and object walk.
+*	The clustering is replayed from the same random starting points.
+*
+* In:				objects as passed in (before sorting), squared radius, results to check
+*
+* Out:		
+*
+**************************************************************************************************/
+void FindBestLocalThreatCenterClass::Check_Result(const std::vector<GameObjectClass*> &unsorted_object_list, float radius2,
+																  const std::vector<Vector2> &cluster_centers, const Vector2 &best_center, float best_score)
+{
+	static const unsigned int BUCKET_DIVISOR = 4;
+	static const int ITERATION_COUNT = 5;
+	static const unsigned int MAX_CLUSTERS = 10;
+
+	std::vector<GameObjectClass*> object_list = unsorted_object_list;
+	for (unsigned int bub1=0 ; bub1 < object_list.size() ; bub1++) {
+		for (unsigned int bub2=0 ; bub2 < object_list.size() - 1 ; bub2++) {
+			if (object_list[bub2]->Get_ID() > object_list[bub2+1]->Get_ID()) {
+				GameObjectClass *temp = object_list[bub2];
+				object_list[bub2] = object_list[bub2 + 1];
+				object_list[bub2 + 1] = temp;
+			}
+		}
+	}
+
+	std::vector<Vector2> clusters;
+	unsigned int num_clusters = (object_list.size() + BUCKET_DIVISOR - 1) / BUCKET_DIVISOR;
+	num_clusters = Min(num_clusters, MAX_CLUSTERS);
+	if (num_clusters <= 1)
+	{
+		Vector2 centroid = Vector2(0.0f, 0.0f);
+		for (unsigned int i = 0; i < object_list.size(); ++i)
+		{
+			centroid += object_list[i]->Get_Position().Project_XY();
+		}
+		centroid /= static_cast<float>(object_list.size());
+		clusters.push_back(centroid);
+	}
+	else
+	{
+		assert(CheckSeedCenters.size() == num_clusters);
+		clusters = CheckSeedCenters;
+
+		std::vector<unsigned int> bucket_assignments(object_list.size(), 0);
+		std::vector<float> normalization_factors(clusters.size());
+		for (int i = 0; i < ITERATION_COUNT; ++i)
+		{
+			for (unsigned int object_index = 0; object_index < object_list.size(); ++object_index)
+			{
+				float best_distance2 = BIG_FLOAT;
+				for (unsigned int cluster_index = 0; cluster_index < clusters.size(); ++cluster_index)
+				{
+					float distance2 = (object_list[object_index]->Get_Position().Project_XY() - clusters[cluster_index]).Length2();
+					if (distance2 < best_distance2)
+					{
+						bucket_assignments[object_index] = cluster_index;
+						best_distance2 = distance2;
+					}
+				}
+			}
+
+			for (unsigned int cluster_index = 0; cluster_index < clusters.size(); ++cluster_index)
+			{
+				normalization_factors[cluster_index] = 0.0f;
+			}
+
+			for (unsigned int object_index = 0; object_index < object_list.size(); ++object_index)
+			{
+				unsigned int cluster_index = bucket_assignments[object_index];
+				if (normalization_factors[cluster_index] == 0.0f)
+				{
+					clusters[cluster_index] = Vector2(0.0f, 0.0f);
+				}
+
+				clusters[cluster_index] += object_list[object_index]->Get_Position().Project_XY();
+				++normalization_factors[cluster_index];
+			}
+
+			for (unsigned int cluster_index = 0; cluster_index < clusters.size(); ++cluster_index)
+			{
+				if (normalization_factors[cluster_index] > 0.0f)
+				{
+					clusters[cluster_index] /= normalization_factors[cluster_index];
+				}
+			}
+		}
+	}
+
+	assert(clusters.size() == cluster_centers.size());
+	for (unsigned int i = 0; i < clusters.size(); ++i)
+	{
+		assert(clusters[i].X == cluster_centers[i].X && clusters[i].Y == cluster_centers[i].Y);
+	}
+
+	Vector2 object_best_center = Vector2(0.0f, 0.0f);
+	float object_best_score = 0.0f;
+	for (unsigned int i = 0; i < clusters.size(); ++i)
+	{
+		float score = 0.0f;
+		for (unsigned int j = 0; j < object_list.size(); ++j)
+		{
+			if ((object_list[j]->Get_Position().Project_XY() - clusters[i]).Length2() <= radius2)
+			{
+				score += object_list[j]->Get_Company_Type()->Get_AI_Combat_Power_Metric();
+			}
+		}
+
+		if (score >= object_best_score)
+		{
+			object_best_center = clusters[i];
+			object_best_score = score;
+		}
+	}
+
+	assert(object_best_score == best_score);
+	assert(object_best_center.X == best_center.X && object_best_center.Y == best_center.Y);
+}
+#endif
@@ -51,7 +51,28 @@ public:
 	virtual LuaTable *Function_Call(LuaScriptClass *script, LuaTable *params);
 
 private:
-	void Find_Clusters(std::vector<Vector2> &clusters, const std::vector<GameObjectClass*> &object_list);
+
+	/**
+	 * Positions and combat power of the objects, pulled out once so the
+	 * clustering and scoring loops run over flat arrays.
+	 */
+	struct ThreatListStruct
+	{
+		void Resize(unsigned int count) { X.resize(count); Y.resize(count); Power.resize(count); }
+		unsigned int Size(void) const { return X.size(); }
+
+		std::vector<float>	X;
+		std::vector<float>	Y;
+		std::vector<float>	Power;
+	};
+
+	void Find_Clusters(std::vector<Vector2> &clusters, const ThreatListStruct &threats);
+	static float Score_Center(const ThreatListStruct &threats, const Vector2 &center, float radius2);
+
+#ifndef NDEBUG
+	static void Check_Result(const std::vector<GameObjectClass*> &unsorted_object_list, float radius2,
+									 const std::vector<Vector2> &cluster_centers, const Vector2 &best_center, float best_score);
+#endif
 };
 
 #endif //_FIND_BEST_LOCAL_THREAT_CENTER_H_
\ No newline at end of file
@@ -58,15 +58,302 @@
 #include "DynamicEnum.h"
 #include "AI/Movement/ObjectTrackingSystem.h"
 #include "GameObjectManager.h"
+#include "GameModeManager.h"
+#include "AI/ObjectSetStamp.h"
+#include "AI/LuaScript/LuaRTSBinding.h"
 
 PG_IMPLEMENT_RTTI(FindNearestClass, LuaUserVar);
 PG_IMPLEMENT_RTTI(FindNearestSpaceFieldClass, LuaUserVar);
 
+LUA_BIND_FUNCTION_CALL(FindNearestSpaceFieldClass, "Find_Nearest_Space_Field", &FindNearestSpaceFieldClass::Find_Nearest_Space_Field);
+
+/**
+ * Uniform XY grid over the perception grid's complete object lists, used
+ * by Find_Nearest to search outward from a position instead of measuring
+ * every object.  Each cell keeps the union of its objects' category and
+ * property masks so cells without a possible match are skipped whole.
+ * 
+ * The grid is a snapshot rebuilt on the first query after the mode, the
+ * frame or the object count changes.  Objects are checked against the
+ * object manager by ID before use, and distances are measured from their
+ * current positions.
+ */
+class NearestObjectGridClass
+{
+public:
+
+	enum { MAX_RESULTS = 64 };
+
+	struct ResultStruct
+	{
+		float								Distance2;
+		int								Sequence;
+		GameObjectClass				*Object;
+	};
+
+	static NearestObjectGridClass &Get(void) { static NearestObjectGridClass grid; return grid; }
+
+	void Find_Nearest(const Vector3 &from_position, GameObjectClass *exclude_object, const GameObjectTypeClass *filter_type,
+		GameObjectPropertiesType property_filter, GameObjectCategoryType category_filter, PlayerClass *allegiance_player,
+		bool match_allegiance, int count, std::vector<ResultStruct> &results);
+
+private:
+
+	NearestObjectGridClass() : MinX(0), MinY(0), MaxX(-1), MaxY(-1) {}
+
+	struct EntryStruct
+	{
+		GameObjectClass				*Object;
+		ObjectIDType					ID;
+		int								PlayerIndex;
+		int								Sequence;		// Position in the order the object lists are walked, breaks distance ties.
+	};
+
+	struct CellStruct
+	{
+		CellStruct() : CategoryMask(0), PropertyMask(0) {}
+		std::vector<EntryStruct>	Entries;
+		unsigned int					CategoryMask;
+		unsigned int					PropertyMask;
+	};
+
+	typedef stdext::hash_map<int, CellStruct> CellListType;
+
+	static int Get_Cell_Coord(float value) { return (int)floorf(value / CELL_SIZE); }
+	static int Get_Cell_Key(int x, int y) { return (int)(((unsigned int)y << 16) ^ ((unsigned int)x & 0xffff)); }
+	void Update(void);
+	void Search_Cell(int x, int y, const Vector3 &from_position, GameObjectClass *exclude_object, const GameObjectTypeClass *filter_type,
+		GameObjectPropertiesType property_filter, GameObjectCategoryType category_filter, PlayerClass *allegiance_player,
+		const std::vector<bool> &player_allowed, int count, std::vector<ResultStruct> &results);
+
+	static const float				CELL_SIZE;
+
+	ObjectSetStampClass				Stamp;
+	int									MinX;
+	int									MinY;
+	int									MaxX;
+	int									MaxY;
+	CellListType						Cells;
+};
+
+const float NearestObjectGridClass::CELL_SIZE = 500.0f;
+
+/**
+ * Rebuild the grid if the active mode, the frame or the number of objects
+ * has changed since it was built.
+ */
+void NearestObjectGridClass::Update(void)
+{
+	if (!Stamp.Refresh())
+	{
+		return;
+	}
+
+	Cells.clear();
+	MinX = MinY = 0;
+	MaxX = MaxY = -1;
+
+	int sequence = 0;
+	for (int i = 0; i < PlayerList.Get_Num_Players(); ++i)
+	{
+		PlayerClass *player = PlayerList.Get_Player_By_Index(i);
+		if (!player || player->Is_Neutral())
+		{
+			continue;
+		}
+
+		MultiLinkedListIterator<GameObjectClass> it(AIPerceptionSystemClass::Get_Perception_Grid()->Get_Complete_Object_List(i));
+		for (; !it.Is_Done(); it.Next())
+		{
+			GameObjectClass *object = it.Current_Object();
+			const Vector3 &position = object->Get_Position();
+			int x = Get_Cell_Coord(position.X);
+			int y = Get_Cell_Coord(position.Y);
+			if (MaxX < MinX)
+			{
+				MinX = MaxX = x;
+				MinY = MaxY = y;
+			}
+			else
+			{
+				MinX = min(MinX, x);
+				MaxX = max(MaxX, x);
+				MinY = min(MinY, y);
+				MaxY = max(MaxY, y);
+			}
+
+			EntryStruct entry;
+			entry.Object = object;
+			entry.ID = object->Get_ID();
+			entry.PlayerIndex = i;
+			entry.Sequence = sequence++;
+
+			CellStruct &cell = Cells[Get_Cell_Key(x, y)];
+			cell.Entries.push_back(entry);
+			cell.CategoryMask |= (unsigned int)object->Get_Original_Object_Type()->Get_Category_Mask();
+			cell.PropertyMask |= (unsigned int)object->Get_Original_Object_Type()->Get_Property_Mask();
+		}
+	}
+}
+
+/**
+ * Test the objects of one cell and merge the matches into the results,
+ * which are kept sorted by distance and then by walk order.
+ */
+void NearestObjectGridClass::Search_Cell(int x, int y, const Vector3 &from_position, GameObjectClass *exclude_object, const GameObjectTypeClass *filter_type,
+	GameObjectPropertiesType property_filter, GameObjectCategoryType category_filter, PlayerClass *allegiance_player,
+	const std::vector<bool> &player_allowed, int count, std::vector<ResultStruct> &results)
+{
+	CellListType::iterator cit = Cells.find(Get_Cell_Key(x, y));
+	if (cit == Cells.end())
+	{
+		return;
+	}
+
+	CellStruct &cell = cit->second;
+	if ((category_filter & cell.CategoryMask) == 0)
+	{
+		return;
+	}
+	if (property_filter != GAME_OBJECT_PROPERTIES_ALL && (property_filter & cell.PropertyMask) == 0)
+	{
+		return;
+	}
+
+	for (int i = 0; i < (int)cell.Entries.size(); ++i)
+	{
+		const EntryStruct &entry = cell.Entries[i];
+		if (!player_allowed[entry.PlayerIndex])
+		{
+			continue;
+		}
+
+		GameObjectClass *object = entry.Object;
+		if (GAME_OBJECT_MANAGER.Get_Object_From_ID(entry.ID) != object)
+		{
+			continue;
+		}
+
+		if (object->Is_Dead())
+		{
+			continue;
+		}
+
+		if (object == exclude_object)
+		{
+			continue;
+		}
+
+		if (filter_type && object->Get_Original_Object_Type() != filter_type)
+		{
+			continue;
+		}
+
+		if (property_filter != GAME_OBJECT_PROPERTIES_ALL && (property_filter & object->Get_Original_Object_Type()->Get_Property_Mask()) == 0)
+		{
+			continue;
+		}
+
+		if ((category_filter & object->Get_Original_Object_Type()->Get_Category_Mask()) == 0)
+		{
+			continue;
+		}
+
+		float distance2 = (object->Get_Position() - from_position).Length2();
+		if ((int)results.size() == count &&
+			 (distance2 > results.back().Distance2 || (distance2 == results.back().Distance2 && entry.Sequence > results.back().Sequence)))
+		{
+			continue;
+		}
+
+		if (allegiance_player && GameModeManager.Get_Active_Mode()->Is_Fogged(allegiance_player->Get_ID(), object, true))
+		{
+			continue;
+		}
+
+		ResultStruct result;
+		result.Distance2 = distance2;
+		result.Sequence = entry.Sequence;
+		result.Object = object;
+
+		int slot = (int)results.size();
+		while (slot > 0 && (results[slot - 1].Distance2 > distance2 ||
+				 (results[slot - 1].Distance2 == distance2 && results[slot - 1].Sequence > entry.Sequence)))
+		{
+			--slot;
+		}
+		results.insert(results.begin() + slot, result);
+		if ((int)results.size() > count)
+		{
+			results.pop_back();
+		}
+	}
+}
+
+/**
+ * Find the nearest objects to a position that pass the Find_Nearest
+ * filters.  Rings of cells are searched outward from the position until
+ * the results are full and no object in the next ring can be closer.
+ * Ties are broken by the order the object lists are walked in, so the
+ * nearest match is the same object a walk of every list picks.
+ * 
+ * @param results  filled with up to count matches, nearest first
+ */
+void NearestObjectGridClass::Find_Nearest(const Vector3 &from_position, GameObjectClass *exclude_object, const GameObjectTypeClass *filter_type,
+	GameObjectPropertiesType property_filter, GameObjectCategoryType category_filter, PlayerClass *allegiance_player,
+	bool match_allegiance, int count, std::vector<ResultStruct> &results)
+{
+	results.resize(0);
+	Update();
+	if (MaxX < MinX || count <= 0)
+	{
+		return;
+	}
+
+	std::vector<bool> player_allowed(PlayerList.Get_Num_Players(), true);
+	for (int i = 0; i < PlayerList.Get_Num_Players(); ++i)
+	{
+		PlayerClass *player = PlayerList.Get_Player_By_Index(i);
+		if (player && allegiance_player && player->Is_Ally(allegiance_player) != match_allegiance)
+		{
+			player_allowed[i] = false;
+		}
+	}
+
+	int cx = Get_Cell_Coord(from_position.X);
+	int cy = Get_Cell_Coord(from_position.Y);
+	int max_ring = max(max(abs(cx - MinX), abs(MaxX - cx)), max(abs(cy - MinY), abs(MaxY - cy)));
+
+	for (int ring = 0; ring <= max_ring; ++ring)
+	{
+		// Every point of this ring is at least this far away in XY, and so in 3D.
+		float ring_distance = (ring - 1) * CELL_SIZE;
+		if (ring > 1 && (int)results.size() == count && results.back().Distance2 < ring_distance * ring_distance)
+		{
+			break;
+		}
+
+		for (int y = cy - ring; y <= cy + ring; ++y)
+		{
+			if (y < MinY || y > MaxY) continue;
+
+			bool edge_row = (y == cy - ring || y == cy + ring);
+			int step = edge_row ? 1 : max(2 * ring, 1);
+			for (int x = cx - ring; x <= cx + ring; x += step)
+			{
+				if (x < MinX || x > MaxX) continue;
+				Search_Cell(x, y, from_position, exclude_object, filter_type, property_filter, category_filter,
+					allegiance_player, player_allowed, count, results);
+			}
+		}
+	}
+}
+
 LuaTable *FindNearestClass::Function_Call(LuaScriptClass *script, LuaTable *params)
 {
-	if (params->Value.size() < 1 || params->Value.size() > 4)
+	if (params->Value.size() < 1 || params->Value.size() > 5)
 	{
-		script->Script_Error("Find_Nearest - invalid number of parameters.  Expected between 1 and 4, got %d.", params->Value.size());
+		script->Script_Error("Find_Nearest - invalid number of parameters.  Expected between 1 and 5, got %d.", params->Value.size());
 		return 0;
 	}
 
@@ -151,83 +438,46 @@ LuaTable *FindNearestClass::Function_Call(LuaScriptClass *script, LuaTable *para
 		}
 	}
 
-	GameObjectClass *best_object = 0;
-	float min_distance2 = BIG_FLOAT;
-
-	for (int i = 0; i < PlayerList.Get_Num_Players(); ++i)
+	// An optional trailing count asks for a table of the count nearest objects.
+	int count = 0;
+	if (params->Value.size() > 1)
 	{
-		PlayerClass *player = PlayerList.Get_Player_By_Index(i);
-		if (!player)
-		{
-			continue;
-		}
-
-		if (player->Is_Neutral())
-		{
-			continue;
-		}
-
-
-		if (allegiance_player && player->Is_Ally(allegiance_player) != match_allegiance)
-		{
-			continue;
-		}
-
-		MultiLinkedListIterator<GameObjectClass> it(AIPerceptionSystemClass::Get_Perception_Grid()->Get_Complete_Object_List(i));
-		
-		for (; !it.Is_Done(); it.Next())
+		SmartPtr<LuaNumber> lua_count = PG_Dynamic_Cast<LuaNumber>(params->Value.back());
+		if (lua_count)
 		{
-			GameObjectClass *object = it.Current_Object();
-
-			if (object->Is_Dead())
-			{
-				continue;
-			}
-
-			if (object == exclude_object)
-			{
-				continue;
-			}
-
-			if (filter_type && object->Get_Original_Object_Type() != filter_type)
+			count = (int)lua_count->Value;
+			if (count < 1 || count > NearestObjectGridClass::MAX_RESULTS)
 			{
-				continue;
-			}
-
-			if (property_filter != GAME_OBJECT_PROPERTIES_ALL && (property_filter & object->Get_Original_Object_Type()->Get_Property_Mask()) == 0)
-			{
-				continue;
-			}
-
-			if ((category_filter & object->Get_Original_Object_Type()->Get_Category_Mask()) == 0)
-			{
-				continue;
+				script->Script_Error("Find_Nearest - result count %d is out of range.  Expected 1 to %d.", count, NearestObjectGridClass::MAX_RESULTS);
+				return 0;
 			}
+		}
+	}
 
-			if (allegiance_player && GameModeManager.Get_Active_Mode()->Is_Fogged(allegiance_player->Get_ID(), object, true))
-			{
-				continue;
-			}
+	static std::vector<NearestObjectGridClass::ResultStruct> results;
+	NearestObjectGridClass::Get().Find_Nearest(from_position, exclude_object, filter_type, property_filter, category_filter,
+		allegiance_player, match_allegiance, max(count, 1), results);
 
-			float distance2 = (object->Get_Position() - from_position).Length2();
-			if (distance2 < min_distance2)
-			{
-				min_distance2 = distance2;
-				best_object = object;
-			}
+	if (count > 0)
+	{
+		LuaTable::Pointer table = Alloc_Lua_Table();
+		for (int i = 0; i < (int)results.size(); ++i)
+		{
+			table->Value.push_back(GameObjectWrapper::Create(results[i].Object, script));
 		}
+		return Return_Variable(table);
 	}
 
-	if (best_object)
+	if (!results.empty())
 	{
-		return Return_Variable(GameObjectWrapper::Create(best_object, script));
+		return Return_Variable(GameObjectWrapper::Create(results[0].Object, script));
 	}
 
 	return 0;
 }
 
 /**************************************************************************************************
-* FindNearestSpaceFieldClass::Function_Call -- Script function to find the nearst asteroid field,
+* FindNearestSpaceFieldClass::Find_Nearest_Space_Field -- Script function to find the nearst asteroid field,
 *	nebula or ion storm.
 *
 * In:			
@@ -236,7 +486,7 @@ LuaTable *FindNearestClass::Function_Call(LuaScriptClass *script, LuaTable *para
 *
 * History: 8/31/2005 9:53AM JSY
 **************************************************************************************************/
-LuaTable *FindNearestSpaceFieldClass::Function_Call(LuaScriptClass *script, LuaTable *params)
+GameObjectClass *FindNearestSpaceFieldClass::Find_Nearest_Space_Field(LuaScriptClass *script, Vector3 source_position, LuaOptionalArg<std::string> field_type)
 {
 	if (GameModeManager.Get_Sub_Type() != SUB_GAME_MODE_SPACE)
 	{
@@ -244,34 +494,13 @@ LuaTable *FindNearestSpaceFieldClass::Function_Call(LuaScriptClass *script, LuaT
 		return NULL;
 	}
 
-	if (params->Value.size() < 1 || params->Value.size() > 2)
-	{
-		script->Script_Error("Find_Nearest_Space_Field -- invalid number of paraneters.  Expected 1 or 21, got %d.", params->Value.size());
-		return NULL;
-	}
-
-	//First parameter is position we must be nearest to
-	Vector3 source_position;
-	if (!Lua_Extract_Position(params->Value[0], source_position))
-	{
-		script->Script_Error("Find_Nearest_Space_Field -- could not deduce source position from parameter 1");
-		return NULL;
-	}
-
 	//Optional 2nd parameter is collision mask for field types to find.
 	SpaceCollisionType space_field_mask = static_cast<SpaceCollisionType>(SCT_ASTEROID_FIELD | SCT_ION_STORM | SCT_NEBULA);
-	if (params->Value.size() == 2)
+	if (field_type.Is_Set())
 	{
-		SmartPtr<LuaString> collision_string = PG_Dynamic_Cast<LuaString>(params->Value[1]);
-		if (!collision_string)
-		{
-			script->Script_Error("Find_Nearest_Space_Field -- invalid type for parameter 2.  Expected string.");
-			return NULL;
-		}
-
-		if (!TheSpaceCollisionTypeConverterPtr->String_To_Enum(collision_string->Value, space_field_mask))
+		if (!TheSpaceCollisionTypeConverterPtr->String_To_Enum(field_type.Get(), space_field_mask))
 		{
-			script->Script_Error("Find_Nearest_Space_Field -- unknown field type %s.", collision_string->Value.c_str());
+			script->Script_Error("Find_Nearest_Space_Field -- unknown field type %s.", field_type.Get().c_str());
 			return NULL;
 		}
 	}
@@ -307,12 +536,5 @@ LuaTable *FindNearestSpaceFieldClass::Function_Call(LuaScriptClass *script, LuaT
 		}
 	}
 
-	if (best_object)
-	{
-		return Return_Variable(GameObjectWrapper::Create(best_object, script));
-	}
-	else
-	{
-		return NULL;
-	}
+	return best_object;
 }
\ No newline at end of file
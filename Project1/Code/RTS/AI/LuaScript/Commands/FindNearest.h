@@ -44,6 +44,7 @@
 #define _FIND_NEAREST_H_
 
 #include "AI/LuaScript/LuaRTSUtilities.h"
+#include "LuaBinding.h"
 
 
 class FindNearestClass : public LuaUserVar
@@ -61,8 +62,9 @@ class FindNearestSpaceFieldClass : public LuaUserVar
 public:
 
 	PG_DECLARE_RTTI();
+	LUA_DECLARE_BOUND_FUNCTION_CALL();
 
-	virtual LuaTable *Function_Call(LuaScriptClass *script, LuaTable *params);
+	GameObjectClass *Find_Nearest_Space_Field(LuaScriptClass *script, Vector3 source_position, LuaOptionalArg<std::string> field_type);
 };
 
 #endif //_FIND_NEAREST_H_
\ No newline at end of file
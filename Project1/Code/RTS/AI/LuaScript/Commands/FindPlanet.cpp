@@ -50,9 +50,14 @@
 
 
 PG_IMPLEMENT_RTTI(FindPlanetClass, LuaUserVar);
+LUA_IMPLEMENT_MEMBER_TABLE(FindPlanetClass, LuaUserVar);
 
 
 FindPlanetClass::FindPlanetClass()
+{
+}
+
+void FindPlanetClass::Register_Members(LuaMemberTableClass *table)
 {
 	LUA_REGISTER_MEMBER_FUNCTION(FindPlanetClass, "Get_All_Planets", &FindPlanetClass::Get_All_Planets);
 }
@@ -51,6 +51,7 @@ class FindPlanetClass : public LuaUserVar
 {
 public:
 	PG_DECLARE_RTTI();
+	LUA_DECLARE_MEMBER_TABLE(FindPlanetClass);
 
 	FindPlanetClass();
 
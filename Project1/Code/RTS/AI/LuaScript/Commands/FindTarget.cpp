@@ -51,6 +51,7 @@
 #include "AI/AITargetLocation.h"
 #include "AI/Perception/AIPerceptionSystem.h"
 #include "AI/Perception/PerceptionContext.h"
+#include "PerceptionBatch.h"
 #include "PerceptionFunction.h"
 #include "AI/Planning/AIPlanningSystem.h"
 #include "AI/Planning/TaskForce.h"
@@ -64,14 +65,346 @@
 #include "EnumConversion.h"
 #include "AI/Goal/AIGoalReachabilityType.h"
 #include "AI/Goal/AIGoalSystem.h"
+#include "GameObjectManager.h"
+#include "PlanetaryBehavior.h"
+#include "PlayerList.h"
+#include "AI/ObjectSetStamp.h"
+#include "PGSignal/SignalListener.h"
+#include "PGSignal/SignalDispatcher.h"
+#include <map>
+#include <set>
 
 PG_IMPLEMENT_RTTI(FindTargetClass, LuaUserVar);
+LUA_IMPLEMENT_MEMBER_TABLE(FindTargetClass, LuaUserVar);
+
+/**
+ * Answers whether a target can be reached from a source, so that each plan
+ * calling Reachable_Target doesn't pay a full cost search per target.
+ * 
+ * With the friendly ignoring threat and the any reachability types the
+ * goal targets are planets, the lanes run both ways and passability only
+ * depends on who owns each planet.  Reachability is then the same as
+ * sitting in the same connected component of the lane graph, and the
+ * components are kept as a union find per type.  A search that succeeds
+ * merges the components of its two ends, one that fails marks the two
+ * components as separate, and after that every pair drawn from them is
+ * answered without a search.  The components only change when a planet
+ * changes hands or goes away, and the planet can be anywhere along the
+ * path, so the cache listens for those signals on every planet of the
+ * galactic mode and drops all components when one arrives, or when the
+ * galactic mode itself is replaced.
+ * 
+ * The other types weigh threat or let the destination be hostile when the
+ * path may not be, so reachability isn't transitive for them.  Their
+ * answers are kept per (source, target, type) until the frame or the set
+ * of objects changes.
+ */
+class TargetReachabilityCacheClass : public SignalListenerClass
+{
+public:
+
+	TargetReachabilityCacheClass() : WatchedMode(NULL) {}
+
+	bool Is_Reachable(const AITargetLocationClass *source, const AITargetLocationClass *target, AIGoalReachabilityType reachability_type);
+	virtual void Receive_Signal(SignalGeneratorClass *generator, PGSignalType signal_type, SignalDataClass *data);
+
+	static bool Search(const AITargetLocationClass *source, const AITargetLocationClass *target, AIGoalReachabilityType reachability_type);
+
+private:
+
+	enum
+	{
+		COMPONENT_FRIENDLY_IGNORE_THREAT,
+		COMPONENT_ANY,
+		COMPONENT_SET_COUNT
+	};
+
+	typedef std::pair<int, int> RootPairType;
+	typedef stdext::hash_map<const AITargetLocationClass *, int> NodeMapType;
+
+	struct ComponentSetStruct
+	{
+		NodeMapType						Nodes;
+		std::vector<int>				Parent;
+		std::set<RootPairType>		Separated;
+	};
+
+	struct KeyStruct
+	{
+		const AITargetLocationClass	*Source;
+		const AITargetLocationClass	*Target;
+		AIGoalReachabilityType			Type;
+
+		bool operator<(const KeyStruct &other) const
+		{
+			if (Source != other.Source) return Source < other.Source;
+			if (Target != other.Target) return Target < other.Target;
+			return Type < other.Type;
+		}
+	};
+
+	typedef std::map<KeyStruct, bool> ReachableMapType;
+	typedef stdext::hash_map<GameObjectClass *, ObjectIDType> WatchedMapType;
+
+	static int Get_Component_Set(AIGoalReachabilityType reachability_type);
+	static RootPairType Make_Root_Pair(int root_a, int root_b) { return root_a < root_b ? RootPairType(root_a, root_b) : RootPairType(root_b, root_a); }
+	static int Find_Root(ComponentSetStruct &set, int node);
+	static void Merge(ComponentSetStruct &set, int root_a, int root_b);
+	int Find_Node(ComponentSetStruct &set, const AITargetLocationClass *location);
+	void Watch_Object(GameObjectClass *object);
+	void Watch_Planets(GameModeClass *galactic_mode);
+	void Drop_Components(void);
+
+	ComponentSetStruct				Components[COMPONENT_SET_COUNT];
+	WatchedMapType						Watched;
+	GameModeClass						*WatchedMode;			//!< Galactic mode the components and the watched planets belong to
+	ReachableMapType					Reachable;
+	ObjectSetStampClass				ReachableStamp;
+};
+
+static TargetReachabilityCacheClass TargetReachabilityCache;
+
+/**
+ * @return the component set for a reachability type, -1 if the type isn't
+ *         transitive and has no components
+ */
+int TargetReachabilityCacheClass::Get_Component_Set(AIGoalReachabilityType reachability_type)
+{
+	switch (reachability_type)
+	{
+	case GOAL_REACHABILITY_FRIENDLY_IGNORE_THREAT:
+		return COMPONENT_FRIENDLY_IGNORE_THREAT;
+
+	case GOAL_REACHABILITY_ANY:
+		return COMPONENT_ANY;
+
+	default:
+		return -1;
+	}
+}
+
+/**
+ * The full cost search the cache stands in for.
+ */
+bool TargetReachabilityCacheClass::Search(const AITargetLocationClass *source, const AITargetLocationClass *target, AIGoalReachabilityType reachability_type)
+{
+	return target->Get_Target_Reachability()->Get_Cost_To_Target(const_cast<AITargetLocationClass *>(source), reachability_type, NULL) != BIG_FLOAT;
+}
+
+int TargetReachabilityCacheClass::Find_Root(ComponentSetStruct &set, int node)
+{
+	while (set.Parent[node] != node)
+	{
+		set.Parent[node] = set.Parent[set.Parent[node]];
+		node = set.Parent[node];
+	}
+	return node;
+}
+
+/**
+ * Join two components.  Separations recorded against the component that
+ * goes away now apply to the one that stays.
+ */
+void TargetReachabilityCacheClass::Merge(ComponentSetStruct &set, int root_a, int root_b)
+{
+	set.Parent[root_b] = root_a;
+
+	std::vector<int> separated_roots;
+	std::set<RootPairType>::iterator it = set.Separated.begin();
+	while (it != set.Separated.end())
+	{
+		if (it->first == root_b || it->second == root_b)
+		{
+			separated_roots.push_back(it->first == root_b ? it->second : it->first);
+			set.Separated.erase(it++);
+		}
+		else
+		{
+			++it;
+		}
+	}
+
+	for (unsigned int i = 0; i < separated_roots.size(); ++i)
+	{
+		set.Separated.insert(Make_Root_Pair(root_a, separated_roots[i]));
+	}
+}
+
+/**
+ * Look up the node of a location, adding it in a component of its own the
+ * first time it's seen.  The location's object is watched from then on, in
+ * case it isn't one of the planets.
+ */
+int TargetReachabilityCacheClass::Find_Node(ComponentSetStruct &set, const AITargetLocationClass *location)
+{
+	NodeMapType::const_iterator it = set.Nodes.find(location);
+	if (it != set.Nodes.end())
+	{
+		return it->second;
+	}
+
+	int node = (int)set.Parent.size();
+	set.Parent.push_back(node);
+	set.Nodes[location] = node;
+
+	Watch_Object(location->Get_Target_Game_Object());
+	return node;
+}
+
+void TargetReachabilityCacheClass::Watch_Object(GameObjectClass *object)
+{
+	if (object && !object->Is_Delete_Pending() && Watched.find(object) == Watched.end())
+	{
+		Watched[object] = object->Get_ID();
+		SignalDispatcherClass::Get().Add_Listener(object, this, PG_SIGNAL_OBJECT_OWNER_CHANGED);
+		SignalDispatcherClass::Get().Add_Listener(object, this, PG_SIGNAL_OBJECT_DELETE_PENDING);
+	}
+}
+
+/**
+ * Listen to every planet of the galactic mode.  A planet in the middle of a
+ * path changing hands can join or split components it has no node in.
+ */
+void TargetReachabilityCacheClass::Watch_Planets(GameModeClass *galactic_mode)
+{
+	WatchedMode = galactic_mode;
+
+	const DynamicVectorClass<GameObjectClass *> *planets = galactic_mode->Get_Object_Manager().Find_Objects(BEHAVIOR_PLANET);
+	for (int i = 0; planets && i < planets->Size(); ++i)
+	{
+		Watch_Object(planets->Get_At(i));
+	}
+}
+
+/**
+ * Forget every component and stop listening to the watched objects.  The
+ * listeners are only removed while the galactic mode they were added in is
+ * still around.
+ */
+void TargetReachabilityCacheClass::Drop_Components(void)
+{
+	if (WatchedMode && WatchedMode == GameModeManager.Get_Game_Mode_By_Sub_Type(SUB_GAME_MODE_GALACTIC))
+	{
+		WatchedMapType::iterator it = Watched.begin();
+		for (; it != Watched.end(); ++it)
+		{
+			if (WatchedMode->Get_Object_Manager().Get_Object_From_ID(it->second) == it->first)
+			{
+				SignalDispatcherClass::Get().Remove_Listener(it->first, this, PG_SIGNAL_OBJECT_OWNER_CHANGED);
+				SignalDispatcherClass::Get().Remove_Listener(it->first, this, PG_SIGNAL_OBJECT_DELETE_PENDING);
+			}
+		}
+	}
+	Watched.clear();
+	WatchedMode = NULL;
+
+	for (int i = 0; i < COMPONENT_SET_COUNT; ++i)
+	{
+		Components[i].Nodes.clear();
+		Components[i].Parent.resize(0);
+		Components[i].Separated.clear();
+	}
+}
+
+/**
+ * A watched planet changed hands or is going away, so the lanes that can
+ * be used have changed.
+ */
+void TargetReachabilityCacheClass::Receive_Signal(SignalGeneratorClass *generator, PGSignalType signal_type, SignalDataClass *)
+{
+	if (signal_type == PG_SIGNAL_OBJECT_OWNER_CHANGED || signal_type == PG_SIGNAL_OBJECT_DELETE_PENDING)
+	{
+		SignalDispatcherClass::Get().Remove_Listener(generator, this, PG_SIGNAL_OBJECT_OWNER_CHANGED);
+		SignalDispatcherClass::Get().Remove_Listener(generator, this, PG_SIGNAL_OBJECT_DELETE_PENDING);
+		Watched.erase(static_cast<GameObjectClass *>(generator));
+		Drop_Components();
+	}
+}
+
+/**
+ * Can the target be reached from the source?
+ * 
+ * @param source            where the plan starts from
+ * @param target            goal target to reach
+ * @param reachability_type rules the path has to follow
+ * @return true if the target can be reached
+ */
+bool TargetReachabilityCacheClass::Is_Reachable(const AITargetLocationClass *source, const AITargetLocationClass *target, AIGoalReachabilityType reachability_type)
+{
+	int component_set = Get_Component_Set(reachability_type);
+	if (component_set >= 0)
+	{
+		GameModeClass *galactic_mode = GameModeManager.Get_Game_Mode_By_Sub_Type(SUB_GAME_MODE_GALACTIC);
+		if (galactic_mode == NULL)
+		{
+			return Search(source, target, reachability_type);
+		}
+
+		if (WatchedMode != galactic_mode)
+		{
+			Drop_Components();
+			Watch_Planets(galactic_mode);
+		}
+
+		ComponentSetStruct &set = Components[component_set];
+		int source_root = Find_Root(set, Find_Node(set, source));
+		int target_root = Find_Root(set, Find_Node(set, target));
+		if (source_root == target_root)
+		{
+			return true;
+		}
+
+		RootPairType roots = Make_Root_Pair(source_root, target_root);
+		if (set.Separated.find(roots) != set.Separated.end())
+		{
+			return false;
+		}
+
+		bool reachable = Search(source, target, reachability_type);
+		if (reachable)
+		{
+			Merge(set, source_root, target_root);
+		}
+		else
+		{
+			set.Separated.insert(roots);
+		}
+		return reachable;
+	}
+
+	if (ReachableStamp.Refresh())
+	{
+		Reachable.clear();
+	}
+
+	KeyStruct key;
+	key.Source = source;
+	key.Target = target;
+	key.Type = reachability_type;
+
+	ReachableMapType::const_iterator it = Reachable.find(key);
+	if (it != Reachable.end())
+	{
+		return it->second;
+	}
+
+	bool reachable = Search(source, target, reachability_type);
+	Reachable[key] = reachable;
+	return reachable;
+}
 
 
 FindTargetClass::FindTargetClass()
+{
+}
+
+void FindTargetClass::Register_Members(LuaMemberTableClass *table)
 {
 	LUA_REGISTER_MEMBER_FUNCTION(FindTargetClass, "Reachable_Target", &FindTargetClass::Reachable_Target);
 	LUA_REGISTER_MEMBER_FUNCTION(FindTargetClass, "Best_Of", &FindTargetClass::Best_Of);
+#ifndef NDEBUG
+	LUA_REGISTER_MEMBER_FUNCTION(FindTargetClass, "_Check_Reachability", &FindTargetClass::Check_Reachability);
+#endif
 }
 
 LuaTable *FindTargetClass::Reachable_Target(LuaScriptClass *script, LuaTable *params)
@@ -260,19 +593,8 @@ LuaTable *FindTargetClass::Reachable_Target(LuaScriptClass *script, LuaTable *pa
 	// get the list of goal targets
 	const AIPerceptionSystemClass::GoalTargetVectorType &target_vector = perception_system->Get_Goal_Target_List();
 
-	PerceptionTokenType self_token = player->Get_Object()->Get_Evaluator_Token();
-	PerceptionTokenType enemy_token = PERCEPTION_TOKEN_INVALID;
-	PerceptionTokenType human_token = PERCEPTION_TOKEN_INVALID;
-	if (perception_system->Get_Manager()->Get_Enemy())
-	{
-		enemy_token = perception_system->Get_Manager()->Get_Enemy()->Get_Evaluator_Token();
-	}
-	PlayerClass *human = PlayerList.Get_Human_Player();
-	if (human)
-	{
-		human_token = human->Get_Evaluator_Token();
-	}
-
+	// Gather the targets that pass the cheap tests, then score them all in one batch
+	PerceptionBatchClass batch(perception_system, player->Get_Object());
 	for (unsigned int i = 0; i < target_vector.size(); ++i)
 	{
 		const AITargetLocationClass *target = target_vector[i];
@@ -282,41 +604,34 @@ LuaTable *FindTargetClass::Reachable_Target(LuaScriptClass *script, LuaTable *pa
 		if (!target->Matches_Application_Type(application_type, player->Get_Object()->Get_AI_Player()))
 			continue;
 
-		// Test target reachability...
-		if (target->Get_Target_Reachability() && source)
+		if (max_distance > 0)
 		{
-			if (target->Get_Target_Reachability()->Get_Cost_To_Target(source, reachability_type, NULL) == BIG_FLOAT)
+			if ((source->Get_Target_Position() - target->Get_Target_Position()).Length2() > max_distance)
+			{
 				continue;
+			}
 		}
 
-		// perceptual setup for evaluation
-		PerceptionContextClass perception_context(perception_system);
-		perception_context.Add_Context(PERCEPTION_TOKEN_VARIABLE_SELF, self_token);
-		if (enemy_token != PERCEPTION_TOKEN_INVALID)
-		{
-			perception_context.Add_Context(PERCEPTION_TOKEN_VARIABLE_ENEMY, enemy_token);
-		}
-		if (human_token != PERCEPTION_TOKEN_INVALID)
+		// Test target reachability last, it's the expensive one
+		if (target->Get_Target_Reachability() && source)
 		{
-			perception_context.Add_Context(PERCEPTION_TOKEN_VARIABLE_HUMAN, human_token);
+			if (!TargetReachabilityCache.Is_Reachable(source, target, reachability_type))
+				continue;
 		}
-		perception_context.Add_Context(PERCEPTION_TOKEN_VARIABLE_TARGET, target->Get_Evaluator());
-		perception_context.Set_Target(target);
-		perception_context.Set_Player(player->Get_Object());
 
-		// compute a desire value for this (goal, location) pair
-		float desire = 0;
+		batch.Add_Target(target);
+	}
+
+	batch.Evaluate(function);
 
-		if (!function->Evaluate(perception_context, desire))
+	for (unsigned int i = 0; i < batch.Get_Count(); ++i)
+	{
+		const PerceptionCandidateStruct &candidate = batch.Get_Candidate(i);
+		if (!candidate.Evaluated)
 			continue;
 
-		if (max_distance > 0)
-		{
-			if ((source->Get_Target_Position() - target->Get_Target_Position()).Length2() > max_distance)
-			{
-				continue;
-			}
-		}
+		const AITargetLocationClass *target = candidate.Target;
+		float desire = candidate.Score;
 
 		// Always track the best option.  Also hang on to
 		// other possible targets that meet the minimum desire requirement.
@@ -395,48 +710,16 @@ LuaTable *FindTargetClass::Function_Call(LuaScriptClass *script, LuaTable *param
 	const AIPerceptionSystemClass::GoalTargetVectorType &target_vector = perception_system->Get_Goal_Target_List();
 
 	PlayerClass *self = taskforce->Get_Plan()->Get_Player();
-	PerceptionTokenType self_token = self->Get_Evaluator_Token();
-	PerceptionTokenType enemy_token = PERCEPTION_TOKEN_INVALID;
-	PerceptionTokenType human_token = PERCEPTION_TOKEN_INVALID;
-	if (perception_system->Get_Manager()->Get_Enemy())
-	{
-		enemy_token = perception_system->Get_Manager()->Get_Enemy()->Get_Evaluator_Token();
-	}
-	PlayerClass *human = PlayerList.Get_Human_Player();
-	if (human)
-	{
-		human_token = human->Get_Evaluator_Token();
-	}
 
+	// Gather the targets that pass the cheap tests, then score them all in one batch
+	PerceptionBatchClass batch(perception_system, self);
 	for (unsigned int i = 0; i < target_vector.size(); ++i)
 	{
 		const AITargetLocationClass *target = target_vector[i];
 		assert(target);
 		
 		// does the goal type of this function match the target's properties?
-		if (!target->Matches_Application_Type(application_type, taskforce->Get_Plan()->Get_Player()->Get_AI_Player()))
-			continue;
-		
-		// perceptual setup for evaluation
-		PerceptionContextClass perception_context(perception_system);
-		perception_context.Add_Context(PERCEPTION_TOKEN_VARIABLE_SELF, self_token);
-		if (enemy_token != PERCEPTION_TOKEN_INVALID)
-		{
-			perception_context.Add_Context(PERCEPTION_TOKEN_VARIABLE_ENEMY, enemy_token);
-		}
-		if (human_token != PERCEPTION_TOKEN_INVALID)
-		{
-			perception_context.Add_Context(PERCEPTION_TOKEN_VARIABLE_HUMAN, human_token);
-		}
-		perception_context.Add_Context(PERCEPTION_TOKEN_VARIABLE_TARGET, target->Get_Evaluator());
-
-		perception_context.Set_Target(target);
-		perception_context.Set_Player(self);
-		
-		// compute a desire value for this (goal, location) pair
-		float desire = 0;
-		
-		if (!function->Evaluate(perception_context, desire))
+		if (!target->Matches_Application_Type(application_type, self->Get_AI_Player()))
 			continue;
 
 		if (max_distance > 0)
@@ -447,6 +730,20 @@ LuaTable *FindTargetClass::Function_Call(LuaScriptClass *script, LuaTable *param
 			}
 		}
 
+		batch.Add_Target(target);
+	}
+
+	batch.Evaluate(function);
+
+	for (unsigned int i = 0; i < batch.Get_Count(); ++i)
+	{
+		const PerceptionCandidateStruct &candidate = batch.Get_Candidate(i);
+		if (!candidate.Evaluated)
+			continue;
+
+		const AITargetLocationClass *target = candidate.Target;
+		float desire = candidate.Score;
+
 		// Always track the best option.  Also hang on to
 		// other possible targets that meet the minimum desire requirement.
 		if (desire > best_desire)
@@ -645,54 +942,23 @@ LuaTable *FindTargetClass::Best_Of(LuaScriptClass *script, LuaTable *params)
 	TacticalAIManagerClass *tactical_manager = tf->Get_Plan()->Get_Planning_System()->Get_Manager();
 	AIPerceptionSystemClass *perception_system = tactical_manager->Get_Perception_System();
 	PlayerClass *player = tf->Get_Plan()->Get_Player();
-	PerceptionTokenType self_token = player->Get_Evaluator_Token();
-	PerceptionTokenType enemy_token = PERCEPTION_TOKEN_INVALID;
-	PerceptionTokenType human_token = PERCEPTION_TOKEN_INVALID;
-	if (perception_system->Get_Manager()->Get_Enemy())
-	{
-		enemy_token = perception_system->Get_Manager()->Get_Enemy()->Get_Evaluator_Token();
-	}
-	PlayerClass *human = PlayerList.Get_Human_Player();
-	if (human)
-	{
-		human_token = human->Get_Evaluator_Token();
-	}
 
-	float best_score = 0.0f;
-	int best_index = -1;
+	//Remember which list entry each candidate came from so the winner can be handed back
+	PerceptionBatchClass batch(perception_system, player);
+	static std::vector<unsigned int> list_indices;
+	list_indices.resize(0);
 	for (unsigned int i = 0; i < target_list->Value.size(); ++i)
 	{
-		PerceptionContextClass perception_context(perception_system);
-		perception_context.Add_Context(PERCEPTION_TOKEN_VARIABLE_SELF, self_token);
-		if (enemy_token != PERCEPTION_TOKEN_INVALID)
-		{
-			perception_context.Add_Context(PERCEPTION_TOKEN_VARIABLE_ENEMY, enemy_token);
-		}
-		if (human_token != PERCEPTION_TOKEN_INVALID)
-		{
-			perception_context.Add_Context(PERCEPTION_TOKEN_VARIABLE_HUMAN, human_token);
-		}
-		perception_context.Set_Player(player);
 		SmartPtr<GameObjectWrapper> object_wrapper = PG_Dynamic_Cast<GameObjectWrapper>(target_list->Value[i]);
 		SmartPtr<AITargetLocationWrapper> ai_target_wrapper = PG_Dynamic_Cast<AITargetLocationWrapper>(target_list->Value[i]);
 
 		if (object_wrapper)
 		{
-			GameObjectClass *object_target = object_wrapper->Get_Object();
-			if (!object_wrapper->Get_Object())
+			if (!batch.Add_Object(object_wrapper->Get_Object()))
 			{
 				script->Script_Warning("Find_Best_OF -- target in target list is already dead.");
 				continue;
 			}
-
-			if (object_target->Behaves_Like(BEHAVIOR_PLANET))
-			{
-				perception_context.Add_Context(PERCEPTION_TOKEN_VARIABLE_TARGET, object_target->Get_Planetary_Data()->Get_Evaluator_Token());
-			}
-			else
-			{
-				perception_context.Add_Context(PERCEPTION_TOKEN_VARIABLE_TARGET, AIPerceptionSystemClass::Build_Game_Object_Token_String(object_target));
-			}
 		}
 		else if (ai_target_wrapper)
 		{
@@ -702,8 +968,7 @@ LuaTable *FindTargetClass::Best_Of(LuaScriptClass *script, LuaTable *params)
 				continue;
 			}
 
-			perception_context.Add_Context(PERCEPTION_TOKEN_VARIABLE_TARGET, ai_target_wrapper->Get_Object()->Get_Evaluator());
-			perception_context.Set_Target(ai_target_wrapper->Get_Object());
+			batch.Add_Target(ai_target_wrapper->Get_Object());
 		}
 		else
 		{
@@ -711,22 +976,128 @@ LuaTable *FindTargetClass::Best_Of(LuaScriptClass *script, LuaTable *params)
 			continue;
 		}
 
-		float score = 0.0f;
-		perception->Evaluate(perception_context, score);
-
-		if (score > best_score)
-		{
-			best_score = score;
-			best_index = static_cast<int>(i);
-		}
+		list_indices.push_back(i);
 	}
 
+	batch.Evaluate(perception);
+
+	int best_index = batch.Get_Best_Index();
 	if (best_index == -1)
 	{
 		return 0;
 	}
 	else
 	{
-		return Return_Variable(target_list->Value[best_index]);
+		return Return_Variable(target_list->Value[list_indices[best_index]]);
+	}
+}
+
+#ifndef NDEBUG
+/**
+ * Ask the cache and the full search the same question.
+ * 
+ * @param matched set false if the two answers differ
+ * @return the full search's answer
+ */
+static bool Check_Cached_Reachability(const AITargetLocationClass *source, const AITargetLocationClass *target, AIGoalReachabilityType reachability_type, bool &matched)
+{
+	bool cached = TargetReachabilityCache.Is_Reachable(source, target, reachability_type);
+	bool searched = TargetReachabilityCacheClass::Search(source, target, reachability_type);
+	if (cached != searched)
+	{
+		matched = false;
+	}
+	return searched;
+}
+
+/**
+ * Debug only check of the reachability components against a planet changing
+ * hands in the middle of a path.  For each transitive reachability type the
+ * cache and the full search are asked from source to target, the middle
+ * planet is given to another player and both are asked again, then the
+ * planet is given back and both are asked a third time.  Every cached answer
+ * has to match the search.
+ * 
+ * FindTarget._Check_Reachability(player, source, target, middle_planet, other_player)
+ * 
+ * @return true if giving the middle planet away changed the answer
+ */
+LuaTable *FindTargetClass::Check_Reachability(LuaScriptClass *script, LuaTable *params)
+{
+	if (params->Value.size() != 5)
+	{
+		script->Script_Error("FindTarget._Check_Reachability -- Invalid number of parameters: expected 5, got %d.", params->Value.size());
+		return NULL;
+	}
+
+	SmartPtr<PlayerWrapper> player = LUA_SAFE_CAST(PlayerWrapper, params->Value[0]);
+	SmartPtr<GameObjectWrapper> source_wrapper = LUA_SAFE_CAST(GameObjectWrapper, params->Value[1]);
+	SmartPtr<GameObjectWrapper> target_wrapper = LUA_SAFE_CAST(GameObjectWrapper, params->Value[2]);
+	SmartPtr<GameObjectWrapper> middle_wrapper = LUA_SAFE_CAST(GameObjectWrapper, params->Value[3]);
+	SmartPtr<PlayerWrapper> other_player = LUA_SAFE_CAST(PlayerWrapper, params->Value[4]);
+	if (!player || !player->Get_Object() || !player->Get_Object()->Get_AI_Player() || !other_player || !other_player->Get_Object())
+	{
+		script->Script_Error("FindTarget._Check_Reachability -- Parameters 1 and 5 must be players, the first one AI controlled.");
+		return NULL;
+	}
+	if (!source_wrapper || !source_wrapper->Get_Object() || !target_wrapper || !target_wrapper->Get_Object() || !middle_wrapper || !middle_wrapper->Get_Object())
+	{
+		script->Script_Error("FindTarget._Check_Reachability -- Parameters 2 to 4 must be live planets.");
+		return NULL;
+	}
+
+	GameObjectClass *middle = middle_wrapper->Get_Object();
+	PlanetaryBehaviorClass *planet_behave = static_cast<PlanetaryBehaviorClass *>(middle->Get_Behavior(BEHAVIOR_PLANET));
+	PlayerClass *original_owner = PlayerList.Get_Player_By_ID(middle->Get_Owner());
+	if (!planet_behave || !original_owner)
+	{
+		script->Script_Error("FindTarget._Check_Reachability -- Parameter 4 is not an owned planet.");
+		return NULL;
+	}
+
+	TacticalAIManagerClass *tactical_manager = player->Get_Object()->Get_AI_Player()->Get_Tactical_Manager_By_Mode(SUB_GAME_MODE_GALACTIC);
+	if (!tactical_manager)
+	{
+		script->Script_Error("FindTarget._Check_Reachability -- could not locate the galactic tactical AI manager.");
+		return NULL;
+	}
+
+	const AITargetLocationClass *source = tactical_manager->Get_Goal_System()->Find_Target(source_wrapper->Get_Object());
+	const AITargetLocationClass *target = tactical_manager->Get_Goal_System()->Find_Target(target_wrapper->Get_Object());
+	if (!source || !target || !target->Get_Target_Reachability())
+	{
+		script->Script_Error("FindTarget._Check_Reachability -- source or target is not a goal target.");
+		return NULL;
+	}
+
+	static const AIGoalReachabilityType check_types[] = { GOAL_REACHABILITY_FRIENDLY_IGNORE_THREAT, GOAL_REACHABILITY_ANY };
+
+	bool matched = true;
+	bool changed = false;
+	for (int i = 0; i < ARRAY_SIZE(check_types); ++i)
+	{
+		bool before = Check_Cached_Reachability(source, target, check_types[i], matched);
+
+		planet_behave->Change_Faction(middle, other_player->Get_Object()->Get_Faction());
+		bool flipped = Check_Cached_Reachability(source, target, check_types[i], matched);
+
+		planet_behave->Change_Faction(middle, original_owner->Get_Faction());
+		bool restored = Check_Cached_Reachability(source, target, check_types[i], matched);
+
+		Debug_Printf("_Check_Reachability %s: %d, %d with the middle planet given away, %d once it's back\n",
+			TheAIGoalReachabilityTypeConverterPtr->Enum_To_String(check_types[i]).c_str(), before, flipped, restored);
+
+		if (before != flipped)
+		{
+			changed = true;
+		}
+	}
+
+	if (!matched)
+	{
+		script->Script_Error("FindTarget._Check_Reachability -- a cached reachability answer differs from the full search.");
 	}
-}
\ No newline at end of file
+
+	return Return_Variable(new LuaBool(changed));
+}
+#endif
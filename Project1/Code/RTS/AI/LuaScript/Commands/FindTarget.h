@@ -54,11 +54,15 @@ class FindTargetClass : public LuaUserVar
 {
 public:
 	PG_DECLARE_RTTI();
+	LUA_DECLARE_MEMBER_TABLE(FindTargetClass);
 
 	FindTargetClass();
 	LuaTable *Reachable_Target(LuaScriptClass *script, LuaTable *params);
 	virtual LuaTable *Function_Call(LuaScriptClass *script, LuaTable *params);
 	LuaTable *Best_Of(LuaScriptClass *script, LuaTable *params);
+#ifndef NDEBUG
+	LuaTable *Check_Reachability(LuaScriptClass *script, LuaTable *params);
+#endif
 
 private:
 
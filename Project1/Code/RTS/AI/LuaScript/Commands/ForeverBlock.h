@@ -58,6 +58,8 @@ public:
 	ForeverBlockStatus();
 	virtual LuaTable* Function_Call(LuaScriptClass *script, LuaTable *params);
 	virtual LuaTable* Is_Finished(LuaScriptClass *, LuaTable *);
+	virtual bool Poll_Finished(LuaScriptClass *) { return false; }
+	virtual bool Signals_Completion(void) const { return true; }
 	virtual bool Save(LuaScriptClass *, ChunkWriterClass *writer);
 	virtual bool Load(LuaScriptClass *, ChunkReaderClass *reader);
 	virtual LuaTable* Result(LuaScriptClass *, LuaTable *);
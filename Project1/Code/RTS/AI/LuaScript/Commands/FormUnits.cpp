@@ -176,6 +176,11 @@ void FormationBlockStatus::Receive_Signal(SignalGeneratorClass *, PGSignalType t
 		default:
 			return;
 	}
+
+	if (Internal_Is_Finished())
+	{
+		Signal_Finished();
+	}
 }
 
 LUA_IMPLEMENT_FACTORY(LUA_CHUNK_FORMATION_BLOCK, FormationBlockStatus);
@@ -73,6 +73,8 @@ public:
 	virtual LuaTable* Result(LuaScriptClass *, LuaTable *);
 	virtual void Receive_Signal(SignalGeneratorClass *, PGSignalType type, SignalDataClass *data);
 	bool Internal_Is_Finished(void);
+	virtual bool Poll_Finished(LuaScriptClass *) { return Internal_Is_Finished(); }
+	virtual bool Signals_Completion(void) const { return true; }
 
 private:
 	std::vector<int>								MergeObjectIDs;
@@ -192,9 +192,14 @@ bool FreeStoreMovementBlockStatus::Internal_Is_Finished(void)
 	return IsFinished;
 }
 
-LuaTable* FreeStoreMovementBlockStatus::Is_Finished(LuaScriptClass *, LuaTable *)
+bool FreeStoreMovementBlockStatus::Poll_Finished(LuaScriptClass *)
 {
-	return Return_Variable(new LuaBool(Internal_Is_Finished()));
+	return Internal_Is_Finished();
+}
+
+LuaTable* FreeStoreMovementBlockStatus::Is_Finished(LuaScriptClass *script, LuaTable *)
+{
+	return Return_Variable(new LuaBool(Poll_Finished(script)));
 }
 
 enum {
@@ -64,6 +64,7 @@ public:
 	void Init(GameObjectWrapper *fleet, GameObjectWrapper *dest, PlayerClass *player, float threat_threshold);
 	void Add_Merge_Object(GameObjectWrapper *obj);
 	virtual LuaTable* Is_Finished(LuaScriptClass *, LuaTable *);
+	virtual bool Poll_Finished(LuaScriptClass *script);
 	bool Internal_Is_Finished(void);
 	virtual bool Save(LuaScriptClass *, ChunkWriterClass *writer);
 	virtual bool Load(LuaScriptClass *, ChunkReaderClass *reader);
@@ -114,5 +114,10 @@ bool GenericSignalBlockStatus::Load(LuaScriptClass *script, ChunkReaderClass *re
 		reader->Close_Chunk();
 	}
 
+	if (IsFinished)
+	{
+		Signal_Finished();
+	}
+
 	return ok;
 }
\ No newline at end of file
@@ -61,10 +61,11 @@ public:
 
 	void Init(LuaUserVar *command, SignalGeneratorClass *gen, PGSignalType signal_type);
 	virtual LuaTable *Is_Finished(LuaScriptClass *, LuaTable *) { return Return_Variable(new LuaBool(IsFinished)); }
+	virtual bool Signals_Completion(void) const { return true; }
 	virtual bool Save(LuaScriptClass *script, ChunkWriterClass *writer);
 	virtual bool Load(LuaScriptClass *script, ChunkReaderClass *reader);
 
-	virtual void Receive_Signal(SignalGeneratorClass *, PGSignalType, SignalDataClass *) { IsFinished = true; }
+	virtual void Receive_Signal(SignalGeneratorClass *, PGSignalType, SignalDataClass *) { IsFinished = true; Signal_Finished(); }
 
 protected:
 
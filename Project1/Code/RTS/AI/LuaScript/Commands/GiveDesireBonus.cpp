@@ -69,6 +69,7 @@ public:
 
 	void Init(AIGoalSystemClass *goal_system, const AIGoalTypeClass *goal_type, const AITargetLocationClass *target, float bonus, float time_limit);
 	virtual LuaTable *Is_Finished(LuaScriptClass *, LuaTable *);
+	virtual bool Poll_Finished(LuaScriptClass *script);
 	virtual LuaTable *Result(LuaScriptClass *, LuaTable *) {return NULL;}
 	virtual bool Save(LuaScriptClass *script, ChunkWriterClass *writer);
 	virtual bool Load(LuaScriptClass *script, ChunkReaderClass *reader);
@@ -105,14 +106,19 @@ void GiveDesireBlockStatus::Init(AIGoalSystemClass *goal_system, const AIGoalTyp
 	Bonus = bonus;
 }
 
-LuaTable *GiveDesireBlockStatus::Is_Finished(LuaScriptClass *, LuaTable *)
+bool GiveDesireBlockStatus::Poll_Finished(LuaScriptClass *)
 {
 	if (GoalSystem->Give_Desire_Bonus(GoalType, Target, Bonus))
 	{
-		return Return_Variable(new LuaBool(true));
+		return true;
 	}
 
-	return Return_Variable(new LuaBool(FrameSynchronizer.Get_Current_Frame() >= ExpiryFrame));
+	return FrameSynchronizer.Get_Current_Frame() >= ExpiryFrame;
+}
+
+LuaTable *GiveDesireBlockStatus::Is_Finished(LuaScriptClass *script, LuaTable *)
+{
+	return Return_Variable(new LuaBool(Poll_Finished(script)));
 }
 
 enum
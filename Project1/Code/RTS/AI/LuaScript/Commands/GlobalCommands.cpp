@@ -88,6 +88,11 @@
 #include "AssembleFleet.h"
 #include "TransportLandingBehavior.h"
 #include "BinkPlayer.h"
+#include "ObjectQueryIndex.h"
+#include "AutoResolve.h"
+#include "SimulateAutoResolve.h"
+#include <time.h>
+#include <algorithm>
 #include "LuaMusic.h"
 #include "WeatherSystem.h"
 #include "LuaGUIHighlight.h"
@@ -863,38 +868,194 @@ public:
 
 		LuaTable::Pointer table = Alloc_Lua_Table();
 
-		ReferenceListIterator<GameObjectClass> object_list = GameModeManager.Get_Active_Mode()->Get_Object_Manager().Get_Object_Iterator();
-		for (object_list.First(); object_list.Is_Done() == false; object_list.Next())
+		static std::vector<GameObjectClass *> objects;
+		ObjectQueryIndexClass::Get().Find_Objects(player, filter_type, property_filter, category_filter, objects);
+		for (int i = 0; i < (int)objects.size(); i++)
 		{
-			GameObjectClass *object = object_list.Current_Object();
+			table->Value.push_back(GameObjectWrapper::Create(objects[i], script));
+		}
 
-			if (player && player != object->Get_Owner_Player())
-			{
-				continue;
-			}
+		return Return_Variable(table);
+	}
+};
+PG_IMPLEMENT_RTTI(FindAllObjectsOfType, LuaUserVar);
 
-			if (filter_type && object->Get_Original_Object_Type() != filter_type)
-			{
-				continue;
-			}
+#ifndef NDEBUG
+/**
+ * Debug only benchmark for the object query index.  Spawns object_count
+ * objects of a type for the local player, then for each iteration destroys
+ * churn of them, spawns churn new ones and times the same queries through
+ * a walk of the whole object list and through the index.  The queries are
+ * by type, by the type's first category and by owner and type.  Every
+ * indexed answer is checked against the walk.  The spawned objects are
+ * destroyed again at the end.
+ * 
+ * _BenchmarkFindAllObjects("type", object_count, iterations, churn)
+ */
+class LuaBenchmarkFindAllObjects : public LuaUserVar
+{
+public:
+	PG_DECLARE_RTTI();
+
+	virtual LuaTable* Function_Call(LuaScriptClass *script, LuaTable *params)
+	{
+		SmartPtr<LuaString> type_name = params->Value.size() > 0 ? PG_Dynamic_Cast<LuaString>(params->Value[0]) : NULL;
+		GameObjectTypeClass *type = type_name ? GameObjectTypeManager.Find_Object_Type(type_name->Value) : NULL;
+		if (!type)
+		{
+			script->Script_Error("_BenchmarkFindAllObjects -- Expected the name of an object type to spawn.");
+			return NULL;
+		}
 
-			if (property_filter != GAME_OBJECT_PROPERTIES_ALL && (property_filter & object->Get_Original_Object_Type()->Get_Property_Mask()) == 0)
+		PlayerClass *player = PlayerList.Get_Local_Player();
+		if (!player)
+		{
+			script->Script_Error("_BenchmarkFindAllObjects -- there is no local player to spawn for.");
+			return NULL;
+		}
+
+		int object_count = Get_Count_Parameter(params, 1, 10000);
+		int iterations = Get_Count_Parameter(params, 2, 100);
+		int churn = Min(Get_Count_Parameter(params, 3, 50), object_count);
+
+		unsigned int category_mask = (unsigned int)type->Get_Category_Mask();
+		GameObjectCategoryType category_filter = (GameObjectCategoryType)(category_mask & (~category_mask + 1));
+		if (category_filter == 0)
+		{
+			category_filter = GAME_OBJECT_CATEGORY_ALL;
+		}
+
+		std::vector<GameObjectClass *> spawned;
+		std::vector<ObjectIDType> spawned_ids;
+		for (int i = 0; i < object_count; i++)
+		{
+			Spawn(type, player, i, spawned, spawned_ids);
+		}
+
+		int scanned = ObjectQueryIndexClass::Get().Get_Scanned_Count();
+		int rebuilds = ObjectQueryIndexClass::Get().Get_Rebuild_Count();
+		int mismatches = 0;
+		int matches = 0;
+		clock_t scan_ticks = 0;
+		clock_t index_ticks = 0;
+		std::vector<GameObjectClass *> scan_objects;
+		std::vector<GameObjectClass *> index_objects;
+		for (int i = 0; i < iterations; i++)
+		{
+			// Churn the oldest spawned objects for new ones
+			for (int j = 0; j < churn && !spawned.empty(); j++)
 			{
-				continue;
+				Destroy(spawned[0], spawned_ids[0]);
+				spawned.erase(spawned.begin());
+				spawned_ids.erase(spawned_ids.begin());
+				Spawn(type, player, object_count + i * churn + j, spawned, spawned_ids);
 			}
 
-			if ((category_filter != GAME_OBJECT_CATEGORY_ALL) && (category_filter & object->Get_Original_Object_Type()->Get_Category_Mask()) == 0)
+			for (int query = 0; query < 3; query++)
 			{
-				continue;
+				PlayerClass *query_player = (query == 2) ? player : NULL;
+				GameObjectTypeClass *query_type = (query == 1) ? NULL : type;
+				GameObjectCategoryType query_category = (query == 1) ? category_filter : GAME_OBJECT_CATEGORY_ALL;
+
+				clock_t start = clock();
+				ObjectQueryIndexClass::Find_Objects_Unindexed(query_player, query_type, GAME_OBJECT_PROPERTIES_ALL, query_category, scan_objects);
+				scan_ticks += clock() - start;
+
+				start = clock();
+				ObjectQueryIndexClass::Get().Find_Objects(query_player, query_type, GAME_OBJECT_PROPERTIES_ALL, query_category, index_objects);
+				index_ticks += clock() - start;
+
+				// The index answers in ID order, the walk in list order
+				std::sort(scan_objects.begin(), scan_objects.end());
+				std::sort(index_objects.begin(), index_objects.end());
+				if (scan_objects != index_objects)
+				{
+					mismatches++;
+				}
+				matches += (int)index_objects.size();
 			}
+		}
 
-			table->Value.push_back(GameObjectWrapper::Create(object, script));
+		for (unsigned int i = 0; i < spawned.size(); i++)
+		{
+			Destroy(spawned[i], spawned_ids[i]);
 		}
 
-		return Return_Variable(table);
+		int queries = Max(iterations * 3, 1);
+		float scan_ms = scan_ticks * 1000.0f / CLOCKS_PER_SEC / queries;
+		float index_ms = index_ticks * 1000.0f / CLOCKS_PER_SEC / queries;
+		Debug_Printf("_BenchmarkFindAllObjects %s: %d spawned, %d x 3 queries with %d churned between each over %d objects, %d matches: scan %.4fms, index %.4fms per query, %d objects looked at for new ones, %d rebuilds\n",
+			type_name->Value.c_str(), object_count, iterations, churn, GameModeManager.Get_Active_Mode()->Get_Object_Manager().Get_Object_Count(),
+			matches, scan_ms, index_ms, ObjectQueryIndexClass::Get().Get_Scanned_Count() - scanned, ObjectQueryIndexClass::Get().Get_Rebuild_Count() - rebuilds);
+
+		if (mismatches)
+		{
+			script->Script_Error("_BenchmarkFindAllObjects -- %d indexed queries differ from the walk of the object list.", mismatches);
+		}
+
+		LuaTable *retval = Alloc_Lua_Table();
+		retval->Value.push_back(new LuaNumber(scan_ms));
+		retval->Value.push_back(new LuaNumber(index_ms));
+		return retval;
+	}
+
+private:
+
+	static int Get_Count_Parameter(LuaTable *params, unsigned int index, int default_count)
+	{
+		SmartPtr<LuaNumber> count = params->Value.size() > index ? PG_Dynamic_Cast<LuaNumber>(params->Value[index]) : NULL;
+		return count ? Max((int)count->Value, 0) : default_count;
+	}
+
+	static void Spawn(GameObjectTypeClass *type, PlayerClass *player, int index, std::vector<GameObjectClass *> &spawned, std::vector<ObjectIDType> &spawned_ids)
+	{
+		Vector3 position((index % 128) * 40.0f, ((index / 128) % 128) * 40.0f, 0.0f);
+		GameObjectClass *object = GAME_OBJECT_MANAGER.Create_Object_Of_Type(type, player->Get_ID(), position, VECTOR3_NONE);
+		if (object)
+		{
+			spawned.push_back(object);
+			spawned_ids.push_back(object->Get_ID());
+		}
+	}
+
+	static void Destroy(GameObjectClass *object, ObjectIDType id)
+	{
+		if (GAME_OBJECT_MANAGER.Get_Object_From_ID(id) == object && !object->Is_Delete_Pending())
+		{
+			object->Destroy();
+		}
 	}
 };
-PG_IMPLEMENT_RTTI(FindAllObjectsOfType, LuaUserVar);
+PG_IMPLEMENT_RTTI(LuaBenchmarkFindAllObjects, LuaUserVar);
+
+/**
+ * Debug only check that auto resolve attrition picks its victims in the same
+ * order as the loop it replaced, over seed_count fixed seeds.
+ * 
+ * _Check_Attrition_Picks(seed_count)
+ * 
+ * @return true if every seed matched
+ */
+class LuaCheckAttritionPicks : public LuaUserVar
+{
+public:
+	PG_DECLARE_RTTI();
+
+	virtual LuaTable* Function_Call(LuaScriptClass *script, LuaTable *params)
+	{
+		SmartPtr<LuaNumber> count = params->Value.size() > 0 ? PG_Dynamic_Cast<LuaNumber>(params->Value[0]) : NULL;
+		int seed_count = count ? Max((int)count->Value, 1) : 1000;
+
+		bool matched = AutoResolveClass::Check_Attrition_Picks(seed_count);
+		if (!matched)
+		{
+			script->Script_Error("_Check_Attrition_Picks -- attrition pick order differs from the erase loop; see the debug output.");
+		}
+		return Return_Variable(new LuaBool(matched));
+	}
+};
+PG_IMPLEMENT_RTTI(LuaCheckAttritionPicks, LuaUserVar);
+#endif
 
 /**
  * activate the mission retry dialog
@@ -1759,9 +1920,13 @@ public:
 	PG_DECLARE_RTTI();
 	LUA_DECLARE_FACTORY(LUA_CHUNK_BINK_MOVIE_BLOCK, BinkMovieBlockStatus);
 
-	virtual LuaTable *Is_Finished(LuaScriptClass *, LuaTable *)
+	virtual LuaTable *Is_Finished(LuaScriptClass *script, LuaTable *)
 	{
-		return Return_Variable(new LuaBool(BinkPlayer.Is_Playing() == false));
+		return Return_Variable(new LuaBool(Poll_Finished(script)));
+	}
+	virtual bool Poll_Finished(LuaScriptClass *)
+	{
+		return BinkPlayer.Is_Playing() == false;
 	}
 	virtual LuaTable *Result(LuaScriptClass *, LuaTable *)							{ return NULL; }
 
@@ -2377,11 +2542,10 @@ class LuaGetTime : public LuaUserVar
 {
 public:
 	PG_DECLARE_RTTI();
+	LUA_DECLARE_MEMBER_TABLE(LuaGetTime);
 
 	LuaGetTime()
 	{
-		LUA_REGISTER_MEMBER_FUNCTION(LuaGetTime, "Frame", &LuaGetTime::Frame);
-		LUA_REGISTER_MEMBER_FUNCTION(LuaGetTime, "Galactic_Time", &LuaGetTime::Galactic_Time);
 	}
 	virtual LuaTable* Function_Call(LuaScriptClass *, LuaTable *)
 	{
@@ -2401,16 +2565,22 @@ public:
 
 };
 PG_IMPLEMENT_RTTI(LuaGetTime, LuaUserVar);
+LUA_IMPLEMENT_MEMBER_TABLE(LuaGetTime, LuaUserVar);
+
+void LuaGetTime::Register_Members(LuaMemberTableClass *table)
+{
+	LUA_REGISTER_MEMBER_FUNCTION(LuaGetTime, "Frame", &LuaGetTime::Frame);
+	LUA_REGISTER_MEMBER_FUNCTION(LuaGetTime, "Galactic_Time", &LuaGetTime::Galactic_Time);
+}
 
 class LuaGameRandom : public LuaUserVar
 {
 public:
 	PG_DECLARE_RTTI();
+	LUA_DECLARE_MEMBER_TABLE(LuaGameRandom);
 
 	LuaGameRandom()
 	{
-		LUA_REGISTER_MEMBER_FUNCTION(LuaGameRandom, "Get_Float", &LuaGameRandom::Get_Float);
-		LUA_REGISTER_MEMBER_FUNCTION(LuaGameRandom, "Free_Random", &LuaGameRandom::Free_Random);
 	}
 
 	virtual LuaTable* Get_Float(LuaScriptClass *script, LuaTable *params)
@@ -2508,6 +2678,13 @@ public:
 	}
 };
 PG_IMPLEMENT_RTTI(LuaGameRandom, LuaUserVar);
+LUA_IMPLEMENT_MEMBER_TABLE(LuaGameRandom, LuaUserVar);
+
+void LuaGameRandom::Register_Members(LuaMemberTableClass *table)
+{
+	LUA_REGISTER_MEMBER_FUNCTION(LuaGameRandom, "Get_Float", &LuaGameRandom::Get_Float);
+	LUA_REGISTER_MEMBER_FUNCTION(LuaGameRandom, "Free_Random", &LuaGameRandom::Free_Random);
+}
 
 /**
  * Register the Lua commands for the global commands
@@ -2570,7 +2747,12 @@ void GlobalCommandsClass::Register_Commands(LuaScriptClass *script)
 		script->Map_Global_To_Lua(new LuaLockControls(), "Lock_Controls");
 		script->Map_Global_To_Lua(new LuaSuspendAI(), "Suspend_AI");
 		script->Map_Global_To_Lua(new FindAllObjectsOfType(), "Find_All_Objects_Of_Type");
+#ifndef NDEBUG
+		script->Map_Global_To_Lua(new LuaBenchmarkFindAllObjects(), "_BenchmarkFindAllObjects");
+		script->Map_Global_To_Lua(new LuaCheckAttritionPicks(), "_Check_Attrition_Picks");
+#endif
 		script->Map_Global_To_Lua(new FindPlayerClass(), "Find_Player");
+		script->Map_Global_To_Lua(new SimulateAutoResolveClass(), "Simulate_Auto_Resolve");
 		script->Map_Global_To_Lua(new IsPointInNebulaClass(), "Is_Point_In_Nebula");
 		script->Map_Global_To_Lua(new IsPointInIonStormClass(), "Is_Point_In_Ion_Storm");
 		script->Map_Global_To_Lua(new IsPointInAsteroidFieldClass(), "Is_Point_In_Asteroid_Field");
@@ -108,6 +108,7 @@ void InvasionBlockStatus::Receive_Signal(SignalGeneratorClass *, PGSignalType ty
 				Success = result->Success;
 				IsFinished = true;
 				SignalDispatcherClass::Get().Remove_Listener_From_All(this);
+				Signal_Finished();
 			}
 			break;
 
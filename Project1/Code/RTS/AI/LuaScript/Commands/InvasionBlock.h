@@ -73,6 +73,8 @@ public:
 	InvasionBlockStatus();
 	void Init(TaskForceClass *command, GameObjectClass *planet);
 	virtual LuaTable* Is_Finished(LuaScriptClass *script, LuaTable *params);
+	virtual bool Poll_Finished(LuaScriptClass *) { return IsFinished; }
+	virtual bool Signals_Completion(void) const { return true; }
 	virtual bool Save(LuaScriptClass *, ChunkWriterClass *writer);
 	virtual bool Load(LuaScriptClass *, ChunkReaderClass *reader);
 	virtual LuaTable* Result(LuaScriptClass *, LuaTable *);
@@ -43,6 +43,7 @@
 #pragma hdrstop
 
 #include "IsInHazard.h"
+#include "AI/LuaScript/LuaRTSBinding.h"
 #include "GameObject.h"
 #include "AI/Movement/ObjectTrackingSystem.h"
 #include "GameObjectManager.h"
@@ -52,9 +53,13 @@ PG_IMPLEMENT_RTTI(IsPointInNebulaClass, LuaUserVar);
 PG_IMPLEMENT_RTTI(IsPointInIonStormClass, LuaUserVar);
 PG_IMPLEMENT_RTTI(IsPointInAsteroidFieldClass, LuaUserVar);
 
+LUA_BIND_FUNCTION_CALL(IsPointInNebulaClass, "Is_Point_In_Nebula", &IsPointInNebulaClass::Is_Point_In);
+LUA_BIND_FUNCTION_CALL(IsPointInIonStormClass, "Is_Point_In_Ion_Storm", &IsPointInIonStormClass::Is_Point_In);
+LUA_BIND_FUNCTION_CALL(IsPointInAsteroidFieldClass, "Is_Point_In_Asteroid_Field", &IsPointInAsteroidFieldClass::Is_Point_In);
+
 /**************************************************************************************************
 * Get_Static_Colliders -- Helper function to get the list of objects whose oriented boxes contain
-*	the point defined by the lua parameter
+*	a point
 *
 * In:			
 *
@@ -62,22 +67,9 @@ PG_IMPLEMENT_RTTI(IsPointInAsteroidFieldClass, LuaUserVar);
 *
 * History: 8/9/2005 7:55PM JSY
 **************************************************************************************************/
-void Get_Static_Colliders(LuaScriptClass *script, LuaTable *params, std::vector<GameObjectClass*> &objects)
+void Get_Static_Colliders(LuaScriptClass *script, const Vector3 &query_position, std::vector<GameObjectClass*> &objects)
 {
-	if (params->Value.size() != 1)
-	{
-		script->Script_Error("Get_Static_Colliders -- invalid number of parameters.  Expected 1, got %d.");
-		return;
-	}
-
-	Vector3 query_position;
-	Vector2 projected_position;
-	if (!Lua_Extract_Position(params->Value[0], query_position))
-	{
-		script->Script_Error("Get_Static_Colliders -- invalid type for parameter 1.  Expected something that can define a position.");
-		return;
-	}
-	projected_position = query_position.Project_XY();
+	Vector2 projected_position = query_position.Project_XY();
 
 	GameModeClass *mode = GameModeManager.Get_Active_Mode();
 	FAIL_IF(!mode) { return; }
@@ -106,7 +98,7 @@ void Get_Static_Colliders(LuaScriptClass *script, LuaTable *params, std::vector<
 }
 
 /**************************************************************************************************
-* IsPointInNebulaClass::Function_Call -- Script function to discover whether a point is inside a nebula 
+* IsPointInNebulaClass::Is_Point_In -- Script function to discover whether a point is inside a nebula 
 *
 * In:			
 *
@@ -114,24 +106,24 @@ void Get_Static_Colliders(LuaScriptClass *script, LuaTable *params, std::vector<
 *
 * History: 8/9/2005 7:55PM JSY
 **************************************************************************************************/
-LuaTable *IsPointInNebulaClass::Function_Call(LuaScriptClass *script, LuaTable *params)
+bool IsPointInNebulaClass::Is_Point_In(LuaScriptClass *script, Vector3 position)
 {
 	static std::vector<GameObjectClass*> objects;
 	objects.resize(0);
-	Get_Static_Colliders(script, params, objects);
+	Get_Static_Colliders(script, position, objects);
 	for (unsigned int i = 0; i < objects.size(); ++i)
 	{
 		if (objects[i]->Get_Type()->Is_Nebula())
 		{
-			return Return_Variable(new LuaBool(true));
+			return true;
 		}
 	}
 
-	return Return_Variable(new LuaBool(false));
+	return false;
 }
 
 /**************************************************************************************************
-* IsPointInIonStormClass::Function_Call -- Script function to discover whether a point is inside an ion storm
+* IsPointInIonStormClass::Is_Point_In -- Script function to discover whether a point is inside an ion storm
 *
 * In:			
 *
@@ -139,24 +131,24 @@ LuaTable *IsPointInNebulaClass::Function_Call(LuaScriptClass *script, LuaTable *
 *
 * History: 8/9/2005 7:55PM JSY
 **************************************************************************************************/
-LuaTable *IsPointInIonStormClass::Function_Call(LuaScriptClass *script, LuaTable *params)
+bool IsPointInIonStormClass::Is_Point_In(LuaScriptClass *script, Vector3 position)
 {
 	static std::vector<GameObjectClass*> objects;
 	objects.resize(0);
-	Get_Static_Colliders(script, params, objects);
+	Get_Static_Colliders(script, position, objects);
 	for (unsigned int i = 0; i < objects.size(); ++i)
 	{
 		if (objects[i]->Get_Type()->Is_Ion_Storm())
 		{
-			return Return_Variable(new LuaBool(true));
+			return true;
 		}
 	}
 
-	return Return_Variable(new LuaBool(false));
+	return false;
 }
 
 /**************************************************************************************************
-* IsPointInAsteroidFieldClass::Function_Call -- Script function to discover whether a point is inside an
+* IsPointInAsteroidFieldClass::Is_Point_In -- Script function to discover whether a point is inside an
 *	asteroid field
 *
 * In:			
@@ -165,18 +157,18 @@ LuaTable *IsPointInIonStormClass::Function_Call(LuaScriptClass *script, LuaTable
 *
 * History: 8/9/2005 7:55PM JSY
 **************************************************************************************************/
-LuaTable *IsPointInAsteroidFieldClass::Function_Call(LuaScriptClass *script, LuaTable *params)
+bool IsPointInAsteroidFieldClass::Is_Point_In(LuaScriptClass *script, Vector3 position)
 {
 	static std::vector<GameObjectClass*> objects;
 	objects.resize(0);
-	Get_Static_Colliders(script, params, objects);
+	Get_Static_Colliders(script, position, objects);
 	for (unsigned int i = 0; i < objects.size(); ++i)
 	{
 		if (objects[i]->Get_Type()->Is_Asteroid_Field())
 		{
-			return Return_Variable(new LuaBool(true));
+			return true;
 		}
 	}
 
-	return Return_Variable(new LuaBool(false));
+	return false;
 }
\ No newline at end of file
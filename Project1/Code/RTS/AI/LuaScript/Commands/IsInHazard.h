@@ -44,23 +44,27 @@
 #define _IS_IN_HAZARD_H_
 
 #include "AI/LuaScript/LuaRTSUtilities.h"
+#include "LuaBinding.h"
 
 class IsPointInNebulaClass : public LuaUserVar
 {
 	PG_DECLARE_RTTI();
-	virtual LuaTable *Function_Call(LuaScriptClass *script, LuaTable *params);
+	LUA_DECLARE_BOUND_FUNCTION_CALL();
+	bool Is_Point_In(LuaScriptClass *script, Vector3 position);
 };
 
 class IsPointInIonStormClass : public LuaUserVar
 {
 	PG_DECLARE_RTTI();
-	virtual LuaTable *Function_Call(LuaScriptClass *script, LuaTable *params);
+	LUA_DECLARE_BOUND_FUNCTION_CALL();
+	bool Is_Point_In(LuaScriptClass *script, Vector3 position);
 };
 
 class IsPointInAsteroidFieldClass : public LuaUserVar
 {
 	PG_DECLARE_RTTI();
-	virtual LuaTable *Function_Call(LuaScriptClass *script, LuaTable *params);
+	LUA_DECLARE_BOUND_FUNCTION_CALL();
+	bool Is_Point_In(LuaScriptClass *script, Vector3 position);
 };
 
 #endif //_IS_IN_HAZARD_H_
\ No newline at end of file
@@ -285,11 +285,16 @@ bool LandMovementBlockStatus::Internal_Is_Finished(void)
 	return IsFinished;
 }
 
-LuaTable* LandMovementBlockStatus::Is_Finished(LuaScriptClass *, LuaTable *)
+bool LandMovementBlockStatus::Poll_Finished(LuaScriptClass *)
 {
 	TaskForceClass *tf = (TaskForceClass *)Get_Command();
 
-	return Return_Variable(new LuaBool(Internal_Is_Finished() || tf->Get_Force_Count() == 0));
+	return Internal_Is_Finished() || tf->Get_Force_Count() == 0;
+}
+
+LuaTable* LandMovementBlockStatus::Is_Finished(LuaScriptClass *script, LuaTable *)
+{
+	return Return_Variable(new LuaBool(Poll_Finished(script)));
 }
 
 enum {
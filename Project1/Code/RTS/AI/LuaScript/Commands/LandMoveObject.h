@@ -67,6 +67,7 @@ public:
 	void Init(LuaUserVar *command, GameObjectClass *dest, float threat_tolerance, bool do_zone_path, bool attack, int move_flags);
 	void Init(LuaUserVar *command, const Vector3 &pos, float threat_tolerance, bool do_zone_path, int move_flags);
 	virtual LuaTable* Is_Finished(LuaScriptClass *, LuaTable *);
+	virtual bool Poll_Finished(LuaScriptClass *script);
 	bool Internal_Is_Finished(void);
 	virtual bool Save(LuaScriptClass *, ChunkWriterClass *writer);
 	virtual bool Load(LuaScriptClass *, ChunkReaderClass *reader);
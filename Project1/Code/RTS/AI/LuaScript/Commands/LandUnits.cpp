@@ -199,6 +199,11 @@ void LandUnitsBlockStatus::Receive_Signal(SignalGeneratorClass *_ship, PGSignalT
 		default:
 			return;
 	}
+
+	if (Internal_Is_Finished())
+	{
+		Signal_Finished();
+	}
 }
 
 LUA_IMPLEMENT_FACTORY(LUA_CHUNK_LAND_UNITS_BLOCK, LandUnitsBlockStatus);
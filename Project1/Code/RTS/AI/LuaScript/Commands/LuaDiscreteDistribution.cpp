@@ -45,8 +45,13 @@
 
 PG_IMPLEMENT_RTTI(LuaDiscreteDistributionClass, LuaUserVar);
 LUA_IMPLEMENT_FACTORY(LUA_CHUNK_DISCRETE_DISTRIBUTION, LuaDiscreteDistributionClass);
+LUA_IMPLEMENT_MEMBER_TABLE(LuaDiscreteDistributionClass, LuaUserVar);
 
 LuaDiscreteDistributionClass::LuaDiscreteDistributionClass()
+{
+}
+
+void LuaDiscreteDistributionClass::Register_Members(LuaMemberTableClass *table)
 {
 	LUA_REGISTER_MEMBER_FUNCTION(LuaDiscreteDistributionClass, "Create", &LuaDiscreteDistributionClass::Create);
 	LUA_REGISTER_MEMBER_FUNCTION_USE_MAPS(LuaDiscreteDistributionClass, "Insert", &LuaDiscreteDistributionClass::Insert);
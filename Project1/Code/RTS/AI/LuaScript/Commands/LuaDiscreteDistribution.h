@@ -51,6 +51,7 @@ class LuaDiscreteDistributionClass : public LuaUserVar
 public:
 	PG_DECLARE_RTTI();
 	LUA_DECLARE_FACTORY(LUA_CHUNK_DISCRETE_DISTRIBUTION, LuaDiscreteDistributionClass);
+	LUA_DECLARE_MEMBER_TABLE(LuaDiscreteDistributionClass);
 
 	LuaDiscreteDistributionClass();
 
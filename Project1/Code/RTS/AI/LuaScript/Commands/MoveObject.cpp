@@ -273,9 +273,14 @@ bool MovementBlockStatus::Internal_Is_Finished(void)
 	return IsFinished;
 }
 
-LuaTable* MovementBlockStatus::Is_Finished(LuaScriptClass *, LuaTable *)
+bool MovementBlockStatus::Poll_Finished(LuaScriptClass *)
 {
-	return Return_Variable(new LuaBool(Internal_Is_Finished() || !ResultObject->Get_Object()));
+	return Internal_Is_Finished() || !ResultObject->Get_Object();
+}
+
+LuaTable* MovementBlockStatus::Is_Finished(LuaScriptClass *script, LuaTable *)
+{
+	return Return_Variable(new LuaBool(Poll_Finished(script)));
 }
 
 enum {
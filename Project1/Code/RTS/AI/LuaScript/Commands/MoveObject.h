@@ -62,6 +62,7 @@ public:
 	MovementBlockStatus();
 	void Init(LuaUserVar *command, GameObjectWrapper *fleet, GameObjectWrapper *dest, AIGoalReachabilityType reachability);
 	virtual LuaTable* Is_Finished(LuaScriptClass *, LuaTable *);
+	virtual bool Poll_Finished(LuaScriptClass *script);
 	bool Internal_Is_Finished(void);
 	virtual bool Save(LuaScriptClass *, ChunkWriterClass *writer);
 	virtual bool Load(LuaScriptClass *, ChunkReaderClass *reader);
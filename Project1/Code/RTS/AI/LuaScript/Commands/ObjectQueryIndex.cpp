@@ -0,0 +1,409 @@
+// $Id: //depot/Projects/StarWars_Steam/FOC/Code/RTS/AI/LuaScript/Commands/ObjectQueryIndex.cpp#1 $
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Petroglyph Games, Inc.
+//
+//
+//  *****           **                          *                   *
+//  *   **          *                           *                   *
+//  *    *          *                           *                   *
+//  *    *          *     *                 *   *          *        *
+//  *   *     *** ******  * **  ****      ***   * *      * *****    * ***
+//  *  **    *  *   *     **   *   **   **  *   *  *    * **   **   **   *
+//  ***     *****   *     *   *     *  *    *   *  *   **  *    *   *    *
+//  *       *       *     *   *     *  *    *   *   *  *   *    *   *    *
+//  *       *       *     *   *     *  *    *   *   * **   *   *    *    *
+//  *       **       *    *   **   *   **   *   *    **    *  *     *   *
+// **        ****     **  *    ****     *****   *    **    ***      *   *
+//                                          *        *     *
+//                                          *        *     *
+//                                          *       *      *
+//                                      *  *        *      *
+//                                      ****       *       *
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// C O N F I D E N T I A L   S O U R C E   C O D E -- D O   N O T   D I S T R I B U T E
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//              $File: //depot/Projects/StarWars_Steam/FOC/Code/RTS/AI/LuaScript/Commands/ObjectQueryIndex.cpp $
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/** @file */
+
+#pragma hdrstop
+
+#include "Always.h"
+
+#include "ObjectQueryIndex.h"
+#include "GameObject.h"
+#include "GameObjectType.h"
+#include "GameObjectManager.h"
+#include "GameModeManager.h"
+#include "Player.h"
+#include "PGSignal/SignalDispatcher.h"
+
+/**
+ * Get the index shared by all Lua queries.
+ * 
+ * @return the object query index
+ */
+ObjectQueryIndexClass &ObjectQueryIndexClass::Get(void)
+{
+	static ObjectQueryIndexClass index;
+	return index;
+}
+
+ObjectQueryIndexClass::ObjectQueryIndexClass() :
+	Mode(NULL)
+,	RebuildCount(0)
+,	ScannedCount(0)
+{
+}
+
+/**
+ * An indexed object is going away or changed hands.  Both are handled on
+ * the next query: the deleted object stays listed until the manager lets
+ * go of it, and the new owner may not be set yet while the signal is sent.
+ */
+void ObjectQueryIndexClass::Receive_Signal(SignalGeneratorClass *generator, PGSignalType signal_type, SignalDataClass *)
+{
+	GameObjectClass *object = static_cast<GameObjectClass *>(generator);
+	if (signal_type == PG_SIGNAL_OBJECT_DELETE_PENDING)
+	{
+		SignalDispatcherClass::Get().Remove_Listener(generator, this, PG_SIGNAL_OBJECT_DELETE_PENDING);
+		SignalDispatcherClass::Get().Remove_Listener(generator, this, PG_SIGNAL_OBJECT_OWNER_CHANGED);
+
+		EntryListType::iterator it = Entries.find(object->Get_ID());
+		if (it != Entries.end() && it->second.Object == object)
+		{
+			it->second.Listening = false;
+			Deleted.push_back(object->Get_ID());
+		}
+	}
+	else if (signal_type == PG_SIGNAL_OBJECT_OWNER_CHANGED)
+	{
+		OwnerChanged.push_back(object->Get_ID());
+	}
+}
+
+/**
+ * Bring the buckets up to date with the owner changes, deletes and
+ * creates since the last query.  A mode change indexes the new mode from
+ * scratch.
+ */
+void ObjectQueryIndexClass::Update(void)
+{
+	if (Stamp.Refresh(ObjectSetStampClass::CHECK_MODE_ONLY))
+	{
+		Build(GameModeManager.Get_Active_Mode());
+		return;
+	}
+
+	if (!Mode) return;
+	GameObjectManagerClass &manager = Mode->Get_Object_Manager();
+
+	for (unsigned int i = 0; i < OwnerChanged.size(); i++)
+	{
+		ObjectIDType id = OwnerChanged[i];
+		EntryListType::iterator it = Entries.find(id);
+		if (it == Entries.end() || manager.Get_Object_From_ID(id) != it->second.Object)
+		{
+			continue;
+		}
+
+		EntryStruct &entry = it->second;
+		int owner = entry.Object->Get_Owner();
+		if (owner != entry.Owner)
+		{
+			OwnerBuckets[entry.Owner].erase(id);
+			OwnerBuckets[owner][id] = entry.Object;
+			entry.Owner = owner;
+		}
+	}
+	OwnerChanged.resize(0);
+
+	unsigned int still_listed = 0;
+	for (unsigned int i = 0; i < Deleted.size(); i++)
+	{
+		EntryListType::iterator it = Entries.find(Deleted[i]);
+		if (it == Entries.end())
+		{
+			continue;
+		}
+
+		if (manager.Get_Object_From_ID(Deleted[i]) == it->second.Object)
+		{
+			Deleted[still_listed++] = Deleted[i];
+		}
+		else
+		{
+			Remove_Object(Deleted[i]);
+		}
+	}
+	Deleted.resize(still_listed);
+
+	if (manager.Get_Object_Count() > (int)Entries.size())
+	{
+		Find_New_Objects();
+	}
+}
+
+/**
+ * Index the objects the manager lists and the index doesn't hold yet.  Every
+ * indexed object the manager still lists is in Entries, so the difference in
+ * size is the number of new objects.  New objects are added at the end of
+ * the list, so the walk starts there and stops once they are all found.
+ */
+void ObjectQueryIndexClass::Find_New_Objects(void)
+{
+	GameObjectManagerClass &manager = Mode->Get_Object_Manager();
+	int count = manager.Get_Object_Count();
+	int missing = count - (int)Entries.size();
+	for (int i = count - 1; i >= 0 && missing > 0; i--)
+	{
+		GameObjectClass *object = manager.Get_Object_At_Index(i);
+		ScannedCount++;
+		if (Entries.find(object->Get_ID()) == Entries.end())
+		{
+			Add_Object(object);
+			missing--;
+		}
+	}
+}
+
+/**
+ * Put an object in its buckets and start listening to it.
+ */
+void ObjectQueryIndexClass::Add_Object(GameObjectClass *object)
+{
+	ObjectIDType id = object->Get_ID();
+	EntryStruct &entry = Entries[id];
+	entry.Object = object;
+	entry.Type = object->Get_Original_Object_Type();
+	entry.Owner = object->Get_Owner();
+	entry.Listening = !object->Is_Delete_Pending();
+
+	if (entry.Listening)
+	{
+		SignalDispatcherClass::Get().Add_Listener(object, this, PG_SIGNAL_OBJECT_DELETE_PENDING);
+		SignalDispatcherClass::Get().Add_Listener(object, this, PG_SIGNAL_OBJECT_OWNER_CHANGED);
+	}
+	else
+	{
+		Deleted.push_back(id);
+	}
+
+	AllObjects[id] = object;
+	TypeBuckets[entry.Type][id] = object;
+	OwnerBuckets[entry.Owner][id] = object;
+
+	unsigned int category_mask = (unsigned int)entry.Type->Get_Category_Mask();
+	for (int bit = 0; category_mask && bit < CATEGORY_BUCKET_COUNT; bit++, category_mask >>= 1)
+	{
+		if (category_mask & 1)
+		{
+			CategoryBuckets[bit][id] = object;
+		}
+	}
+}
+
+/**
+ * Take an object out of its buckets.  Only done once the manager no longer
+ * lists it, by which time its listeners are gone.
+ */
+void ObjectQueryIndexClass::Remove_Object(ObjectIDType id)
+{
+	EntryListType::iterator it = Entries.find(id);
+	if (it == Entries.end()) return;
+
+	const EntryStruct &entry = it->second;
+	AllObjects.erase(id);
+	TypeBuckets[entry.Type].erase(id);
+	OwnerBuckets[entry.Owner].erase(id);
+
+	unsigned int category_mask = (unsigned int)entry.Type->Get_Category_Mask();
+	for (int bit = 0; category_mask && bit < CATEGORY_BUCKET_COUNT; bit++, category_mask >>= 1)
+	{
+		if (category_mask & 1)
+		{
+			CategoryBuckets[bit].erase(id);
+		}
+	}
+
+	Entries.erase(it);
+}
+
+/**
+ * Stop listening to the indexed objects and empty every bucket.  Objects
+ * of a mode that is gone took their listeners with them.
+ */
+void ObjectQueryIndexClass::Release_Objects(void)
+{
+	if (ObjectSetStampClass::Is_Live_Mode(Mode))
+	{
+		GameObjectManagerClass &manager = Mode->Get_Object_Manager();
+		EntryListType::iterator it = Entries.begin();
+		for (; it != Entries.end(); it++)
+		{
+			if (it->second.Listening && manager.Get_Object_From_ID(it->first) == it->second.Object)
+			{
+				SignalDispatcherClass::Get().Remove_Listener(it->second.Object, this, PG_SIGNAL_OBJECT_DELETE_PENDING);
+				SignalDispatcherClass::Get().Remove_Listener(it->second.Object, this, PG_SIGNAL_OBJECT_OWNER_CHANGED);
+			}
+		}
+	}
+
+	Entries.clear();
+	Deleted.resize(0);
+	OwnerChanged.resize(0);
+	AllObjects.clear();
+	TypeBuckets.clear();
+	OwnerBuckets.clear();
+	for (int bit = 0; bit < CATEGORY_BUCKET_COUNT; bit++)
+	{
+		CategoryBuckets[bit].clear();
+	}
+}
+
+/**
+ * Index every object of a mode.
+ * 
+ * @param mode   mode to index
+ */
+void ObjectQueryIndexClass::Build(GameModeClass *mode)
+{
+	Release_Objects();
+	Mode = mode;
+	RebuildCount++;
+
+	if (!mode) return;
+
+	ReferenceListIterator<GameObjectClass> object_list = mode->Get_Object_Manager().Get_Object_Iterator();
+	for (object_list.First(); object_list.Is_Done() == false; object_list.Next())
+	{
+		Add_Object(object_list.Current_Object());
+	}
+}
+
+/**
+ * The filter FindAllObjectsOfType has always applied to each object.
+ */
+bool ObjectQueryIndexClass::Matches(GameObjectClass *object, PlayerClass *player, const GameObjectTypeClass *type,
+	GameObjectPropertiesType property_filter, GameObjectCategoryType category_filter)
+{
+	if (player && player != object->Get_Owner_Player())
+	{
+		return false;
+	}
+
+	if (type && object->Get_Original_Object_Type() != type)
+	{
+		return false;
+	}
+
+	if (property_filter != GAME_OBJECT_PROPERTIES_ALL && (property_filter & object->Get_Original_Object_Type()->Get_Property_Mask()) == 0)
+	{
+		return false;
+	}
+
+	if ((category_filter != GAME_OBJECT_CATEGORY_ALL) && (category_filter & object->Get_Original_Object_Type()->Get_Category_Mask()) == 0)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * Find all objects of the active mode that pass the given filters.  Each
+ * filter is ignored when it is NULL or ALL.
+ * 
+ * The smallest bucket that is certain to hold every match is chosen, out
+ * of the type bucket, the bucket of a category filter with a single bit
+ * and the owner bucket.  Otherwise every object is a candidate.
+ * Candidates the object manager no longer knows are dropped, and all the
+ * filters are applied to the rest.
+ * 
+ * @param player          owner to match
+ * @param type            original object type to match
+ * @param property_filter property mask, any bit matches
+ * @param category_filter category mask, any bit matches
+ * @param objects         filled with the matching objects, in ID order
+ */
+void ObjectQueryIndexClass::Find_Objects(PlayerClass *player, const GameObjectTypeClass *type, GameObjectPropertiesType property_filter,
+	GameObjectCategoryType category_filter, std::vector<GameObjectClass *> &objects)
+{
+	objects.resize(0);
+	Update();
+	if (!Mode) return;
+
+	const BucketType *bucket = &AllObjects;
+	if (type)
+	{
+		TypeBucketListType::const_iterator it = TypeBuckets.find(type);
+		if (it == TypeBuckets.end()) return;
+		bucket = &it->second;
+	}
+
+	unsigned int category_mask = (unsigned int)category_filter;
+	if (category_filter != GAME_OBJECT_CATEGORY_ALL && category_mask && (category_mask & (category_mask - 1)) == 0)
+	{
+		int bit = 0;
+		while ((category_mask >>= 1) != 0) bit++;
+		if (bit < CATEGORY_BUCKET_COUNT && CategoryBuckets[bit].size() < bucket->size())
+		{
+			bucket = &CategoryBuckets[bit];
+		}
+	}
+
+	if (player)
+	{
+		OwnerBucketListType::const_iterator it = OwnerBuckets.find(player->Get_ID());
+		if (it == OwnerBuckets.end()) return;
+		if (it->second.size() < bucket->size())
+		{
+			bucket = &it->second;
+		}
+	}
+
+	GameObjectManagerClass &manager = Mode->Get_Object_Manager();
+	for (BucketType::const_iterator it = bucket->begin(); it != bucket->end(); it++)
+	{
+		if (manager.Get_Object_From_ID(it->first) != it->second)
+		{
+			continue;
+		}
+		if (Matches(it->second, player, type, property_filter, category_filter))
+		{
+			objects.push_back(it->second);
+		}
+	}
+}
+
+/**
+ * Walk the whole object list the way FindAllObjectsOfType used to.  Kept
+ * to measure the index against.
+ * 
+ * @param player          owner to match
+ * @param type            original object type to match
+ * @param property_filter property mask, any bit matches
+ * @param category_filter category mask, any bit matches
+ * @param objects         filled with the matching objects
+ */
+void ObjectQueryIndexClass::Find_Objects_Unindexed(PlayerClass *player, const GameObjectTypeClass *type, GameObjectPropertiesType property_filter,
+	GameObjectCategoryType category_filter, std::vector<GameObjectClass *> &objects)
+{
+	objects.resize(0);
+	GameModeClass *mode = GameModeManager.Get_Active_Mode();
+	if (!mode) return;
+
+	ReferenceListIterator<GameObjectClass> object_list = mode->Get_Object_Manager().Get_Object_Iterator();
+	for (object_list.First(); object_list.Is_Done() == false; object_list.Next())
+	{
+		GameObjectClass *object = object_list.Current_Object();
+		if (Matches(object, player, type, property_filter, category_filter))
+		{
+			objects.push_back(object);
+		}
+	}
+}
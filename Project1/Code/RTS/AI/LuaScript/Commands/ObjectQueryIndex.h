@@ -0,0 +1,125 @@
+// $Id: //depot/Projects/StarWars_Steam/FOC/Code/RTS/AI/LuaScript/Commands/ObjectQueryIndex.h#1 $
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Petroglyph Games, Inc.
+//
+//
+//  *****           **                          *                   *
+//  *   **          *                           *                   *
+//  *    *          *                           *                   *
+//  *    *          *     *                 *   *          *        *
+//  *   *     *** ******  * **  ****      ***   * *      * *****    * ***
+//  *  **    *  *   *     **   *   **   **  *   *  *    * **   **   **   *
+//  ***     *****   *     *   *     *  *    *   *  *   **  *    *   *    *
+//  *       *       *     *   *     *  *    *   *   *  *   *    *   *    *
+//  *       *       *     *   *     *  *    *   *   * **   *   *    *    *
+//  *       **       *    *   **   *   **   *   *    **    *  *     *   *
+// **        ****     **  *    ****     *****   *    **    ***      *   *
+//                                          *        *     *
+//                                          *        *     *
+//                                          *       *      *
+//                                      *  *        *      *
+//                                      ****       *       *
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// C O N F I D E N T I A L   S O U R C E   C O D E -- D O   N O T   D I S T R I B U T E
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//              $File: //depot/Projects/StarWars_Steam/FOC/Code/RTS/AI/LuaScript/Commands/ObjectQueryIndex.h $
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/** @file */
+
+#ifndef _OBJECT_QUERY_INDEX_H_
+#define _OBJECT_QUERY_INDEX_H_
+
+#include "GameObjectPropertiesType.h"
+#include "GameObjectCategoryType.h"
+#include "GameObject.h"
+#include "PGSignal/SignalListener.h"
+#include "AI/ObjectSetStamp.h"
+#include <vector>
+#include <map>
+
+class GameModeClass;
+class GameObjectTypeClass;
+class PlayerClass;
+
+/**
+ * Index of the objects in a game mode, bucketed by original object type,
+ * category bit and owner.  Lua queries that filter on those look at one
+ * bucket instead of every object in the mode.
+ * 
+ * The buckets are kept up to date in place.  Each indexed object is
+ * listened to for owner changes and deletes.  An owner change moves the
+ * object to its new owner bucket on the next query.  A deleted object
+ * stays in its buckets for as long as the object manager still lists it,
+ * which is what a walk of the object list returns, and is dropped once it
+ * is gone.  The object manager has no creation hook, so on a query where
+ * it lists more objects than the index holds, the list is walked from the
+ * end, where new objects go, until the missing ones are found.  Only a
+ * mode change indexes every object again.
+ * 
+ * Each candidate is still checked against the object manager before it
+ * is used, and all the filters are applied to it, so a bucket only ever
+ * narrows the search.  Results come back in object ID order, which is the
+ * order the objects were created in.
+ */
+class ObjectQueryIndexClass : public SignalListenerClass
+{
+public:
+
+	static ObjectQueryIndexClass &Get(void);
+
+	void Find_Objects(PlayerClass *player, const GameObjectTypeClass *type, GameObjectPropertiesType property_filter,
+		GameObjectCategoryType category_filter, std::vector<GameObjectClass *> &objects);
+	static void Find_Objects_Unindexed(PlayerClass *player, const GameObjectTypeClass *type, GameObjectPropertiesType property_filter,
+		GameObjectCategoryType category_filter, std::vector<GameObjectClass *> &objects);
+	void Invalidate(void) { Stamp.Invalidate(); }
+	int Get_Rebuild_Count(void) const { return RebuildCount; }
+	int Get_Scanned_Count(void) const { return ScannedCount; }
+
+	virtual void Receive_Signal(SignalGeneratorClass *generator, PGSignalType signal_type, SignalDataClass *data);
+
+private:
+
+	enum { CATEGORY_BUCKET_COUNT = 32 };
+
+	ObjectQueryIndexClass();
+
+	void Update(void);
+	void Build(GameModeClass *mode);
+	void Release_Objects(void);
+	void Add_Object(GameObjectClass *object);
+	void Remove_Object(ObjectIDType id);
+	void Find_New_Objects(void);
+	static bool Matches(GameObjectClass *object, PlayerClass *player, const GameObjectTypeClass *type,
+		GameObjectPropertiesType property_filter, GameObjectCategoryType category_filter);
+
+	struct EntryStruct
+	{
+		GameObjectClass					*Object;
+		const GameObjectTypeClass		*Type;
+		int									Owner;			//!< Owner bucket the object is in
+		bool									Listening;		//!< Still listening to the object's signals
+	};
+
+	typedef std::map<ObjectIDType, GameObjectClass *> BucketType;
+	typedef stdext::hash_map<ObjectIDType, EntryStruct> EntryListType;
+	typedef stdext::hash_map<const GameObjectTypeClass *, BucketType> TypeBucketListType;
+	typedef stdext::hash_map<int, BucketType> OwnerBucketListType;
+
+	GameModeClass											*Mode;
+	ObjectSetStampClass									Stamp;
+	int														RebuildCount;
+	int														ScannedCount;		//!< Objects looked at while finding new ones
+	EntryListType											Entries;
+	std::vector<ObjectIDType>							Deleted;				//!< Delete pending objects the manager may still list
+	std::vector<ObjectIDType>							OwnerChanged;
+	BucketType												AllObjects;
+	TypeBucketListType									TypeBuckets;
+	BucketType												CategoryBuckets[CATEGORY_BUCKET_COUNT];
+	OwnerBucketListType									OwnerBuckets;
+};
+
+#endif //_OBJECT_QUERY_INDEX_H_
@@ -0,0 +1,398 @@
+// $Id: //depot/Projects/StarWars_Steam/FOC/Code/RTS/AI/LuaScript/Commands/PerceptionBatch.cpp#1 $
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Petroglyph Games, Inc.
+//
+//
+//  *****           **                          *                   *
+//  *   **          *                           *                   *
+//  *    *          *                           *                   *
+//  *    *          *     *                 *   *          *        *
+//  *   *     *** ******  * **  ****      ***   * *      * *****    * ***
+//  *  **    *  *   *     **   *   **   **  *   *  *    * **   **   **   *
+//  ***     *****   *     *   *     *  *    *   *  *   **  *    *   *    *
+//  *       *       *     *   *     *  *    *   *   *  *   *    *   *    *
+//  *       *       *     *   *     *  *    *   *   * **   *   *    *    *
+//  *       **       *    *   **   *   **   *   *    **    *  *     *   *
+// **        ****     **  *    ****     *****   *    **    ***      *   *
+//                                          *        *     *
+//                                          *        *     *
+//                                          *       *      *
+//                                      *  *        *      *
+//                                      ****       *       *
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// C O N F I D E N T I A L   S O U R C E   C O D E -- D O   N O T   D I S T R I B U T E
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//              $File: //depot/Projects/StarWars_Steam/FOC/Code/RTS/AI/LuaScript/Commands/PerceptionBatch.cpp $
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/** @file */
+
+#pragma hdrstop
+
+#include "Always.h"
+
+#include "PerceptionBatch.h"
+#include "AI/Perception/AIPerceptionSystem.h"
+#include "AI/TacticalAIManager.h"
+#include "AI/AITargetLocation.h"
+#include "PerceptionFunction.h"
+#include "GameObject.h"
+#include "AI/ObjectSetStamp.h"
+#include "Player.h"
+#include "PGSignal/SignalListener.h"
+#include "PGSignal/SignalDispatcher.h"
+#include <map>
+
+/**
+ * Everything a perception function result depends on, as far as one
+ * frame is concerned.
+ */
+struct PerceptionCacheKeyStruct
+{
+	const PerceptionFunctionClass		*Function;
+	const AIPerceptionSystemClass		*PerceptionSystem;
+	const PlayerClass						*Player;
+	const AITargetLocationClass		*Target;
+	int										ObjectID;
+	PerceptionTokenType					EnemyToken;
+	PerceptionTokenType					HumanToken;
+	PerceptionTokenType					TargetToken;
+
+	bool operator<(const PerceptionCacheKeyStruct &other) const
+	{
+		if (Function != other.Function) return Function < other.Function;
+		if (PerceptionSystem != other.PerceptionSystem) return PerceptionSystem < other.PerceptionSystem;
+		if (Player != other.Player) return Player < other.Player;
+		if (Target != other.Target) return Target < other.Target;
+		if (ObjectID != other.ObjectID) return ObjectID < other.ObjectID;
+		if (EnemyToken != other.EnemyToken) return EnemyToken < other.EnemyToken;
+		if (HumanToken != other.HumanToken) return HumanToken < other.HumanToken;
+		return TargetToken < other.TargetToken;
+	}
+};
+
+/**
+ * Game state that can change within a frame and that perception functions
+ * commonly read.  A cached result is only used while it still matches.
+ */
+struct PerceptionCacheStateStruct
+{
+	int		TargetOwner;
+	float		TargetHealth;
+	float		PlayerCredits;
+	float		EnemyCredits;
+
+	bool operator==(const PerceptionCacheStateStruct &other) const
+	{
+		return TargetOwner == other.TargetOwner &&
+				 TargetHealth == other.TargetHealth &&
+				 PlayerCredits == other.PlayerCredits &&
+				 EnemyCredits == other.EnemyCredits;
+	}
+};
+
+struct PerceptionCacheEntryStruct
+{
+	float								Score;
+	bool								Evaluated;
+	PerceptionCacheStateStruct	State;
+};
+
+typedef std::map<PerceptionCacheKeyStruct, PerceptionCacheEntryStruct> PerceptionCacheType;
+
+static PerceptionCacheType		PerceptionCache;
+static ObjectSetStampClass		PerceptionCacheStamp;
+static ObjectSetStampClass		PerceptionCacheModeStamp;
+static unsigned int				PerceptionCacheHits = 0;
+static unsigned int				PerceptionCacheMisses = 0;
+
+/**
+ * Drops the perception cache when an object it holds a result for changes
+ * hands or goes delete pending.  Scores that count what each player owns
+ * move with any such change, not only the scores of that target.
+ */
+class PerceptionCacheListenerClass : public SignalListenerClass
+{
+public:
+
+	PerceptionCacheListenerClass() : Mode(NULL) {}
+
+	void Watch(GameObjectClass *object)
+	{
+		if (!object || object->Is_Delete_Pending() || Watched.find(object) != Watched.end())
+		{
+			return;
+		}
+		if (Watched.empty())
+		{
+			Mode = GameModeManager.Get_Active_Mode();
+		}
+		Watched[object] = object->Get_ID();
+		SignalDispatcherClass::Get().Add_Listener(object, this, PG_SIGNAL_OBJECT_OWNER_CHANGED);
+		SignalDispatcherClass::Get().Add_Listener(object, this, PG_SIGNAL_OBJECT_DELETE_PENDING);
+	}
+
+	/**
+	 * Stop watching every object.  Objects of a mode that is still running,
+	 * such as the galactic planets during a tactical battle, keep their
+	 * listener lists and are taken off them.  Objects of a mode that is gone
+	 * took their listeners with them.
+	 */
+	void Reset(void)
+	{
+		if (ObjectSetStampClass::Is_Live_Mode(Mode))
+		{
+			GameObjectManagerClass &manager = Mode->Get_Object_Manager();
+			WatchedListType::iterator it = Watched.begin();
+			for (; it != Watched.end(); it++)
+			{
+				if (manager.Get_Object_From_ID(it->second) == it->first)
+				{
+					SignalDispatcherClass::Get().Remove_Listener(it->first, this, PG_SIGNAL_OBJECT_OWNER_CHANGED);
+					SignalDispatcherClass::Get().Remove_Listener(it->first, this, PG_SIGNAL_OBJECT_DELETE_PENDING);
+				}
+			}
+		}
+		Watched.clear();
+		Mode = NULL;
+	}
+
+	virtual void Receive_Signal(SignalGeneratorClass *generator, PGSignalType signal_type, SignalDataClass *)
+	{
+		if (signal_type == PG_SIGNAL_OBJECT_OWNER_CHANGED || signal_type == PG_SIGNAL_OBJECT_DELETE_PENDING)
+		{
+			SignalDispatcherClass::Get().Remove_Listener(generator, this, PG_SIGNAL_OBJECT_OWNER_CHANGED);
+			SignalDispatcherClass::Get().Remove_Listener(generator, this, PG_SIGNAL_OBJECT_DELETE_PENDING);
+			Watched.erase(static_cast<GameObjectClass *>(generator));
+			PerceptionCache.clear();
+		}
+	}
+
+private:
+
+	typedef stdext::hash_map<GameObjectClass *, int> WatchedListType;
+
+	WatchedListType	Watched;
+	GameModeClass		*Mode;
+};
+
+static PerceptionCacheListenerClass PerceptionCacheListener;
+
+/**
+ * Drop the cached results if the frame, the active mode or the number of
+ * objects has changed since they were stored.  A new mode also reports and
+ * resets the hit and miss counts in debug builds.
+ */
+static void Update_Perception_Cache(void)
+{
+	if (PerceptionCacheModeStamp.Refresh(ObjectSetStampClass::CHECK_MODE_ONLY))
+	{
+		PerceptionCacheListener.Reset();
+#ifndef NDEBUG
+		if (PerceptionCacheHits + PerceptionCacheMisses)
+		{
+			Debug_Printf("Perception cache: %u hits, %u misses, %.1f%% of evaluations saved\n", PerceptionCacheHits, PerceptionCacheMisses,
+				100.0f * PerceptionCacheHits / (PerceptionCacheHits + PerceptionCacheMisses));
+		}
+#endif
+		PerceptionCacheHits = 0;
+		PerceptionCacheMisses = 0;
+	}
+
+	if (PerceptionCacheStamp.Refresh())
+	{
+		PerceptionCache.clear();
+	}
+}
+
+/**
+ * @return the game object a candidate scores, if any
+ */
+static GameObjectClass *Get_Candidate_Object(const PerceptionCandidateStruct &candidate)
+{
+	if (candidate.Object)
+	{
+		return candidate.Object;
+	}
+	return candidate.Target ? candidate.Target->Get_Target_Game_Object() : NULL;
+}
+
+/**
+ * Snapshot the state a cached result for a candidate depends on.
+ */
+static void Get_Perception_Cache_State(const PerceptionCandidateStruct &candidate, PlayerClass *player, PlayerClass *enemy,
+	PerceptionCacheStateStruct &state)
+{
+	GameObjectClass *object = Get_Candidate_Object(candidate);
+	state.TargetOwner = object ? object->Get_Owner() : -1;
+	state.TargetHealth = object ? object->Get_Health() : 0.0f;
+	state.PlayerCredits = player->Get_Credits();
+	state.EnemyCredits = enemy ? enemy->Get_Credits() : 0.0f;
+}
+
+/**
+ * Build the shared context for a batch.
+ * 
+ * @param perception_system perception system to evaluate against
+ * @param player            player doing the evaluation
+ */
+PerceptionBatchClass::PerceptionBatchClass(AIPerceptionSystemClass *perception_system, PlayerClass *player) :
+	PerceptionSystem(perception_system),
+	Player(player),
+	Enemy(NULL),
+	EnemyToken(PERCEPTION_TOKEN_INVALID),
+	HumanToken(PERCEPTION_TOKEN_INVALID),
+	SharedContext(perception_system)
+{
+	assert(perception_system);
+	assert(player);
+
+	SharedContext.Add_Context(PERCEPTION_TOKEN_VARIABLE_SELF, player->Get_Evaluator_Token());
+	if (perception_system->Get_Manager()->Get_Enemy())
+	{
+		Enemy = perception_system->Get_Manager()->Get_Enemy();
+		EnemyToken = Enemy->Get_Evaluator_Token();
+		SharedContext.Add_Context(PERCEPTION_TOKEN_VARIABLE_ENEMY, EnemyToken);
+	}
+	PlayerClass *human = PlayerList.Get_Human_Player();
+	if (human)
+	{
+		HumanToken = human->Get_Evaluator_Token();
+		SharedContext.Add_Context(PERCEPTION_TOKEN_VARIABLE_HUMAN, HumanToken);
+	}
+	SharedContext.Set_Player(player);
+}
+
+/**
+ * Add an AI target location to the batch.
+ * 
+ * @param target target to score
+ */
+void PerceptionBatchClass::Add_Target(const AITargetLocationClass *target)
+{
+	assert(target);
+
+	Candidates.resize(Candidates.size() + 1);
+	PerceptionCandidateStruct &candidate = Candidates.back();
+	candidate.Target = target;
+	candidate.TargetToken = target->Get_Evaluator();
+}
+
+/**
+ * Add a game object to the batch.
+ * 
+ * @param object object to score
+ * @return false if the object is dead and was not added
+ */
+bool PerceptionBatchClass::Add_Object(GameObjectClass *object)
+{
+	if (!object)
+	{
+		return false;
+	}
+
+	Candidates.resize(Candidates.size() + 1);
+	PerceptionCandidateStruct &candidate = Candidates.back();
+	candidate.Object = object;
+	candidate.ObjectID = object->Get_ID();
+	if (object->Behaves_Like(BEHAVIOR_PLANET))
+	{
+		candidate.TargetToken = object->Get_Planetary_Data()->Get_Evaluator_Token();
+	}
+	return true;
+}
+
+/**
+ * Add a candidate with no target, for functions that only look at the
+ * players.
+ */
+void PerceptionBatchClass::Add_No_Target(void)
+{
+	Candidates.resize(Candidates.size() + 1);
+}
+
+/**
+ * Score every candidate in the batch with a perception function.
+ * 
+ * @param function perception function to evaluate
+ */
+void PerceptionBatchClass::Evaluate(PerceptionFunctionClass *function)
+{
+	assert(function);
+
+	Update_Perception_Cache();
+
+	PerceptionCacheKeyStruct key;
+	key.Function = function;
+	key.PerceptionSystem = PerceptionSystem;
+	key.Player = Player;
+	key.EnemyToken = EnemyToken;
+	key.HumanToken = HumanToken;
+
+	PerceptionCacheStateStruct state;
+	for (unsigned int i = 0; i < Candidates.size(); ++i)
+	{
+		PerceptionCandidateStruct &candidate = Candidates[i];
+
+		key.Target = candidate.Target;
+		key.ObjectID = candidate.ObjectID;
+		key.TargetToken = candidate.TargetToken;
+		Get_Perception_Cache_State(candidate, Player, Enemy, state);
+		PerceptionCacheType::const_iterator it = PerceptionCache.find(key);
+		if (it != PerceptionCache.end() && it->second.State == state)
+		{
+			candidate.Score = it->second.Score;
+			candidate.Evaluated = it->second.Evaluated;
+			PerceptionCacheHits++;
+			continue;
+		}
+
+		PerceptionContextClass perception_context(SharedContext);
+		if (candidate.Object && candidate.TargetToken == PERCEPTION_TOKEN_INVALID)
+		{
+			perception_context.Add_Context(PERCEPTION_TOKEN_VARIABLE_TARGET, AIPerceptionSystemClass::Build_Game_Object_Token_String(candidate.Object));
+		}
+		else if (candidate.Target || candidate.Object)
+		{
+			perception_context.Add_Context(PERCEPTION_TOKEN_VARIABLE_TARGET, candidate.TargetToken);
+		}
+		if (candidate.Target)
+		{
+			perception_context.Set_Target(candidate.Target);
+		}
+
+		candidate.Score = 0.0f;
+		candidate.Evaluated = function->Evaluate(perception_context, candidate.Score);
+		PerceptionCacheMisses++;
+
+		PerceptionCacheEntryStruct &entry = PerceptionCache[key];
+		entry.Score = candidate.Score;
+		entry.Evaluated = candidate.Evaluated;
+		entry.State = state;
+		PerceptionCacheListener.Watch(Get_Candidate_Object(candidate));
+	}
+}
+
+/**
+ * Find the candidate with the highest positive score.  Ties go to the
+ * candidate added first.
+ * 
+ * @return index of the best candidate, or -1 if nothing scored above zero
+ */
+int PerceptionBatchClass::Get_Best_Index(void) const
+{
+	float best_score = 0.0f;
+	int best_index = -1;
+	for (unsigned int i = 0; i < Candidates.size(); ++i)
+	{
+		if (Candidates[i].Score > best_score)
+		{
+			best_score = Candidates[i].Score;
+			best_index = static_cast<int>(i);
+		}
+	}
+	return best_index;
+}
@@ -0,0 +1,121 @@
+// $Id: //depot/Projects/StarWars_Steam/FOC/Code/RTS/AI/LuaScript/Commands/PerceptionBatch.h#1 $
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Petroglyph Games, Inc.
+//
+//
+//  *****           **                          *                   *
+//  *   **          *                           *                   *
+//  *    *          *                           *                   *
+//  *    *          *     *                 *   *          *        *
+//  *   *     *** ******  * **  ****      ***   * *      * *****    * ***
+//  *  **    *  *   *     **   *   **   **  *   *  *    * **   **   **   *
+//  ***     *****   *     *   *     *  *    *   *  *   **  *    *   *    *
+//  *       *       *     *   *     *  *    *   *   *  *   *    *   *    *
+//  *       *       *     *   *     *  *    *   *   * **   *   *    *    *
+//  *       **       *    *   **   *   **   *   *    **    *  *     *   *
+// **        ****     **  *    ****     *****   *    **    ***      *   *
+//                                          *        *     *
+//                                          *        *     *
+//                                          *       *      *
+//                                      *  *        *      *
+//                                      ****       *       *
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// C O N F I D E N T I A L   S O U R C E   C O D E -- D O   N O T   D I S T R I B U T E
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//              $File: //depot/Projects/StarWars_Steam/FOC/Code/RTS/AI/LuaScript/Commands/PerceptionBatch.h $
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/** @file */
+
+#ifndef _PERCEPTION_BATCH_H_
+#define _PERCEPTION_BATCH_H_
+
+#include "AI/Perception/PerceptionContext.h"
+#include <vector>
+
+class AIPerceptionSystemClass;
+class AITargetLocationClass;
+class GameObjectClass;
+class PerceptionFunctionClass;
+class PlayerClass;
+
+/**
+ * One target in a perception batch, with its target token and the result
+ * of the last evaluation.  Object tokens that need a string are only built
+ * when the candidate is actually evaluated.
+ */
+struct PerceptionCandidateStruct
+{
+	PerceptionCandidateStruct() :
+		Target(NULL),
+		Object(NULL),
+		ObjectID(-1),
+		TargetToken(PERCEPTION_TOKEN_INVALID),
+		Score(0.0f),
+		Evaluated(false)
+	{}
+
+	const AITargetLocationClass	*Target;
+	GameObjectClass					*Object;
+	int									ObjectID;
+	PerceptionTokenType				TargetToken;
+	float									Score;
+	bool									Evaluated;
+};
+
+/**
+ * Scores a list of targets with one perception function.
+ * 
+ * The SELF, ENEMY and HUMAN variables are the same for every target, so they
+ * go into a shared context once when the batch is built.  Each evaluation
+ * copies that context and adds only the target.  Object target token
+ * strings are only built for candidates the cache can't answer.
+ * 
+ * Candidates are evaluated in the order they were added, on the calling
+ * thread.  Perception evaluators update their own caches as they run, so
+ * they are not safe to share across threads.
+ * 
+ * Results are remembered for the rest of the frame, keyed by function,
+ * perception system, the context tokens and the target.  Many plan scripts
+ * ask the same question in a frame and only the first pays for it.  The
+ * cache is dropped when the frame, the active mode or the object count
+ * changes, and when an object it holds a result for changes hands or goes
+ * delete pending.  Each result also remembers the target's owner and
+ * health and the credits of the player and its enemy, and is evaluated
+ * again if any of them moved.  Every machine runs the same scripts in the
+ * same order, so hits are the same everywhere and the results stay in
+ * sync.
+ * 
+ * Debug builds print the hit and miss counts when the active mode changes.
+ */
+class PerceptionBatchClass
+{
+public:
+
+	PerceptionBatchClass(AIPerceptionSystemClass *perception_system, PlayerClass *player);
+
+	void Add_Target(const AITargetLocationClass *target);
+	bool Add_Object(GameObjectClass *object);
+	void Add_No_Target(void);
+
+	void Evaluate(PerceptionFunctionClass *function);
+
+	unsigned int Get_Count(void) const { return Candidates.size(); }
+	const PerceptionCandidateStruct &Get_Candidate(unsigned int index) const { return Candidates[index]; }
+	int Get_Best_Index(void) const;
+
+private:
+
+	AIPerceptionSystemClass					*PerceptionSystem;
+	PlayerClass									*Player;
+	PlayerClass									*Enemy;
+	PerceptionTokenType						EnemyToken;
+	PerceptionTokenType						HumanToken;
+	PerceptionContextClass					SharedContext;
+	std::vector<PerceptionCandidateStruct>	Candidates;
+};
+
+#endif //_PERCEPTION_BATCH_H_
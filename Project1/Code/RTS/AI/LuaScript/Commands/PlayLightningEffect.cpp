@@ -116,7 +116,7 @@ LuaTable *PlayLightningEffectClass::Function_Call(LuaScriptClass *script, LuaTab
 }
 
 /**************************************************************************************************
-* LightningEffectBlockStatus::Is_Finished -- Check whether this lightning effect is done.
+* LightningEffectBlockStatus::Poll_Finished -- Check whether this lightning effect is done.
 *
 * In:				
 *
@@ -124,7 +124,20 @@ LuaTable *PlayLightningEffectClass::Function_Call(LuaScriptClass *script, LuaTab
 *
 * History: 8/15/2005 7:18PM JSY
 **************************************************************************************************/
-LuaTable *LightningEffectBlockStatus::Is_Finished(LuaScriptClass *, LuaTable *)
+bool LightningEffectBlockStatus::Poll_Finished(LuaScriptClass *)
 {
-	return Return_Variable(new LuaBool(!Effect || Effect->Is_Done()));
-}
\ No newline at end of file
+	return !Effect || Effect->Is_Done();
+}
+
+/**************************************************************************************************
+* LightningEffectBlockStatus::Is_Finished -- Lua version of Poll_Finished
+*
+* In:			
+*
+* Out:		
+*
+**************************************************************************************************/
+LuaTable *LightningEffectBlockStatus::Is_Finished(LuaScriptClass *script, LuaTable *)
+{
+	return Return_Variable(new LuaBool(Poll_Finished(script)));
+}
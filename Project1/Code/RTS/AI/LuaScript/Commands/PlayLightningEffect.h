@@ -65,6 +65,7 @@ public:
 
 	void Init(LuaUserVar *command, LightningEffectClass *effect)					{ Set_Command(command); Effect = effect; }
 	virtual LuaTable *Is_Finished(LuaScriptClass *, LuaTable *);
+	virtual bool Poll_Finished(LuaScriptClass *script);
 	virtual LuaTable *Result(LuaScriptClass *, LuaTable *)							{ return NULL; }
 
 	//Leave Save/Load using base class implementation.  Lightning effects are not saveable, so if we save a game
@@ -76,21 +76,25 @@ void PoliticalControlBlockStatus::Init(GameObjectClass *planet, const double &co
  * Checks whether to stop blocking
  * 
  * @param script		Unused
- * @param params		Unused
  *
  * @return				Whether the waiting object has achieved the desired level of political
  *							control over the planet.
  * @since 5/18/2004 11:40AM -- JSY
  */
-LuaTable* PoliticalControlBlockStatus::Is_Finished(LuaScriptClass *, LuaTable *)
+bool PoliticalControlBlockStatus::Poll_Finished(LuaScriptClass *)
 {	
 	if (Planet->Get_Allegiance().Get_Current_Allegiance() >= Control)
 	{
 		bool aligned = Planet->Get_Allegiance().Is_Aligned_With(WaitingAllegiance);
-		return Return_Variable(new LuaBool(Control > 0 ? aligned : !aligned));
+		return Control > 0 ? aligned : !aligned;
 	}
 
-	return Return_Variable(new LuaBool(false));
+	return false;
+}
+
+LuaTable* PoliticalControlBlockStatus::Is_Finished(LuaScriptClass *script, LuaTable *)
+{
+	return Return_Variable(new LuaBool(Poll_Finished(script)));
 }
 
 LuaTable* PoliticalControlBlockStatus::Result(LuaScriptClass *, LuaTable *)
@@ -67,6 +67,7 @@ public:
 	PoliticalControlBlockStatus();
 	void Init(GameObjectClass *planet, const double &control, const AllegianceClass &waiting_allegiance);
 	virtual LuaTable* Is_Finished(LuaScriptClass *, LuaTable *);
+	virtual bool Poll_Finished(LuaScriptClass *script);
 	virtual bool Save(LuaScriptClass *, ChunkWriterClass *writer);
 	virtual bool Load(LuaScriptClass *, ChunkReaderClass *reader);
 	virtual LuaTable* Result(LuaScriptClass *, LuaTable *);
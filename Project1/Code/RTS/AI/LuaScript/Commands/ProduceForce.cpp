@@ -82,9 +82,14 @@ void ProduceForceBlockStatus::Init(LuaUserVar *command)
 	Set_Command(command);
 }
 
-LuaTable* ProduceForceBlockStatus::Is_Finished(LuaScriptClass *, LuaTable *)
+bool ProduceForceBlockStatus::Poll_Finished(LuaScriptClass *)
 {
-	return Return_Variable(new LuaBool(Internal_Is_Finished()));
+	return Internal_Is_Finished();
+}
+
+LuaTable* ProduceForceBlockStatus::Is_Finished(LuaScriptClass *script, LuaTable *)
+{
+	return Return_Variable(new LuaBool(Poll_Finished(script)));
 }
 
 bool ProduceForceBlockStatus::Internal_Is_Finished(void)
@@ -63,6 +63,7 @@ public:
 	void Init(LuaUserVar *command);
 	void Add_Build_Task(AIBuildTaskClass *task);
 	virtual LuaTable* Is_Finished(LuaScriptClass *, LuaTable *);
+	virtual bool Poll_Finished(LuaScriptClass *script);
 	virtual bool Save(LuaScriptClass *, ChunkWriterClass *writer);
 	virtual bool Load(LuaScriptClass *, ChunkReaderClass *reader);
 	bool Internal_Is_Finished(void);
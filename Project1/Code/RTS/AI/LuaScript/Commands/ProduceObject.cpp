@@ -114,6 +114,9 @@ public:
 		return Return_Variable(new LuaBool(HasBegun && bIsFinished));
 	}
 
+	virtual bool Poll_Finished(LuaScriptClass *) { return HasBegun && bIsFinished; }
+	virtual bool Signals_Completion(void) const { return true; }
+
 	virtual bool Save(LuaScriptClass *script, ChunkWriterClass *writer)
 	{
 		assert(writer != NULL);
@@ -223,6 +226,11 @@ public:
 			default:
 				return;
 		}
+
+		if (HasBegun && bIsFinished)
+		{
+			Signal_Finished();
+		}
 	}
 
 private:
@@ -249,7 +249,7 @@ void ReinforceBlockStatus::Init(LuaUserVar *command, int transport_count, bool r
 }
 
 /**************************************************************************************************
-* ReinforceBlockStatus::Is_Finished -- Lua function that specifies whether our block is over
+* ReinforceBlockStatus::Poll_Finished -- Specifies whether our block is over
 *
 * In:		
 *
@@ -257,7 +257,7 @@ void ReinforceBlockStatus::Init(LuaUserVar *command, int transport_count, bool r
 *
 * History: 12/1/2004 4:49PM JSY
 **************************************************************************************************/
-LuaTable *ReinforceBlockStatus::Is_Finished(LuaScriptClass *, LuaTable*)
+bool ReinforceBlockStatus::Poll_Finished(LuaScriptClass *)
 { 
 	bool is_finished = (TransportCount == 0);
 
@@ -271,7 +271,20 @@ LuaTable *ReinforceBlockStatus::Is_Finished(LuaScriptClass *, LuaTable*)
 			tf->Get_Plan()->Set_As_Goal_System_Removable(CanPlanBeAbandoned);
 		}
 	}
-	return Return_Variable(new LuaBool(is_finished)); 
+	return is_finished; 
+}
+
+/**************************************************************************************************
+* ReinforceBlockStatus::Is_Finished -- Lua version of Poll_Finished
+*
+* In:			
+*
+* Out:		
+*
+**************************************************************************************************/
+LuaTable *ReinforceBlockStatus::Is_Finished(LuaScriptClass *script, LuaTable *)
+{
+	return Return_Variable(new LuaBool(Poll_Finished(script)));
 }
 
 enum
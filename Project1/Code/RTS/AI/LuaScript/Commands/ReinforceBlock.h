@@ -60,6 +60,7 @@ public:
 	void Remove_Land_Point(void);
 	void Init(LuaUserVar *command, int transport_count, bool result, LuaScriptClass *script, const Vector3 &land_point);
 	virtual LuaTable *Is_Finished(LuaScriptClass *, LuaTable *);
+	virtual bool Poll_Finished(LuaScriptClass *script);
 
 	virtual bool Save(LuaScriptClass *script, ChunkWriterClass *writer);
 	virtual bool Load(LuaScriptClass *script, ChunkReaderClass *reader);
@@ -46,8 +46,13 @@
 
 
 PG_IMPLEMENT_RTTI(LuaSFXCommandsClassClass, LuaUserVar);
+LUA_IMPLEMENT_MEMBER_TABLE(LuaSFXCommandsClassClass, LuaUserVar);
 
 LuaSFXCommandsClassClass::LuaSFXCommandsClassClass()
+{
+}
+
+void LuaSFXCommandsClassClass::Register_Members(LuaMemberTableClass *table)
 {
 	LUA_REGISTER_MEMBER_FUNCTION(LuaSFXCommandsClassClass, "Allow_Localized_SFXEvents", &LuaSFXCommandsClassClass::Allow_Localized_SFXEvents);
 	LUA_REGISTER_MEMBER_FUNCTION(LuaSFXCommandsClassClass, "Allow_Unit_Reponse_VO", &LuaSFXCommandsClassClass::Allow_Unit_Reponse_VO);
@@ -49,6 +49,7 @@ class LuaSFXCommandsClassClass : public LuaUserVar
 {
 public:
 	PG_DECLARE_RTTI();
+	LUA_DECLARE_MEMBER_TABLE(LuaSFXCommandsClassClass);
 	LuaSFXCommandsClassClass();
 	virtual LuaTable* Function_Call(LuaScriptClass *script, LuaTable *params);
 	LuaTable *Allow_Localized_SFXEvents(LuaScriptClass *script, LuaTable *params);
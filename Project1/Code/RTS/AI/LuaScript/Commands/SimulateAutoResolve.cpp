@@ -0,0 +1,176 @@
+// $Id: //depot/Projects/StarWars_Steam/FOC/Code/RTS/AI/LuaScript/Commands/SimulateAutoResolve.cpp#1 $
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Petroglyph Games, Inc.
+//
+//
+//  *****           **                          *                   *
+//  *   **          *                           *                   *
+//  *    *          *                           *                   *
+//  *    *          *     *                 *   *          *        *
+//  *   *     *** ******  * **  ****      ***   * *      * *****    * ***
+//  *  **    *  *   *     **   *   **   **  *   *  *    * **   **   **   *
+//  ***     *****   *     *   *     *  *    *   *  *   **  *    *   *    *
+//  *       *       *     *   *     *  *    *   *   *  *   *    *   *    *
+//  *       *       *     *   *     *  *    *   *   * **   *   *    *    *
+//  *       **       *    *   **   *   **   *   *    **    *  *     *   *
+// **        ****     **  *    ****     *****   *    **    ***      *   *
+//                                          *        *     *
+//                                          *        *     *
+//                                          *       *      *
+//                                      *  *        *      *
+//                                      ****       *       *
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// C O N F I D E N T I A L   S O U R C E   C O D E -- D O   N O T   D I S T R I B U T E
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//              $File: //depot/Projects/StarWars_Steam/FOC/Code/RTS/AI/LuaScript/Commands/SimulateAutoResolve.cpp $
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/** @file */
+
+#pragma hdrstop
+
+#include "SimulateAutoResolve.h"
+#include "AI/LuaScript/GameObjectWrapper.h"
+#include "AI/LuaScript/GameObjectTypeWrapper.h"
+#include "AI/LuaScript/PlayerWrapper.h"
+#include "AutoResolveSimulation.h"
+#include "GameObject.h"
+#include "GameObjectType.h"
+#include "Player.h"
+#include "Faction.h"
+
+PG_IMPLEMENT_RTTI(SimulateAutoResolveClass, LuaUserVar);
+
+/**
+ * Predict an auto resolved battle for the galactic AI, or for balancing from
+ * the console.  Each unit list holds object types or game objects; an object
+ * counts as its type, except that whether it carries a named hero is taken
+ * from the object.  Nothing in the game is touched and SyncRandom isn't drawn
+ * from, so the same call gives the same answer on every machine.
+ * 
+ * @param script script calling the function
+ * @param params attacker, attacker_units, defender, defender_units, is_space, [trials], [seed]
+ * 
+ * @return whether the attacker wins, then the chance the attacker is wiped
+ *         out and its average surviving combat power, then the same for the
+ *         defender.
+ */
+LuaTable *SimulateAutoResolveClass::Function_Call(LuaScriptClass *script, LuaTable *params)
+{
+	if (params->Value.size() < 5 || params->Value.size() > 7)
+	{
+		script->Script_Error("Simulate_Auto_Resolve -- invalid number of parameters.  Expected 5 to 7, got %d.", params->Value.size());
+		return NULL;
+	}
+
+	SmartPtr<PlayerWrapper> attacker = PG_Dynamic_Cast<PlayerWrapper>(params->Value[0]);
+	SmartPtr<PlayerWrapper> defender = PG_Dynamic_Cast<PlayerWrapper>(params->Value[2]);
+	if (!attacker || !attacker->Get_Object() || !defender || !defender->Get_Object())
+	{
+		script->Script_Error("Simulate_Auto_Resolve -- invalid type for parameters 1 and 3.  Expected players.");
+		return NULL;
+	}
+
+	SmartPtr<LuaTable> attacker_units = PG_Dynamic_Cast<LuaTable>(params->Value[1]);
+	SmartPtr<LuaTable> defender_units = PG_Dynamic_Cast<LuaTable>(params->Value[3]);
+	if (!attacker_units || !defender_units)
+	{
+		script->Script_Error("Simulate_Auto_Resolve -- invalid type for parameters 2 and 4.  Expected lua tables of units or unit types.");
+		return NULL;
+	}
+
+	SmartPtr<LuaBool> is_space = PG_Dynamic_Cast<LuaBool>(params->Value[4]);
+	if (!is_space)
+	{
+		script->Script_Error("Simulate_Auto_Resolve -- invalid type for parameter 5.  Expected boolean.");
+		return NULL;
+	}
+
+	int trials = 100;
+	if (params->Value.size() > 5)
+	{
+		SmartPtr<LuaNumber> lua_trials = PG_Dynamic_Cast<LuaNumber>(params->Value[5]);
+		if (!lua_trials || lua_trials->Value < 1.0f)
+		{
+			script->Script_Error("Simulate_Auto_Resolve -- invalid type for parameter 6.  Expected a trial count of at least 1.");
+			return NULL;
+		}
+		trials = (int)lua_trials->Value;
+	}
+
+	unsigned int seed = 0;
+	if (params->Value.size() > 6)
+	{
+		SmartPtr<LuaNumber> lua_seed = PG_Dynamic_Cast<LuaNumber>(params->Value[6]);
+		if (!lua_seed)
+		{
+			script->Script_Error("Simulate_Auto_Resolve -- invalid type for parameter 7.  Expected number.");
+			return NULL;
+		}
+		seed = (unsigned int)lua_seed->Value;
+	}
+
+	AutoResolveSimulationClass simulation(is_space->Value);
+	if (!Add_Units(script, simulation, 0, attacker->Get_Object(), attacker_units) ||
+		 !Add_Units(script, simulation, 1, defender->Get_Object(), defender_units))
+	{
+		return NULL;
+	}
+	simulation.Set_Aggressor(0);
+
+	AutoResolveSimulationClass::OutcomeStruct outcome;
+	simulation.Simulate(trials, seed, outcome);
+
+	LuaTable *retval = Alloc_Lua_Table();
+	retval->Value.push_back(new LuaBool(outcome.Winner == 0));
+	retval->Value.push_back(new LuaNumber(outcome.WipedOutChance[0]));
+	retval->Value.push_back(new LuaNumber(outcome.SurvivingPower[0]));
+	retval->Value.push_back(new LuaNumber(outcome.WipedOutChance[1]));
+	retval->Value.push_back(new LuaNumber(outcome.SurvivingPower[1]));
+	return retval;
+}
+
+/**
+ * Add a script's list of units and unit types to one side of a simulation.
+ * 
+ * @param script     script calling Simulate_Auto_Resolve
+ * @param simulation simulation to fill in
+ * @param side       side index, 0 for the attacker
+ * @param player     player the units fight for
+ * @param units      lua table of game objects and object types
+ * 
+ * @return false if the table held anything else, which has been reported.
+ */
+bool SimulateAutoResolveClass::Add_Units(LuaScriptClass *script, AutoResolveSimulationClass &simulation, int side, PlayerClass *player,
+													  LuaTable *units)
+{
+	AutoResolveSimulationClass::SideStruct &side_data = simulation.Get_Side(side);
+	side_data.Playable = player->Get_Faction()->Is_Playable();
+	side_data.Human = player->Is_Human();
+
+	for (int i = 0; i < (int)units->Value.size(); ++i)
+	{
+		SmartPtr<GameObjectTypeWrapper> lua_type = PG_Dynamic_Cast<GameObjectTypeWrapper>(units->Value[i]);
+		if (lua_type && lua_type->Get_Object())
+		{
+			simulation.Add_Type(side, lua_type->Get_Object(), 1, player->Get_Tech_Level());
+			continue;
+		}
+
+		SmartPtr<GameObjectWrapper> lua_object = PG_Dynamic_Cast<GameObjectWrapper>(units->Value[i]);
+		if (lua_object && lua_object->Get_Object())
+		{
+			GameObjectClass *object = lua_object->Get_Object();
+			simulation.Add_Type(side, object->Get_Original_Object_Type(), 1, player->Get_Tech_Level());
+			side_data.Units.back().Hero = object->Contains_Named_Hero();
+			continue;
+		}
+
+		script->Script_Error("Simulate_Auto_Resolve -- entry %d of the unit list for side %d is not a unit or unit type.", i + 1, side + 1);
+		return false;
+	}
+	return true;
+}
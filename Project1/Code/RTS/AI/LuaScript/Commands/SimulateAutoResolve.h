@@ -0,0 +1,57 @@
+// $Id: //depot/Projects/StarWars_Steam/FOC/Code/RTS/AI/LuaScript/Commands/SimulateAutoResolve.h#1 $
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Petroglyph Games, Inc.
+//
+//
+//  *****           **                          *                   *
+//  *   **          *                           *                   *
+//  *    *          *                           *                   *
+//  *    *          *     *                 *   *          *        *
+//  *   *     *** ******  * **  ****      ***   * *      * *****    * ***
+//  *  **    *  *   *     **   *   **   **  *   *  *    * **   **   **   *
+//  ***     *****   *     *   *     *  *    *   *  *   **  *    *   *    *
+//  *       *       *     *   *     *  *    *   *   *  *   *    *   *    *
+//  *       *       *     *   *     *  *    *   *   * **   *   *    *    *
+//  *       **       *    *   **   *   **   *   *    **    *  *     *   *
+// **        ****     **  *    ****     *****   *    **    ***      *   *
+//                                          *        *     *
+//                                          *        *     *
+//                                          *       *      *
+//                                      *  *        *      *
+//                                      ****       *       *
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// C O N F I D E N T I A L   S O U R C E   C O D E -- D O   N O T   D I S T R I B U T E
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//              $File: //depot/Projects/StarWars_Steam/FOC/Code/RTS/AI/LuaScript/Commands/SimulateAutoResolve.h $
+//
+/** @file */
+
+#ifndef _SIMULATE_AUTO_RESOLVE_H_
+#define _SIMULATE_AUTO_RESOLVE_H_
+
+#include "AI/LuaScript/LuaRTSUtilities.h"
+
+class AutoResolveSimulationClass;
+class PlayerClass;
+
+/**
+ * Script function that predicts an auto resolved battle between two lists
+ * of units with AutoResolveSimulationClass, without starting the battle.
+ * 
+ * Simulate_Auto_Resolve(attacker, attacker_units, defender, defender_units, is_space, trials, seed)
+ */
+class SimulateAutoResolveClass : public LuaUserVar
+{
+public:
+	PG_DECLARE_RTTI();
+
+	virtual LuaTable *Function_Call(LuaScriptClass *script, LuaTable *params);
+
+private:
+	static bool Add_Units(LuaScriptClass *script, AutoResolveSimulationClass &simulation, int side, PlayerClass *player, LuaTable *units);
+};
+
+#endif //_SIMULATE_AUTO_RESOLVE_H_
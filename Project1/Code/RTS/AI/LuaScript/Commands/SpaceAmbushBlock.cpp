@@ -367,7 +367,7 @@ void SpaceAmbushBlockStatus::Receive_Signal(SignalGeneratorClass *gen, PGSignalT
 }
 
 /**************************************************************************************************
-* SpaceAmbushBlockStatus::Is_Finished -- Script function to determine whether the operation is complete.
+* SpaceAmbushBlockStatus::Poll_Finished -- Determine whether the operation is complete.
 *	Also runs the update logic.
 *
 * In:			
@@ -376,7 +376,7 @@ void SpaceAmbushBlockStatus::Receive_Signal(SignalGeneratorClass *gen, PGSignalT
 *
 * History: 2/25/2005 11:30AM JSY
 **************************************************************************************************/
-LuaTable *SpaceAmbushBlockStatus::Is_Finished(LuaScriptClass *, LuaTable *)
+bool SpaceAmbushBlockStatus::Poll_Finished(LuaScriptClass *)
 {
 	if (!IsFinished)
 	{
@@ -387,7 +387,20 @@ LuaTable *SpaceAmbushBlockStatus::Is_Finished(LuaScriptClass *, LuaTable *)
 		}
 	}
 
-	return Return_Variable(new LuaBool(IsFinished));
+	return IsFinished;
+}
+
+/**************************************************************************************************
+* SpaceAmbushBlockStatus::Is_Finished -- Lua version of Poll_Finished
+*
+* In:			
+*
+* Out:		
+*
+**************************************************************************************************/
+LuaTable *SpaceAmbushBlockStatus::Is_Finished(LuaScriptClass *script, LuaTable *)
+{
+	return Return_Variable(new LuaBool(Poll_Finished(script)));
 }
 
 /**************************************************************************************************
@@ -59,6 +59,7 @@ public:
 	~SpaceAmbushBlockStatus();
 	void Init(LuaUserVar *command, GameObjectClass *target, int offset_direction, float offset_distance, float threat_tolerance);
 	virtual LuaTable* Is_Finished(LuaScriptClass *, LuaTable *);
+	virtual bool Poll_Finished(LuaScriptClass *script);
 	virtual bool Save(LuaScriptClass *, ChunkWriterClass *writer);
 	virtual bool Load(LuaScriptClass *, ChunkReaderClass *reader);
 	virtual LuaTable* Result(LuaScriptClass *, LuaTable *);
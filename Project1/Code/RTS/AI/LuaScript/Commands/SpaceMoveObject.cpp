@@ -251,11 +251,16 @@ bool SpaceMovementBlockStatus::Internal_Is_Finished(void)
 	return IsFinished;
 }
 
-LuaTable* SpaceMovementBlockStatus::Is_Finished(LuaScriptClass *, LuaTable *)
+bool SpaceMovementBlockStatus::Poll_Finished(LuaScriptClass *)
 {
 	TaskForceClass *tf = (TaskForceClass *)Get_Command();
 
-	return Return_Variable(new LuaBool(Internal_Is_Finished() || tf->Get_Force_Count() == 0));
+	return Internal_Is_Finished() || tf->Get_Force_Count() == 0;
+}
+
+LuaTable* SpaceMovementBlockStatus::Is_Finished(LuaScriptClass *script, LuaTable *)
+{
+	return Return_Variable(new LuaBool(Poll_Finished(script)));
 }
 
 enum {
@@ -68,6 +68,7 @@ public:
 	void Init(LuaUserVar *command, GameObjectClass *dest, bool attack, bool repeat, HardPointType hard_point_type, float threat_tolerance, int move_flags, SpaceCollisionType avoidance);
 	void Init(LuaUserVar *command, const Vector3 &pos, float threat_tolerance, int move_flags, SpaceCollisionType avoidance);
 	virtual LuaTable* Is_Finished(LuaScriptClass *, LuaTable *);
+	virtual bool Poll_Finished(LuaScriptClass *script);
 	bool Internal_Is_Finished(void);
 	virtual bool Save(LuaScriptClass *, ChunkWriterClass *writer);
 	virtual bool Load(LuaScriptClass *, ChunkReaderClass *reader);
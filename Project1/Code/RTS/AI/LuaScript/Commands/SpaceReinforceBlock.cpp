@@ -101,7 +101,7 @@ void SpaceReinforceBlockStatus::Init(LuaUserVar *command, const std::vector<int>
 	}
 }
 
-LuaTable *SpaceReinforceBlockStatus::Is_Finished(LuaScriptClass *, LuaTable *)
+bool SpaceReinforceBlockStatus::Poll_Finished(LuaScriptClass *)
 {
 	if (ReinforcementIndices.size() > 0)
 	{
@@ -111,7 +111,12 @@ LuaTable *SpaceReinforceBlockStatus::Is_Finished(LuaScriptClass *, LuaTable *)
 	bool timed_out = (TimeOutFrame >= 0 && FrameSynchronizer.Get_Current_Frame() >= TimeOutFrame);
 	bool all_reinforced = (ReinforcementIndices.size() == 0 && IncomingShipCount <= 0);
 
-	return Return_Variable(new LuaBool(timed_out || all_reinforced));
+	return timed_out || all_reinforced;
+}
+
+LuaTable *SpaceReinforceBlockStatus::Is_Finished(LuaScriptClass *script, LuaTable *)
+{
+	return Return_Variable(new LuaBool(Poll_Finished(script)));
 }
 
 LuaTable *SpaceReinforceBlockStatus::Result(LuaScriptClass *, LuaTable *)
@@ -56,6 +56,7 @@ public:
 	SpaceReinforceBlockStatus();
 	void Init(LuaUserVar *command, const std::vector<int> &reinforcement_indices, const Vector3 &target_position, float time_out, LuaScriptClass *script, int player_id);
 	virtual LuaTable *Is_Finished(LuaScriptClass *, LuaTable *);
+	virtual bool Poll_Finished(LuaScriptClass *script);
 	virtual LuaTable *Result(LuaScriptClass *, LuaTable *);
 	void Set_Obey_Reinforce_Rules(bool val) { ObeyReinforceRules = val; }
 
@@ -114,6 +114,10 @@ void TacticalBuildBlockStatus::Receive_Signal(SignalGeneratorClass *gen, PGSigna
 	FAIL_IF(!PendingBuilds) { return; }
 	PendingBuilds->Remove(static_cast<GameObjectClass*>(gen));
 	SignalDispatcherClass::Get().Remove_Listener(gen, this, PG_SIGNAL_OBJECT_TACTICAL_CONSTRUCTION_COMPLETE);
+	if (PendingBuilds->Is_Empty())
+	{
+		Signal_Finished();
+	}
 }
 
 enum
@@ -62,6 +62,8 @@ public:
 	void Init(LuaUserVar *command);
 	void Add_Tactical_Build(GameObjectClass *pad);
 	virtual LuaTable *Is_Finished(LuaScriptClass *script, LuaTable *params);
+	virtual bool Poll_Finished(LuaScriptClass *) { return PendingBuilds && PendingBuilds->Is_Empty(); }
+	virtual bool Signals_Completion(void) const { return true; }
 	virtual bool Save(LuaScriptClass *script, ChunkWriterClass *writer);
 	virtual bool Load(LuaScriptClass *script, ChunkReaderClass *reader);
 
@@ -69,7 +69,7 @@ void UnitAnimationBlockStatus::Init(LuaUserVar *command, ModelAnimType animation
 }
 
 /**************************************************************************************************
-* UnitAnimationBlockStatus::Is_Finished -- Check whether this block is over
+* UnitAnimationBlockStatus::Poll_Finished -- Check whether this block is over
 *
 * In:				
 *
@@ -77,17 +77,17 @@ void UnitAnimationBlockStatus::Init(LuaUserVar *command, ModelAnimType animation
 *
 * History: 7/05/2005 3:45PM JSY
 **************************************************************************************************/
-LuaTable *UnitAnimationBlockStatus::Is_Finished(LuaScriptClass *, LuaTable *)
+bool UnitAnimationBlockStatus::Poll_Finished(LuaScriptClass *)
 {
 	//If the object is dead then quit blocking
 	SmartPtr<GameObjectWrapper> object_wrapper = PG_Dynamic_Cast<GameObjectWrapper>(Get_Command());
 	if (!object_wrapper || !object_wrapper->Get_Object())
 	{
-		return Return_Variable(new LuaBool(true));		
+		return true;		
 	}
 
 	GameObjectClass *animating_object = object_wrapper->Get_Object();
-	FAIL_IF(!animating_object) { return NULL; }
+	FAIL_IF(!animating_object) { return false; }
 
 	//Block is over when either the requested animation finishes or the active animation changes.  In the case where we asked a team to animate
 	//we wait for all team members to finish.
@@ -95,7 +95,7 @@ LuaTable *UnitAnimationBlockStatus::Is_Finished(LuaScriptClass *, LuaTable *)
 	if (animating_object->Behaves_Like(BEHAVIOR_TEAM))
 	{
 		TeamBehaviorClass *team = static_cast<TeamBehaviorClass*>(animating_object->Get_Behavior(BEHAVIOR_TEAM));
-		FAIL_IF(!team) { return Return_Variable(new LuaBool(true)); }
+		FAIL_IF(!team) { return true; }
 		for (int i = 0; i < team->Get_Team_Member_Count(); ++i)
 		{
 			GameObjectClass *team_member = team->Get_Team_Member_By_Index(i);
@@ -112,7 +112,20 @@ LuaTable *UnitAnimationBlockStatus::Is_Finished(LuaScriptClass *, LuaTable *)
 						animating_object->Get_Active_Animation_State() == ANIM_STATE_DONE);
 	}
 
-	return Return_Variable(new LuaBool(all_done));
+	return all_done;
+}
+
+/**************************************************************************************************
+* UnitAnimationBlockStatus::Is_Finished -- Lua version of Poll_Finished
+*
+* In:			
+*
+* Out:		
+*
+**************************************************************************************************/
+LuaTable *UnitAnimationBlockStatus::Is_Finished(LuaScriptClass *script, LuaTable *)
+{
+	return Return_Variable(new LuaBool(Poll_Finished(script)));
 }
 
 enum
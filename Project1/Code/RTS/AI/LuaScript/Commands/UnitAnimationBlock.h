@@ -58,6 +58,7 @@ public:
 	UnitAnimationBlockStatus() : AnimationType(ANIM_INVALID) {}
 	void Init(LuaUserVar *command,  ModelAnimType animation_type);
 	virtual LuaTable *Is_Finished(LuaScriptClass *, LuaTable *);
+	virtual bool Poll_Finished(LuaScriptClass *script);
 	virtual bool Save(LuaScriptClass *script, ChunkWriterClass *writer);
 	virtual bool Load(LuaScriptClass *script, ChunkReaderClass *reader);
 	virtual LuaTable *Result(LuaScriptClass *, LuaTable *) { return NULL; }
@@ -238,6 +238,11 @@ void UnitMovementBlockStatus::Receive_Signal(SignalGeneratorClass *gen, PGSignal
 		default:
 			return;
 	}
+
+	if (IsFinished)
+	{
+		Signal_Finished();
+	}
 }
 
 /**
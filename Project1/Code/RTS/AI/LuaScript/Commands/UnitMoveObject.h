@@ -63,6 +63,8 @@ public:
 	void Init(LuaUserVar *command, LuaTable *units, GameObjectClass *target = NULL);
 	virtual LuaTable* Is_Finished(LuaScriptClass *, LuaTable *);
 	bool Internal_Is_Finished(void);
+	virtual bool Poll_Finished(LuaScriptClass *) { return IsFinished; }
+	virtual bool Signals_Completion(void) const { return true; }
 	virtual bool Save(LuaScriptClass *, ChunkWriterClass *writer);
 	virtual bool Load(LuaScriptClass *, ChunkReaderClass *reader);
 	virtual LuaTable* Result(LuaScriptClass *, LuaTable *);
@@ -51,9 +51,14 @@
 
 PG_IMPLEMENT_RTTI(WeightedTypeListClass, LuaUserVar);
 LUA_IMPLEMENT_FACTORY(LUA_CHUNK_WEIGHTED_TYPE_LIST, WeightedTypeListClass);
+LUA_IMPLEMENT_MEMBER_TABLE(WeightedTypeListClass, LuaUserVar);
 
 
 WeightedTypeListClass::WeightedTypeListClass()
+{
+}
+
+void WeightedTypeListClass::Register_Members(LuaMemberTableClass *table)
 {
 	LUA_REGISTER_MEMBER_FUNCTION(WeightedTypeListClass, "Create", &WeightedTypeListClass::Lua_Create);
 	LUA_REGISTER_MEMBER_FUNCTION(WeightedTypeListClass, "Parse", &WeightedTypeListClass::Lua_Parse);
@@ -54,6 +54,7 @@ class WeightedTypeListClass : public LuaUserVar
 public:
 	PG_DECLARE_RTTI();
 	LUA_DECLARE_FACTORY(LUA_CHUNK_WEIGHTED_TYPE_LIST, WeightedTypeListClass);
+	LUA_DECLARE_MEMBER_TABLE(WeightedTypeListClass);
 
 	WeightedTypeListClass();
 	~WeightedTypeListClass();
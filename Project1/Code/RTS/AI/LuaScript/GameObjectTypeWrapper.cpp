@@ -58,12 +58,17 @@ enum {
 PG_IMPLEMENT_RTTI(GameObjectTypeWrapper, LuaUserVar);
 LUA_IMPLEMENT_FACTORY(LUA_CHUNK_GAMEOBJECTTYPE_WRAPPER, GameObjectTypeWrapper);
 MEMORY_POOL_INSTANCE(GameObjectTypeWrapper, LUA_WRAPPER_POOL_SIZE);
+LUA_IMPLEMENT_MEMBER_TABLE(GameObjectTypeWrapper, LuaUserVar);
 
 GameObjectTypeWrapper::WrapperCacheType *GameObjectTypeWrapper::WrapperCache = NULL;
 
 
 GameObjectTypeWrapper::GameObjectTypeWrapper() : 
 	Script(NULL)
+{
+}
+
+void GameObjectTypeWrapper::Register_Members(LuaMemberTableClass *table)
 {
 	LUA_REGISTER_MEMBER_FUNCTION(GameObjectTypeWrapper, "Get_Build_Cost", &GameObjectTypeWrapper::Get_Build_Cost);
 	LUA_REGISTER_MEMBER_FUNCTION(GameObjectTypeWrapper, "Get_Combat_Rating", &GameObjectTypeWrapper::Get_Combat_Rating);
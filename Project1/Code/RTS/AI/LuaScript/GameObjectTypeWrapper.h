@@ -54,6 +54,7 @@ class GameObjectTypeWrapper : public LuaUserVar, public PooledObjectClass<GameOb
 public:
 	PG_DECLARE_RTTI();
 	LUA_DECLARE_FACTORY(LUA_CHUNK_GAMEOBJECTTYPE_WRAPPER, GameObjectTypeWrapper);
+	LUA_DECLARE_MEMBER_TABLE(GameObjectTypeWrapper);
 
 	GameObjectTypeWrapper();
 	~GameObjectTypeWrapper();
@@ -43,6 +43,7 @@
 
 #pragma hdrstop
 #include "GameObjectWrapper.h"
+#include "LuaRTSBinding.h"
 #include "GameObject.h"
 #include "GameObjectManager.h"
 #include "GameModeManager.h"
@@ -126,6 +127,7 @@ enum {
 PG_IMPLEMENT_RTTI(GameObjectWrapper, LuaUserVar);
 LUA_IMPLEMENT_FACTORY(LUA_CHUNK_GAMEOBJECT_WRAPPER, GameObjectWrapper);
 MEMORY_POOL_INSTANCE(GameObjectWrapper, LUA_WRAPPER_POOL_SIZE);
+LUA_IMPLEMENT_MEMBER_TABLE(GameObjectWrapper, LuaUserVar);
 
 GameObjectWrapper::WrapperCacheType *GameObjectWrapper::WrapperCache = NULL;
 
@@ -133,6 +135,10 @@ GameObjectWrapper::GameObjectWrapper() :
 	ObjectInRangeListModified(false)
 ,	Script(NULL)
 ,	Persistable(true)
+{
+}
+
+void GameObjectWrapper::Register_Members(LuaMemberTableClass *table)
 {
 	LUA_REGISTER_MEMBER_FUNCTION(GameObjectWrapper, "Release", &GameObjectWrapper::Release);
 	LUA_REGISTER_MEMBER_FUNCTION(GameObjectWrapper, "Is_Transport", &GameObjectWrapper::Lua_Is_Transport);
@@ -140,13 +146,13 @@ GameObjectWrapper::GameObjectWrapper() :
 	LUA_REGISTER_MEMBER_FUNCTION(GameObjectWrapper, "Get_Health", &GameObjectWrapper::Get_Hull);
 	LUA_REGISTER_MEMBER_FUNCTION(GameObjectWrapper, "Get_Shield", &GameObjectWrapper::Get_Shield);
 	LUA_REGISTER_MEMBER_FUNCTION(GameObjectWrapper, "Get_Energy", &GameObjectWrapper::Get_Energy);
-	LUA_REGISTER_MEMBER_FUNCTION(GameObjectWrapper, "Is_Category", &GameObjectWrapper::Is_Category);
+	LUA_REGISTER_MEMBER_STACK_FUNCTION(GameObjectWrapper, "Is_Category", &GameObjectWrapper::Is_Category);
 	LUA_REGISTER_MEMBER_FUNCTION(GameObjectWrapper, "Get_Parent_Object", &GameObjectWrapper::Get_Parent_Object);
 	LUA_REGISTER_MEMBER_FUNCTION(GameObjectWrapper, "Attack_Target", &GameObjectWrapper::Attack_Target);
 	LUA_REGISTER_MEMBER_FUNCTION(GameObjectWrapper, "Is_Valid", &GameObjectWrapper::Is_Valid);
 	LUA_REGISTER_MEMBER_FUNCTION(GameObjectWrapper, "Get_Type", &GameObjectWrapper::Lua_Get_Type);
 	LUA_REGISTER_MEMBER_FUNCTION(GameObjectWrapper, "Get_Game_Scoring_Type", &GameObjectWrapper::Lua_Get_Game_Scoring_Type);
-	LUA_REGISTER_MEMBER_FUNCTION(GameObjectWrapper, "Set_Prefer_Ground_Over_Space", &GameObjectWrapper::Lua_Set_Prefer_Ground_Over_Space);
+	LUA_BIND(GameObjectWrapper, "Set_Prefer_Ground_Over_Space", &GameObjectWrapper::Lua_Set_Prefer_Ground_Over_Space);
 	LUA_REGISTER_MEMBER_FUNCTION(GameObjectWrapper, "Set_Targeting_Priorities", &GameObjectWrapper::Set_Targeting_Priorities);
 	LUA_REGISTER_MEMBER_FUNCTION(GameObjectWrapper, "Set_Targeting_Stickiness_Time_Threshold", &GameObjectWrapper::Set_Targeting_Stickiness_Time_Threshold);
 	LUA_REGISTER_MEMBER_FUNCTION(GameObjectWrapper, "Get_Time_Till_Dead", &GameObjectWrapper::Get_Time_Till_Dead);
@@ -158,18 +164,18 @@ GameObjectWrapper::GameObjectWrapper() :
 	LUA_REGISTER_MEMBER_FUNCTION(GameObjectWrapper, "Contains_Hero", &GameObjectWrapper::Contains_Hero);
 	LUA_REGISTER_MEMBER_FUNCTION(GameObjectWrapper, "Get_Contained_Heroes", &GameObjectWrapper::Get_Contained_Heroes);
 	LUA_REGISTER_MEMBER_FUNCTION(GameObjectWrapper, "Are_Engines_Online", &GameObjectWrapper::Are_Engines_Online);
-	LUA_REGISTER_MEMBER_FUNCTION(GameObjectWrapper, "Get_Distance", &GameObjectWrapper::Get_Distance);
+	LUA_REGISTER_MEMBER_STACK_FUNCTION(GameObjectWrapper, "Get_Distance", &GameObjectWrapper::Get_Distance);
 	LUA_REGISTER_MEMBER_FUNCTION(GameObjectWrapper, "Get_Build_Pad_Contents", &GameObjectWrapper::Get_Build_Pad_Contents);
 	LUA_REGISTER_MEMBER_FUNCTION(GameObjectWrapper, "Sell", &GameObjectWrapper::Sell);
-	LUA_REGISTER_MEMBER_FUNCTION(GameObjectWrapper, "Get_Owner", &GameObjectWrapper::Get_Owner);
+	LUA_REGISTER_MEMBER_STACK_FUNCTION(GameObjectWrapper, "Get_Owner", &GameObjectWrapper::Get_Owner);
 	LUA_REGISTER_MEMBER_FUNCTION(GameObjectWrapper, "Get_Starbase_Level", &GameObjectWrapper::Get_Starbase_Level);
 	LUA_REGISTER_MEMBER_FUNCTION(GameObjectWrapper, "Get_Final_Blow_Player", &GameObjectWrapper::Get_Final_Blow_Player);
 	LUA_REGISTER_MEMBER_FUNCTION(GameObjectWrapper, "Lock_Current_Orders", &GameObjectWrapper::Lock_Current_Orders);
 	LUA_REGISTER_MEMBER_FUNCTION(GameObjectWrapper, "Event_Object_In_Range", &GameObjectWrapper::Event_Object_In_Range);
 	LUA_REGISTER_MEMBER_FUNCTION(GameObjectWrapper, "Service_Wrapper", &GameObjectWrapper::Service_Wrapper);
 	LUA_REGISTER_MEMBER_FUNCTION(GameObjectWrapper, "Cancel_Event_Object_In_Range", &GameObjectWrapper::Cancel_Event_Object_In_Range);
-	LUA_REGISTER_MEMBER_FUNCTION(GameObjectWrapper, "Get_Position", &GameObjectWrapper::Lua_Get_Position);
-	LUA_REGISTER_MEMBER_FUNCTION(GameObjectWrapper, "Prevent_AI_Usage", &GameObjectWrapper::Prevent_AI_Usage);
+	LUA_REGISTER_MEMBER_STACK_FUNCTION(GameObjectWrapper, "Get_Position", &GameObjectWrapper::Lua_Get_Position);
+	LUA_BIND(GameObjectWrapper, "Prevent_AI_Usage", &GameObjectWrapper::Prevent_AI_Usage);
 	LUA_REGISTER_MEMBER_FUNCTION(GameObjectWrapper, "Set_Importance", &GameObjectWrapper::Set_Importance);
 	LUA_REGISTER_MEMBER_FUNCTION(GameObjectWrapper, "Take_Damage", &GameObjectWrapper::Take_Damage);
 	LUA_REGISTER_MEMBER_FUNCTION(GameObjectWrapper, "Despawn", &GameObjectWrapper::Despawn);
@@ -219,7 +225,7 @@ GameObjectWrapper::GameObjectWrapper() :
 	LUA_REGISTER_MEMBER_FUNCTION(GameObjectWrapper, "Force_Test_Space_Conflict", &GameObjectWrapper::Force_Test_Space_Conflict);
 	LUA_REGISTER_MEMBER_FUNCTION(GameObjectWrapper, "Hide", &GameObjectWrapper::Hide);
 	LUA_REGISTER_MEMBER_FUNCTION(GameObjectWrapper, "Face_Immediate", &GameObjectWrapper::Face_Immediate);
-	LUA_REGISTER_MEMBER_FUNCTION(GameObjectWrapper, "Reset_Ability_Counter", &GameObjectWrapper::Reset_Ability_Counter);	
+	LUA_REGISTER_MEMBER_FUNCTION(GameObjectWrapper, "Reset_Ability_Counter", &GameObjectWrapper::Reset_Ability_Counter);
 	LUA_REGISTER_MEMBER_FUNCTION(GameObjectWrapper, "Prevent_All_Fire", &GameObjectWrapper::Prevent_All_Fire);
 	LUA_REGISTER_MEMBER_FUNCTION(GameObjectWrapper, "Disable_Capture", &GameObjectWrapper::Disable_Capture);
 	LUA_REGISTER_MEMBER_FUNCTION(GameObjectWrapper, "Suspend_Locomotor", &GameObjectWrapper::Suspend_Locomotor);
@@ -544,12 +550,12 @@ LuaTable *GameObjectWrapper::Get_Final_Blow_Player(LuaScriptClass *script, LuaTa
 	return NULL;
 }
 
-LuaTable *GameObjectWrapper::Get_Owner(LuaScriptClass *script, LuaTable *)
+void GameObjectWrapper::Get_Owner(LuaScriptClass *script, LuaStackArgsClass &args)
 {
 	Debug_Validate_Wrapper_Cache();
 	if (!Object)
 	{
-		return NULL;
+		return;
 	}
 	int owner_id = Object->Get_Owner();
 
@@ -561,9 +567,8 @@ LuaTable *GameObjectWrapper::Get_Owner(LuaScriptClass *script, LuaTable *)
 	PlayerClass *owner = PlayerList.Get_Player_By_ID(owner_id);
 	if (owner)
 	{
-		return Return_Variable(PlayerWrapper::Create(owner, script));
+		args.Return_Var(PlayerWrapper::Create(owner, script));
 	}
-	return NULL;
 }
 
 
@@ -624,27 +629,18 @@ LuaTable *GameObjectWrapper::Lua_Get_Type(LuaScriptClass *script, LuaTable *)
 	return NULL;
 }
 
-LuaTable *GameObjectWrapper::Lua_Set_Prefer_Ground_Over_Space(LuaScriptClass *script, LuaTable *params)
+void GameObjectWrapper::Lua_Set_Prefer_Ground_Over_Space(LuaScriptClass *script, bool prefer_ground)
 {
-	if (!params || params->Value.size() == 0)
-	{
-		script->Script_Error("GameObjectWrapper::Lua_Set_Prefer_Ground_Over_Space -- Missing required boolean parameter.");
-		return NULL;
-	}
-
-	LuaBool::Pointer bval = PG_Dynamic_Cast<LuaBool>(params->Value[0]);
-
 	if (Object)
 	{
 		UnitAIBehaviorClass *behave = (UnitAIBehaviorClass *)Object->Get_Behavior(BEHAVIOR_UNIT_AI);
 		if (behave)
 		{
-			behave->Set_Prefer_Ground_Over_Space(bval->Value);
-			return NULL;
+			behave->Set_Prefer_Ground_Over_Space(prefer_ground);
+			return;
 		}
 	}
 	script->Script_Error("GameObjectWrapper::Lua_Set_Prefer_Ground_Over_Space -- Object invalid or missing Unit_AI behavior.");
-	return NULL;
 }
 
 LuaTable *GameObjectWrapper::Get_Shield(LuaScriptClass *script, LuaTable *)
@@ -679,34 +675,35 @@ LuaTable *GameObjectWrapper::Get_Energy(LuaScriptClass *script, LuaTable *)
 	return Return_Variable(new LuaNumber(Object->Get_Energy_Percent()));
 }
 
-LuaTable *GameObjectWrapper::Is_Category(LuaScriptClass *script, LuaTable *params)
+void GameObjectWrapper::Is_Category(LuaScriptClass *script, LuaStackArgsClass &args)
 {
 	if (!Object)
 	{
-		return 0;
+		return;
 	}
 
-	if (params->Value.size() != 1)
+	if (args.Get_Count() != 1)
 	{
-		script->Script_Error("GameObjectWrapper::Is_Category -- invalid number of parameters. Expected 1, got %d.", params->Value.size());
-		return 0;
+		script->Script_Error("GameObjectWrapper::Is_Category -- invalid number of parameters. Expected 1, got %d.", args.Get_Count());
+		return;
 	}
 
-	SmartPtr<LuaString> category_name = PG_Dynamic_Cast<LuaString>(params->Value[0]);
+	size_t length = 0;
+	const char *category_name = args.Get_String(0, &length);
 	if (!category_name)
 	{
 		script->Script_Error("GameObjectWrapper::Is_Category -- parameter 1 is not a valid string.");
-		return 0;
+		return;
 	}
 
 	GameObjectCategoryType category;
-	if (!TheGameObjectCategoryTypeConverterPtr->String_To_Enum(category_name->Value, category))
+	if (!TheGameObjectCategoryTypeConverterPtr->String_To_Enum(std::string(category_name, length), category))
 	{
-		script->Script_Error("GameObjectWrapper::Is_Category -- unrecognized category %s.", category_name->Value.c_str());
-		return 0;
+		script->Script_Error("GameObjectWrapper::Is_Category -- unrecognized category %s.", category_name);
+		return;
 	}
 
-	return Return_Variable(new LuaBool((Object->Get_Original_Object_Type()->Get_Category_Mask() & category) != 0));
+	args.Return_Bool((Object->Get_Original_Object_Type()->Get_Category_Mask() & category) != 0);
 }
 
 LuaTable *GameObjectWrapper::Get_Parent_Object(LuaScriptClass *script, LuaTable *)
@@ -1847,29 +1844,31 @@ LuaTable *GameObjectWrapper::Get_Build_Pad_Contents(LuaScriptClass *script, LuaT
 *
 * History: 3/2/2005 10:01AM JSY
 **************************************************************************************************/
-LuaTable *GameObjectWrapper::Get_Distance(LuaScriptClass *script, LuaTable *params)
+void GameObjectWrapper::Get_Distance(LuaScriptClass *script, LuaStackArgsClass &args)
 {
 	if (!Object)
 	{
 		script->Script_Error("GameObjectWrapper::Get_Distance -- this object is already dead.");
-		return 0;
+		return;
 	}
 
-	if (params->Value.size() != 1)
+	if (args.Get_Count() != 1)
 	{
-		script->Script_Error("GameObjectWrapper::Get_Distance -- invalid number of parameters.  Expceted 1, got %d.", params->Value.size());
-		return 0;
+		script->Script_Error("GameObjectWrapper::Get_Distance -- invalid number of parameters.  Expceted 1, got %d.", args.Get_Count());
+		return;
 	}
 
+	// Positions only come from user vars, so this doesn't allocate for valid targets.
+	SmartPtr<LuaVar> target = args.Get_Var(0);
 	Vector3 target_position;
-	if (!Lua_Extract_Position(params->Value[0], target_position))
+	if (!Lua_Extract_Position(target, target_position))
 	{
 		script->Script_Error("GameObjectWrapper::Get_Distance -- could not extract a position from parameter 1.");
 	}
 
 	float distance = (Object->Get_Position() - target_position).Length();
 
-	return Return_Variable(new LuaNumber(distance));
+	args.Return_Number(distance);
 }
 
 /**************************************************************************************************
@@ -2228,13 +2227,13 @@ LuaTable *GameObjectWrapper::Service_Wrapper(LuaScriptClass *script, LuaTable *)
  * @return objects position
  * @since 5/2/2005 2:14:30 PM -- BMH
  */
-LuaTable *GameObjectWrapper::Lua_Get_Position(LuaScriptClass *, LuaTable *)
+void GameObjectWrapper::Lua_Get_Position(LuaScriptClass *, LuaStackArgsClass &args)
 {
-	FAIL_IF(!Object) { return NULL; }
-	FAIL_IF(!Position) { return NULL; }
+	FAIL_IF(!Object) { return; }
+	FAIL_IF(!Position) { return; }
 
    Position->Set_Position(Object->Get_Position());
-	return Return_Variable(Position);
+	args.Return_Var(Position);
 }
 
 
@@ -2245,48 +2244,35 @@ LuaTable *GameObjectWrapper::Lua_Get_Position(LuaScriptClass *, LuaTable *)
  * param bool -- true, remove the object from freestore,
  *               false, add it back to the freestore.
  * 
- * @param script lua script.
- * @param params lua params
+ * @param script  lua script.
+ * @param prevent true to remove the object from the freestore.
  * 
  * @return none
  * @since 5/2/2005 8:02:30 PM -- BMH
  */
-LuaTable *GameObjectWrapper::Prevent_AI_Usage(LuaScriptClass *script, LuaTable *params)
+void GameObjectWrapper::Prevent_AI_Usage(LuaScriptClass *script, bool prevent)
 {
-	FAIL_IF(!Object) { return NULL; }
-
-	if (params->Value.size() < 1)
-	{
-		script->Script_Error("GameObjectWrapper::Prevent_AI_Usage -- Expected bool parameter.");
-		return NULL;
-	}
-
-	LuaBool::Pointer bval = PG_Dynamic_Cast<LuaBool>(params->Value[0]);
-	if (!bval)
-	{
-		script->Script_Error("GameObjectWrapper::Prevent_AI_Usage -- Expected bool parameter.");
-		return NULL;
-	}
+	FAIL_IF(!Object) { return; }
 
 	AIPlayerClass *ai_player = Object->Get_Owner_Player()->Get_AI_Player();
 
 	if (!ai_player)
 	{
 		script->Script_Warning("GameObjectWrapper::Prevent_AI_Usage -- No AI Player active on the owner of this object.");
-		return NULL;
+		return;
 	}
 
 	TacticalAIManagerClass *tactical_manager = (*ai_player->Find_Tactical_Manager_By_Mode(GameModeManager.Get_Active_Mode()));
 	if (!tactical_manager)
 	{
 		script->Script_Error("GameObjectWrapper::Prevent_AI_Usage -- Owner has no AI presence in this mode.  Ensure the player is one of the standard particpants in the battle or call Enable_As_Actor before using Prevent_AI_Usage.");
-		return NULL;
+		return;
 	}
 
 	if (!tactical_manager->Get_Execution_System())
 	{
 		script->Script_Error("GameObjectWrapper::Prevent_AI_Usage -- Owner AI is not yet initialized.  Wait a frame before calling this function.");
-		return NULL;
+		return;
 	}
 
 	AIFreeStoreClass *freestore = tactical_manager->Get_Execution_System()->Get_Free_Store();
@@ -2294,10 +2280,10 @@ LuaTable *GameObjectWrapper::Prevent_AI_Usage(LuaScriptClass *script, LuaTable *
 	if (!freestore)
 	{
 		script->Script_Warning("GameObjectWrapper::Prevent_AI_Usage -- No freestore exists for this AI Player.");
-		return NULL;
+		return;
 	}
 
-	if (bval->Value)
+	if (prevent)
 	{
 		freestore->Remove_Free_Store_Object(Object);
 	}
@@ -2307,8 +2293,6 @@ LuaTable *GameObjectWrapper::Prevent_AI_Usage(LuaScriptClass *script, LuaTable *
 		Object->Set_Is_AI_Usable(true);
 		freestore->Add_Free_Store_Object(Object);
 	}
-
-	return NULL;
 }
 
 /**************************************************************************************************
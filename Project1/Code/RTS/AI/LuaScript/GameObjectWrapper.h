@@ -60,6 +60,7 @@ class GameObjectWrapper : public LuaUserVar, public SignalListenerClass, public
 public:
 	PG_DECLARE_RTTI();
 	LUA_DECLARE_FACTORY(LUA_CHUNK_GAMEOBJECT_WRAPPER, GameObjectWrapper);
+	LUA_DECLARE_MEMBER_TABLE(GameObjectWrapper);
 
 	GameObjectWrapper();
 	~GameObjectWrapper();
@@ -73,8 +74,8 @@ public:
    
 	virtual bool Is_Equal(const LuaVar *var) const;
 
-	LuaTable* Get_Owner(LuaScriptClass *script, LuaTable *);
-	LuaTable* Lua_Set_Prefer_Ground_Over_Space(LuaScriptClass *script, LuaTable *params);
+	void Get_Owner(LuaScriptClass *script, LuaStackArgsClass &args);
+	void Lua_Set_Prefer_Ground_Over_Space(LuaScriptClass *script, bool prefer_ground);
 	LuaTable* Lua_Get_Type(LuaScriptClass *script, LuaTable *);
 	LuaTable *Lua_Get_Game_Scoring_Type(LuaScriptClass *script, LuaTable *);
 	LuaTable* Get_Hull(LuaScriptClass *, LuaTable *);
@@ -83,7 +84,7 @@ public:
 	LuaTable* Get_Rate_Of_Damage_Taken(LuaScriptClass *, LuaTable *);
 	LuaTable* Get_Time_Till_Dead(LuaScriptClass *, LuaTable *);
 	LuaTable* Fire_Special_Weapon(LuaScriptClass *, LuaTable *);
-	LuaTable* Is_Category(LuaScriptClass *, LuaTable *);
+	void Is_Category(LuaScriptClass *script, LuaStackArgsClass &args);
 	LuaTable* Get_Parent_Object(LuaScriptClass *, LuaTable *);
 	LuaTable* Attack_Target(LuaScriptClass *script, LuaTable *params);
 	LuaTable* Set_Targeting_Priorities(LuaScriptClass *script, LuaTable *params);
@@ -94,7 +95,7 @@ public:
 	LuaTable* Contains_Hero(LuaScriptClass *script, LuaTable *params);
 	LuaTable* Get_Contained_Heroes(LuaScriptClass *script, LuaTable *params);
 	LuaTable* Are_Engines_Online(LuaScriptClass *script, LuaTable *params);
-	LuaTable* Get_Distance(LuaScriptClass *script, LuaTable *params);
+	void Get_Distance(LuaScriptClass *script, LuaStackArgsClass &args);
 	LuaTable* Get_Build_Pad_Contents(LuaScriptClass *script, LuaTable *params);
 	LuaTable* Sell(LuaScriptClass *script, LuaTable *params);
 	LuaTable* Get_Starbase_Level(LuaScriptClass *script, LuaTable *);
@@ -103,8 +104,8 @@ public:
 	LuaTable *Event_Object_In_Range(LuaScriptClass *script, LuaTable *params);
 	LuaTable *Cancel_Event_Object_In_Range(LuaScriptClass *script, LuaTable *params);
 	LuaTable *Service_Wrapper(LuaScriptClass *script, LuaTable *params);
-	LuaTable *Lua_Get_Position(LuaScriptClass *script, LuaTable *);
-	LuaTable *Prevent_AI_Usage(LuaScriptClass *script, LuaTable *params);
+	void Lua_Get_Position(LuaScriptClass *script, LuaStackArgsClass &args);
+	void Prevent_AI_Usage(LuaScriptClass *script, bool prevent);
 	LuaTable *Set_Importance(LuaScriptClass *script, LuaTable *params);
 	LuaTable *Take_Damage(LuaScriptClass *script, LuaTable *params);
 	LuaTable *Despawn(LuaScriptClass *script, LuaTable *params);
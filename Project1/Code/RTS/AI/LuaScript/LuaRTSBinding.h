@@ -0,0 +1,111 @@
+// $Id: //depot/Projects/StarWars_Steam/FOC/Code/RTS/AI/LuaScript/LuaRTSBinding.h#1 $
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Petroglyph Games, Inc.
+//
+//
+//  *****           **                          *                   *
+//  *   **          *                           *                   *
+//  *    *          *                           *                   *
+//  *    *          *     *                 *   *          *        *
+//  *   *     *** ******  * **  ****      ***   * *      * *****    * ***
+//  *  **    *  *   *     **   *   **   **  *   *  *    * **   **   **   *
+//  ***     *****   *     *   *     *  *    *   *  *   **  *    *   *    *
+//  *       *       *     *   *     *  *    *   *   *  *   *    *   *    *
+//  *       *       *     *   *     *  *    *   *   * **   *   *    *    *
+//  *       **       *    *   **   *   **   *   *    **    *  *     *   *
+// **        ****     **  *    ****     *****   *    **    ***      *   *
+//                                          *        *     *
+//                                          *        *     *
+//                                          *       *      *
+//                                      *  *        *      *
+//                                      ****       *       *
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// C O N F I D E N T I A L   S O U R C E   C O D E -- D O   N O T   D I S T R I B U T E
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//              $File: //depot/Projects/StarWars_Steam/FOC/Code/RTS/AI/LuaScript/LuaRTSBinding.h $
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/** @file */
+
+#ifndef _LUA_RTS_BINDING_H_
+#define _LUA_RTS_BINDING_H_
+
+#include "LuaBinding.h"
+#include "LuaRTSUtilities.h"
+#include "GameObjectWrapper.h"
+#include "PlayerWrapper.h"
+
+class GameObjectClass;
+class PlayerClass;
+
+/**
+ * LUA_BIND argument and return types for the RTS wrappers.
+ * @see LUA_BIND
+ */
+
+/**
+ * Any position a script can pass: object, AI target, taskforce or position.
+ */
+template <>
+struct LuaArgTraits<Vector3>
+{
+	static const char *Get_Type_Name(void) { return "position"; }
+	static bool Get(LuaScriptClass *, LuaStackArgsClass &args, int index, Vector3 &value)
+	{
+		// Every position type is a user var, so this doesn't allocate for valid arguments.
+		SmartPtr<LuaVar> var = args.Get_Var(index);
+		return Lua_Extract_Position(var, value);
+	}
+};
+
+/**
+ * A live game object.  Fails for dead objects.
+ */
+template <>
+struct LuaArgTraits<GameObjectClass *>
+{
+	static const char *Get_Type_Name(void) { return "game object"; }
+	static bool Get(LuaScriptClass *, LuaStackArgsClass &args, int index, GameObjectClass *&value)
+	{
+		GameObjectWrapper *wrapper = PG_Dynamic_Cast<GameObjectWrapper>(args.Get_User_Var(index));
+		value = wrapper ? wrapper->Get_Object() : NULL;
+		return value != NULL;
+	}
+};
+
+template <>
+struct LuaArgTraits<PlayerClass *>
+{
+	static const char *Get_Type_Name(void) { return "player"; }
+	static bool Get(LuaScriptClass *, LuaStackArgsClass &args, int index, PlayerClass *&value)
+	{
+		PlayerWrapper *wrapper = PG_Dynamic_Cast<PlayerWrapper>(args.Get_User_Var(index));
+		value = wrapper ? wrapper->Get_Object() : NULL;
+		return value != NULL;
+	}
+};
+
+template <>
+struct LuaReturnTraits<GameObjectClass *>
+{
+	static void Push(LuaScriptClass *script, LuaStackArgsClass &args, GameObjectClass *value)
+	{
+		if (value) args.Return_Var(GameObjectWrapper::Create(value, script));
+		else args.Return_Nil();
+	}
+};
+
+template <>
+struct LuaReturnTraits<PlayerClass *>
+{
+	static void Push(LuaScriptClass *script, LuaStackArgsClass &args, PlayerClass *value)
+	{
+		if (value) args.Return_Var(PlayerWrapper::Create(value, script));
+		else args.Return_Nil();
+	}
+};
+
+#endif //_LUA_RTS_BINDING_H_
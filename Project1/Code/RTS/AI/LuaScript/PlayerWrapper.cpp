@@ -64,12 +64,18 @@ enum {
 PG_IMPLEMENT_RTTI(PlayerWrapper, LuaUserVar);
 LUA_IMPLEMENT_FACTORY(LUA_CHUNK_PLAYER_WRAPPER, PlayerWrapper);
 MEMORY_POOL_INSTANCE(PlayerWrapper, LUA_WRAPPER_POOL_SIZE);
+LUA_IMPLEMENT_MEMBER_TABLE(PlayerWrapper, LuaUserVar);
 
 PlayerWrapper::WrapperCacheType *PlayerWrapper::WrapperCache = NULL;
 
 PlayerWrapper::PlayerWrapper() : 
 	Object(NULL)
 ,	Script(NULL)
+{
+
+}
+
+void PlayerWrapper::Register_Members(LuaMemberTableClass *table)
 {
 	LUA_REGISTER_MEMBER_FUNCTION(PlayerWrapper, "Is_Neutral", &PlayerWrapper::Lua_Is_Neutral);
 	LUA_REGISTER_MEMBER_FUNCTION(PlayerWrapper, "Get_ID", &PlayerWrapper::Lua_Get_ID);
@@ -104,7 +110,6 @@ PlayerWrapper::PlayerWrapper() :
 	LUA_REGISTER_MEMBER_FUNCTION(PlayerWrapper, "Get_Clan_ID", &PlayerWrapper::Lua_Get_Clan_ID);
 	LUA_REGISTER_MEMBER_FUNCTION(PlayerWrapper, "Get_Team", &PlayerWrapper::Lua_Get_Team);
 	LUA_REGISTER_MEMBER_FUNCTION(PlayerWrapper, "Get_Space_Station", &PlayerWrapper::Get_Space_Station);
-
 }
 
 PlayerWrapper::~PlayerWrapper()
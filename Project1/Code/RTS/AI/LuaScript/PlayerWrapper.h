@@ -53,6 +53,7 @@ class PlayerWrapper : public LuaUserVar, public PooledObjectClass<PlayerWrapper,
 public:
 	PG_DECLARE_RTTI();
 	LUA_DECLARE_FACTORY(LUA_CHUNK_PLAYER_WRAPPER, PlayerWrapper);
+	LUA_DECLARE_MEMBER_TABLE(PlayerWrapper);
 	PlayerWrapper();
 	~PlayerWrapper();
 
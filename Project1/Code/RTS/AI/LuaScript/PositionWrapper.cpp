@@ -47,9 +47,14 @@
 PG_IMPLEMENT_RTTI(PositionWrapper, LuaUserVar);
 LUA_IMPLEMENT_FACTORY(LUA_CHUNK_POSITION_WRAPPER, PositionWrapper);
 MEMORY_POOL_INSTANCE(PositionWrapper, LUA_WRAPPER_POOL_SIZE);
+LUA_IMPLEMENT_MEMBER_TABLE(PositionWrapper, LuaUserVar);
 
 PositionWrapper::PositionWrapper() :
 	Position(VECTOR3_INVALID)
+{
+}
+
+void PositionWrapper::Register_Members(LuaMemberTableClass *table)
 {
 	LUA_REGISTER_MEMBER_FUNCTION(PositionWrapper, "Is_Valid", &PositionWrapper::Is_Valid);
 	LUA_REGISTER_MEMBER_FUNCTION(PositionWrapper, "Get_XYZ", &PositionWrapper::Get_XYZ);
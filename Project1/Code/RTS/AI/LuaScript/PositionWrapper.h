@@ -52,6 +52,7 @@ class PositionWrapper : public LuaUserVar, public PooledObjectClass<PositionWrap
 public:
 	PG_DECLARE_RTTI();
 	LUA_DECLARE_FACTORY(LUA_CHUNK_POSITION_WRAPPER, PositionWrapper);
+	LUA_DECLARE_MEMBER_TABLE(PositionWrapper);
 
 	PositionWrapper();
 
@@ -54,10 +54,15 @@
 PG_IMPLEMENT_RTTI(StoryEventWrapper, LuaUserVar);
 LUA_IMPLEMENT_FACTORY(LUA_CHUNK_STORYEVENT_WRAPPER, StoryEventWrapper);
 MEMORY_POOL_INSTANCE(StoryEventWrapper, LUA_WRAPPER_POOL_SIZE);
+LUA_IMPLEMENT_MEMBER_TABLE(StoryEventWrapper, LuaUserVar);
 
 StoryEventWrapper::StoryEventWrapper() :
 	Event(NULL),
 	Script(NULL)
+{
+}
+
+void StoryEventWrapper::Register_Members(LuaMemberTableClass *table)
 {
 	LUA_REGISTER_MEMBER_FUNCTION(StoryEventWrapper, "Is_Valid", &StoryEventWrapper::Is_Valid);
 	LUA_REGISTER_MEMBER_FUNCTION(StoryEventWrapper, "Set_Event_Parameter", &StoryEventWrapper::Set_Event_Parameter);
@@ -52,6 +52,7 @@ public:
 
 	PG_DECLARE_RTTI();
 	LUA_DECLARE_FACTORY(LUA_CHUNK_STORYEVENT_WRAPPER, StoryEventWrapper);
+	LUA_DECLARE_MEMBER_TABLE(StoryEventWrapper);
 
 	StoryEventWrapper();
 
@@ -49,6 +49,7 @@
 PG_IMPLEMENT_RTTI(StoryPlotWrapper, LuaUserVar);
 LUA_IMPLEMENT_FACTORY(LUA_CHUNK_STORYPLOT_WRAPPER, StoryPlotWrapper);
 MEMORY_POOL_INSTANCE(StoryPlotWrapper, LUA_WRAPPER_POOL_SIZE);
+LUA_IMPLEMENT_MEMBER_TABLE(StoryPlotWrapper, LuaUserVar);
 
 StoryPlotWrapper *StoryPlotWrapper::Create(StorySubPlotClass *plot, LuaScriptClass *script)
 {
@@ -64,6 +65,10 @@ StoryPlotWrapper *StoryPlotWrapper::Create(StorySubPlotClass *plot, LuaScriptCla
 StoryPlotWrapper::StoryPlotWrapper() :
 	Plot(NULL),
 	Script(NULL)
+{
+}
+
+void StoryPlotWrapper::Register_Members(LuaMemberTableClass *table)
 {
 	LUA_REGISTER_MEMBER_FUNCTION(StoryPlotWrapper, "Is_Valid", &StoryPlotWrapper::Is_Valid);
 	LUA_REGISTER_MEMBER_FUNCTION(StoryPlotWrapper, "Get_Event", &StoryPlotWrapper::Get_Event);
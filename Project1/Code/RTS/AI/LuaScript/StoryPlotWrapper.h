@@ -52,6 +52,7 @@ public:
 
 	PG_DECLARE_RTTI();
 	LUA_DECLARE_FACTORY(LUA_CHUNK_STORYPLOT_WRAPPER, StoryPlotWrapper);
+	LUA_DECLARE_MEMBER_TABLE(StoryPlotWrapper);
 
 	StoryPlotWrapper();
 
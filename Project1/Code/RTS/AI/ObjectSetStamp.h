@@ -0,0 +1,111 @@
+// $Id: //depot/Projects/StarWars_Steam/FOC/Code/RTS/AI/ObjectSetStamp.h#1 $
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Petroglyph Games, Inc.
+//
+//
+//  *****           **                          *                   *
+//  *   **          *                           *                   *
+//  *    *          *                           *                   *
+//  *    *          *     *                 *   *          *        *
+//  *   *     *** ******  * **  ****      ***   * *      * *****    * ***
+//  *  **    *  *   *     **   *   **   **  *   *  *    * **   **   **   *
+//  ***     *****   *     *   *     *  *    *   *  *   **  *    *   *    *
+//  *       *       *     *   *     *  *    *   *   *  *   *    *   *    *
+//  *       *       *     *   *     *  *    *   *   * **   *   *    *    *
+//  *       **       *    *   **   *   **   *   *    **    *  *     *   *
+// **        ****     **  *    ****     *****   *    **    ***      *   *
+//                                          *        *     *
+//                                          *        *     *
+//                                          *       *      *
+//                                      *  *        *      *
+//                                      ****       *       *
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// C O N F I D E N T I A L   S O U R C E   C O D E -- D O   N O T   D I S T R I B U T E
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//              $File: //depot/Projects/StarWars_Steam/FOC/Code/RTS/AI/ObjectSetStamp.h $
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/** @file */
+
+#ifndef _OBJECT_SET_STAMP_H_
+#define _OBJECT_SET_STAMP_H_
+
+#include "GameModeManager.h"
+#include "GameObjectManager.h"
+#include "FrameSynchronizer.h"
+
+/**
+ * Remembers the active mode, frame and object count a cache was built
+ * against, so the cache can tell when it has gone stale.  The AI caches
+ * that have no change notification to listen to all share this rule.  A
+ * mode change always counts as a change, the frame and the object count
+ * only when asked for.
+ */
+class ObjectSetStampClass
+{
+public:
+
+	enum
+	{
+		CHECK_MODE_ONLY = 0,
+		CHECK_FRAME = 1,
+		CHECK_OBJECT_COUNT = 2,
+		CHECK_ALL = CHECK_FRAME | CHECK_OBJECT_COUNT
+	};
+
+	ObjectSetStampClass() : Valid(false), Mode(NULL), Frame(-1), ObjectCount(-1) {}
+
+	/**
+	 * Take a new stamp.
+	 * 
+	 * @param checks CHECK_ flags for what besides the mode counts as a change
+	 * @return true if anything checked changed since the last stamp, and the
+	 *         cache should be dropped
+	 */
+	bool Refresh(int checks = CHECK_ALL)
+	{
+		GameModeClass *mode = GameModeManager.Get_Active_Mode();
+		int frame = FrameSynchronizer.Get_Current_Frame();
+		int object_count = mode ? mode->Get_Object_Manager().Get_Object_Count() : 0;
+
+		bool changed = !Valid || mode != Mode;
+		if ((checks & CHECK_FRAME) && frame != Frame) changed = true;
+		if ((checks & CHECK_OBJECT_COUNT) && object_count != ObjectCount) changed = true;
+
+		Valid = true;
+		Mode = mode;
+		Frame = frame;
+		ObjectCount = object_count;
+		return changed;
+	}
+
+	void Invalidate(void) { Valid = false; }
+
+	/**
+	 * Is a mode one the game mode manager still runs?  Listeners added to
+	 * objects of a mode that is gone went away with the objects.
+	 */
+	static bool Is_Live_Mode(const GameModeClass *mode)
+	{
+		for (int i = 0; mode && i < GameModeManager.Get_Game_Mode_Count(); ++i)
+		{
+			if (GameModeManager.Get_Game_Mode_By_Index(i) == mode)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+private:
+
+	bool					Valid;
+	GameModeClass		*Mode;
+	int					Frame;
+	int					ObjectCount;
+};
+
+#endif //_OBJECT_SET_STAMP_H_
@@ -64,11 +64,79 @@
 #include "GameObjectTypeManager.h"
 #include "AI/Learning/AILearningSystem.h"
 #include "DifficultyAdjustment.h"
+#include "AI/ObjectSetStamp.h"
+#include <map>
 
 float TargetContrastClass::MinContrastFactor = 0.0;
 float TargetContrastClass::MaxContrastFactor = 0.0;
 TargetContrastClass::ContrastType TargetContrastClass::ContrastTypeList;
 TargetContrastClass::TerrainEffectivenessTableType TargetContrastClass::TerrainEffectiveness;
+TargetContrastClass::ContrastTableListType TargetContrastClass::ContrastTables;
+int TargetContrastClass::ContrastTableSerial = 0;
+int TargetContrastClass::ContrastChangeSerial = 0;
+
+enum ContrastForceQueryType
+{
+	CONTRAST_FORCE_GROUND,
+	CONTRAST_FORCE_SPACE,
+	CONTRAST_FORCE_TACTICAL,
+	CONTRAST_FORCE_TACTICAL_SURROUNDING
+};
+
+/**
+ * Identifies one force list: the unscaled total at a target followed by the
+ * force for each category of a contrast type list.
+ */
+struct ContrastForceKeyStruct
+{
+	const AIPlayerClass								*Player;
+	const AITargetLocationClass					*Target;
+	const TargetContrastClass::ContrastType	*ContrastList;
+	ContrastForceQueryType							Query;
+
+	bool operator<(const ContrastForceKeyStruct &other) const
+	{
+		if (Player != other.Player) return Player < other.Player;
+		if (Target != other.Target) return Target < other.Target;
+		if (ContrastList != other.ContrastList) return ContrastList < other.ContrastList;
+		return Query < other.Query;
+	}
+};
+
+typedef std::map<ContrastForceKeyStruct, std::vector<float> > ContrastForceCacheType;
+
+static ContrastForceCacheType		ContrastForceCache;
+static ObjectSetStampClass			ContrastForceCacheStamp;
+
+/**
+ * Several plans build contrast lists for the same targets each frame, so force
+ * lists are kept until the frame, the active mode or the number of objects changes.
+ * 
+ * @return the cached list for the key, empty if it hasn't been computed yet.
+ */
+static std::vector<float> &Get_Cached_Contrast_Forces(const AIPlayerClass *ai_player,
+																		const AITargetLocationClass *target,
+																		const TargetContrastClass::ContrastType &ctypelist,
+																		ContrastForceQueryType query)
+{
+	if (ContrastForceCacheStamp.Refresh())
+	{
+		ContrastForceCache.clear();
+	}
+
+	ContrastForceKeyStruct key;
+	key.Player = ai_player;
+	key.Target = target;
+	key.ContrastList = &ctypelist;
+	key.Query = query;
+
+	std::vector<float> &forces = ContrastForceCache[key];
+	if (forces.size() != ctypelist.size() + 1)
+	{
+		forces.resize(0);
+	}
+	return forces;
+}
 
 /**
  * System Initialize
@@ -86,6 +154,7 @@ bool TargetContrastClass::System_Initialize(void)
 void TargetContrastClass::System_Shutdown(void)
 {
 	ContrastTypeList.clear();
+	Invalidate_Contrast_Tables();
 }
 
 /**
@@ -121,6 +190,8 @@ void TargetContrastClass::Parse_Lua_Contrast_String(float &min_factor,
 
 	unsigned int eval = 0;
 	result.clear();
+	ContrastForceCache.clear();
+	ContrastChangeSerial++;
 
 	for (int i = 0; i < (int)enemy->Value.size(); i++) {
 		LuaString::Pointer estr = LUA_SAFE_CAST(LuaString, enemy->Value[i]);
@@ -137,6 +208,8 @@ void TargetContrastClass::Parse_Lua_Contrast_String(float &min_factor,
 	max_factor = maxscale->Value;
 
 	script->Shutdown();
+
+	Compile_Contrast_Table(result);
 }
 
 void TargetContrastClass::Init_Contrast_Type_List(void)
@@ -179,20 +252,21 @@ void TargetContrastClass::Build_Contrast_List(AIPlayerClass *ai_player,
 	}
 	const TargetContrastClass::ContrastType &ctypelist = def ? def->Get_Contrast_Type_List() : ContrastTypeList;
 
+	static std::vector<float> ground_forces;
+	static std::vector<float> space_forces;
+	Get_Force_Perception_List(ai_player, target, ctypelist, true, ground_forces);
+	Get_Force_Perception_List(ai_player, target, ctypelist, false, space_forces);
+
 	result.resize(0);
-	float ground_force = Get_Force_Perception(ai_player, target, 0.0, true);
-	float space_force = Get_Force_Perception(ai_player, target, 0.0, false);
-	
-	result.push_back(ContrastForceStruct(0, ground_force, true));
-	result.push_back(ContrastForceStruct(0, space_force, false));
+	result.push_back(ContrastForceStruct(0, ground_forces[0], true));
+	result.push_back(ContrastForceStruct(0, space_forces[0], false));
 
-	if (ground_force > 0.0) 
+	int index = 1;
+	if (ground_forces[0] > 0.0) 
 	{
-		for (ContrastType::const_iterator i = ctypelist.begin(); i != ctypelist.end(); ++i)
+		for (ContrastType::const_iterator i = ctypelist.begin(); i != ctypelist.end(); ++i, ++index)
 		{
-			ground_force = Get_Force_Perception(ai_player, target, AIPerceptionSystemClass::Enum_Value_To_Parameter_Value(i->first), true);
-			ground_force *= gfactor;
-			result.push_back(ContrastForceStruct(i->first, ground_force, true));
+			result.push_back(ContrastForceStruct(i->first, ground_forces[index] * gfactor, true));
 		}
 	}
 	else
@@ -203,13 +277,12 @@ void TargetContrastClass::Build_Contrast_List(AIPlayerClass *ai_player,
 		}
 	}
 
-	if (space_force > 0.0) 
+	index = 1;
+	if (space_forces[0] > 0.0) 
 	{
-		for (ContrastType::const_iterator i = ctypelist.begin(); i != ctypelist.end(); ++i)
+		for (ContrastType::const_iterator i = ctypelist.begin(); i != ctypelist.end(); ++i, ++index)
 		{
-			space_force = Get_Force_Perception(ai_player, target, AIPerceptionSystemClass::Enum_Value_To_Parameter_Value(i->first), false);
-			space_force *= gfactor;
-			result.push_back(ContrastForceStruct(i->first, space_force, false));
+			result.push_back(ContrastForceStruct(i->first, space_forces[index] * gfactor, false));
 		}
 	}
 	else
@@ -260,18 +333,18 @@ void TargetContrastClass::Build_Space_Contrast_List(AIPlayerClass *ai_player,
 	}
 	const TargetContrastClass::ContrastType &ctypelist = def ? def->Get_Contrast_Type_List() : ContrastTypeList;
 
-	result.resize(0);
-	float force = Get_Space_Force_Perception(ai_player, target, 0.0, surrounding_forces_only);
+	static std::vector<float> forces;
+	Get_Space_Force_Perception_List(ai_player, target, ctypelist, surrounding_forces_only, forces);
 
-	result.push_back(ContrastForceStruct(0, force, ground));
+	result.resize(0);
+	result.push_back(ContrastForceStruct(0, forces[0], ground));
 
-	if (force > 0.0f)
+	if (forces[0] > 0.0f)
 	{
-		for (ContrastType::const_iterator i = ctypelist.begin(); i != ctypelist.end(); ++i)
+		int index = 1;
+		for (ContrastType::const_iterator i = ctypelist.begin(); i != ctypelist.end(); ++i, ++index)
 		{
-			force = Get_Space_Force_Perception(ai_player, target, AIPerceptionSystemClass::Enum_Value_To_Parameter_Value(i->first), surrounding_forces_only);
-			force *= gfactor;
-			result.push_back(ContrastForceStruct(i->first, force, ground));
+			result.push_back(ContrastForceStruct(i->first, forces[index] * gfactor, ground));
 		}
 	}
 	else
@@ -357,7 +430,36 @@ float TargetContrastClass::Get_Force_Perception(AIPlayerClass *ai_player,
 {
 	if ( !ai_player ) 
 		return 0.0;
-	
+
+	float query_result = Query_Force_Perception(ai_player, target, category, ground_forces);
+
+	int category_as_int = AIPerceptionSystemClass::Parameter_Value_To_Enum_Value(category);
+	if (category_as_int == 0)
+	{
+		category_as_int = GAME_OBJECT_CATEGORY_ALL;
+	}
+
+	Add_Base_Force_Perception(ai_player, target, ground_forces, &category_as_int, 1, &query_result);
+	return query_result;
+}
+
+/**
+ * Query the galactic perception system for the threat at the target, without
+ * the planet's own defenses.
+ * 
+ * @param ai_player AIPlayer that the opposing force will be estimated for.
+ * @param target    the AI Target location.
+ * @param category  category type to query for.
+ * @param ground_forces
+ *                  Query for ground or space force?
+ * 
+ * @return unnormalized force value
+ */
+float TargetContrastClass::Query_Force_Perception(AIPlayerClass *ai_player, 
+																  AITargetLocationClass *target, 
+																  float category, 
+																  bool ground_forces)
+{
 	TacticalAIManagerClass *manager = ai_player->Get_Tactical_Manager_By_Mode( SUB_GAME_MODE_GALACTIC );
 	AIPerceptionSystemClass *perception_system = manager->Get_Perception_System();
 
@@ -384,39 +486,61 @@ float TargetContrastClass::Get_Force_Perception(AIPlayerClass *ai_player,
 	float query_result = 0.0;
 	perception_system->Evaluate_Perception( evaluation_state, query_result );
 
+	return query_result;
+}
+
+/**
+ * Add the planet's own defenses to the force for each category, walking the
+ * planet's special structures once for all of them.
+ * 
+ * @param ai_player  AIPlayer that the opposing force will be estimated for.
+ * @param target     the AI Target location.
+ * @param ground_forces
+ *                   Ground or space force?
+ * @param categories category masks, one per force.
+ * @param count      number of categories.
+ * @param forces     forces to add to.
+ */
+void TargetContrastClass::Add_Base_Force_Perception(AIPlayerClass *ai_player, 
+																	 AITargetLocationClass *target, 
+																	 bool ground_forces, 
+																	 const int *categories, 
+																	 int count, 
+																	 float *forces)
+{
 	//Add in the base if the category matches
 	PlanetaryBehaviorClass *planet_behavior = static_cast<PlanetaryBehaviorClass*>(target->Get_Target_Game_Object()->Get_Behavior(BEHAVIOR_PLANET));
 
 	if (planet_behavior->Get_Allegiance().Is_Ally(ai_player->Get_Player()))
 	{
-		return query_result;
-	}
-
-	int category_as_int = AIPerceptionSystemClass::Parameter_Value_To_Enum_Value(category);
-	if (category_as_int == 0)
-	{
-		category_as_int = GAME_OBJECT_CATEGORY_ALL;
+		return;
 	}
 
 	if (ground_forces)
 	{
 		PlanetaryDataPackClass *planet_data = target->Get_Target_Game_Object()->Get_Planetary_Data();
-		FAIL_IF( planet_data == NULL )	{ return query_result; }
+		FAIL_IF( planet_data == NULL )	{ return; }
 
 		for (int i = 0; i < planet_data->Get_Ground_Special_Structures().Size(); ++i)
 		{
 			GameObjectClass *structure = planet_data->Get_Ground_Special_Structures().Get_At(i);
 			FAIL_IF(!structure) { continue; }
 
-			if ((structure->Get_Type()->Get_Category_Mask() & category_as_int) == 0)
+			for (int c = 0; c < count; ++c)
 			{
-				continue;
-			}
+				if ((structure->Get_Type()->Get_Category_Mask() & categories[c]) == 0)
+				{
+					continue;
+				}
 
-			query_result += structure->Get_Type()->Get_AI_Combat_Power_Metric();
+				forces[c] += structure->Get_Type()->Get_AI_Combat_Power_Metric();
+			}
 		}
 
-		query_result += planet_data->Get_Persistent_Built_Tactical_Object_Combat_Power(category_as_int);
+		for (int c = 0; c < count; ++c)
+		{
+			forces[c] += planet_data->Get_Persistent_Built_Tactical_Object_Combat_Power(categories[c]);
+		}
 	}
 	else
 	{
@@ -424,20 +548,305 @@ float TargetContrastClass::Get_Force_Perception(AIPlayerClass *ai_player,
 
 		if (base_type)
 		{
-			if ((category_as_int & base_type->Get_Category_Mask()) != 0)
+			for (int c = 0; c < count; ++c)
 			{
-				query_result += base_type->Get_AI_Combat_Power_Metric();
+				if ((categories[c] & base_type->Get_Category_Mask()) != 0)
+				{
+					forces[c] += base_type->Get_AI_Combat_Power_Metric();
+				}
 			}
 		}
 	}
+}
 
-	return query_result;
+/**
+ * Get the unscaled ground or space force at a galactic target for the total and
+ * every category of a contrast type list.  The categories are only queried when
+ * the total is positive, otherwise they are zero.
+ * 
+ * @param ai_player AIPlayer that the opposing force will be estimated for.
+ * @param target    the AI Target location.
+ * @param ctypelist contrast type list to get category forces for.
+ * @param ground_forces
+ *                  Query for ground or space force?
+ * @param forces    total followed by one force per category.
+ */
+void TargetContrastClass::Get_Force_Perception_List(AIPlayerClass *ai_player, 
+																	 AITargetLocationClass *target, 
+																	 const ContrastType &ctypelist, 
+																	 bool ground_forces, 
+																	 std::vector<float> &forces)
+{
+	std::vector<float> &cached = Get_Cached_Contrast_Forces(ai_player, target, ctypelist, ground_forces ? CONTRAST_FORCE_GROUND : CONTRAST_FORCE_SPACE);
+	if (!cached.empty())
+	{
+		forces = cached;
+		return;
+	}
+
+	forces.resize(0);
+	forces.push_back(Get_Force_Perception(ai_player, target, 0.0, ground_forces));
+
+	if (forces[0] > 0.0)
+	{
+		static std::vector<int> categories;
+		categories.resize(0);
+		for (ContrastType::const_iterator i = ctypelist.begin(); i != ctypelist.end(); ++i)
+		{
+			float category = AIPerceptionSystemClass::Enum_Value_To_Parameter_Value(i->first);
+			forces.push_back(Query_Force_Perception(ai_player, target, category, ground_forces));
+
+			int category_as_int = AIPerceptionSystemClass::Parameter_Value_To_Enum_Value(category);
+			if (category_as_int == 0)
+			{
+				category_as_int = GAME_OBJECT_CATEGORY_ALL;
+			}
+			categories.push_back(category_as_int);
+		}
+
+		if (!categories.empty())
+		{
+			Add_Base_Force_Perception(ai_player, target, ground_forces, &categories[0], (int)categories.size(), &forces[1]);
+		}
+	}
+	else
+	{
+		forces.resize(ctypelist.size() + 1, 0.0f);
+	}
+
+	cached = forces;
+}
+
+/**
+ * Get the unscaled force at a tactical target for the total and every category of
+ * a contrast type list.  The categories are only queried when the total is
+ * positive, otherwise they are zero.
+ * 
+ * @param ai_player AIPlayer that the opposing force will be estimated for.
+ * @param target    the AI Target location.
+ * @param ctypelist contrast type list to get category forces for.
+ * @param surrounding_forces_only
+ *                  Query force of the target or the threat around the target?
+ * @param forces    total followed by one force per category.
+ */
+void TargetContrastClass::Get_Space_Force_Perception_List(AIPlayerClass *ai_player, 
+																			 AITargetLocationClass *target, 
+																			 const ContrastType &ctypelist, 
+																			 bool surrounding_forces_only, 
+																			 std::vector<float> &forces)
+{
+	ContrastForceQueryType query = surrounding_forces_only ? CONTRAST_FORCE_TACTICAL_SURROUNDING : CONTRAST_FORCE_TACTICAL;
+	std::vector<float> &cached = Get_Cached_Contrast_Forces(ai_player, target, ctypelist, query);
+	if (!cached.empty())
+	{
+		forces = cached;
+		return;
+	}
+
+	forces.resize(0);
+	forces.push_back(Get_Space_Force_Perception(ai_player, target, 0.0, surrounding_forces_only));
+
+	if (forces[0] > 0.0f)
+	{
+		for (ContrastType::const_iterator i = ctypelist.begin(); i != ctypelist.end(); ++i)
+		{
+			forces.push_back(Get_Space_Force_Perception(ai_player, target, AIPerceptionSystemClass::Enum_Value_To_Parameter_Value(i->first), surrounding_forces_only));
+		}
+	}
+	else
+	{
+		forces.resize(ctypelist.size() + 1, 0.0f);
+	}
+
+	cached = forces;
+}
+
+/**
+ * Drop every compiled contrast table.  Lists compiled before this recompile on
+ * their next lookup.  Other caches built from the contrast lists, such as the auto
+ * resolve power breakdowns, watch Get_Contrast_Table_Serial, which changes here
+ * and whenever a list is parsed or a table is rebuilt, and drop themselves.
+ */
+void TargetContrastClass::Invalidate_Contrast_Tables(void)
+{
+	ContrastTables.clear();
+	ContrastForceCache.clear();
+	ContrastTableSerial++;
+	ContrastChangeSerial++;
+}
+
+/**
+ * Compile the contrast table of a list and store it on the list.  Call it once the
+ * list has been filled in; Parse_Lua_Contrast_String does.  Lists with the same
+ * weights share one table.
+ * 
+ * @param ctypelist contrast type list of a plan definition, or the global one.
+ */
+void TargetContrastClass::Compile_Contrast_Table(const ContrastType &ctypelist)
+{
+	ContrastSignatureType signature;
+	for (ContrastType::const_iterator it = ctypelist.begin(); it != ctypelist.end(); ++it)
+	{
+		ContrastWeightStruct header;
+		header.Category = it->first;
+		header.Type = NULL;
+		header.TypeCategory = 0;
+		header.Weight = 0.0f;
+		signature.push_back(header);
+
+		WeightedTypeListClass *weight_list = it->second;
+		for (int i = 0; i < weight_list->Get_Weight_Count(); ++i)
+		{
+			ContrastWeightStruct weight;
+			weight.Category = it->first;
+			weight.Type = weight_list->Get_Type_At_Index(i);
+			weight.TypeCategory = (unsigned int)weight_list->Get_Category_At_Index(i);
+			weight.Weight = weight_list->Get_Weight_At_Index(i);
+			signature.push_back(weight);
+		}
+	}
+
+	ContrastTableStruct &table = ContrastTables[signature];
+	if (table.TypeCount != GameObjectTypeManager.Get_Total_Object_Types() || table.Categories.size() != ctypelist.size())
+	{
+		Build_Contrast_Table(ctypelist, table);
+		ContrastChangeSerial++;
+	}
+
+	ctypelist.Table = &table;
+	ctypelist.TableSerial = ContrastTableSerial;
+}
+
+/**
+ * Get the compiled contrast table of a contrast type list.  A list that wasn't
+ * compiled, or whose table went stale, is compiled now.
+ * 
+ * @param ctypelist contrast type list of a plan definition, or the global one.
+ * @return contrast table
+ */
+const TargetContrastClass::ContrastTableStruct &TargetContrastClass::Get_Contrast_Table(const ContrastType &ctypelist)
+{
+	if (!ctypelist.Table ||
+		 ctypelist.TableSerial != ContrastTableSerial ||
+		 ctypelist.Table->TypeCount != GameObjectTypeManager.Get_Total_Object_Types() ||
+		 ctypelist.Table->Categories.size() != ctypelist.size())
+	{
+		Compile_Contrast_Table(ctypelist);
+	}
+	return *ctypelist.Table;
+}
+
+/**
+ * Fill in the best and average factor of every object type against every category
+ * in the contrast type list.
+ * 
+ * @param ctypelist contrast type list to compile.
+ * @param table     table to fill in.
+ */
+void TargetContrastClass::Build_Contrast_Table(const ContrastType &ctypelist, ContrastTableStruct &table)
+{
+	table.TypeCount = GameObjectTypeManager.Get_Total_Object_Types();
+	table.Categories.resize(0);
+	for (int bit = 0; bit < CONTRAST_CATEGORY_BITS; ++bit)
+	{
+		table.ColumnByBit[bit] = -1;
+	}
+	for (ContrastType::const_iterator i = ctypelist.begin(); i != ctypelist.end(); ++i)
+	{
+		unsigned int category = i->first;
+		if (category && (category & (category - 1)) == 0)
+		{
+			int bit = 0;
+			while ((category >>= 1) != 0) ++bit;
+			table.ColumnByBit[bit] = (int)table.Categories.size();
+		}
+		table.Categories.push_back(i->first);
+	}
+
+	int column_count = (int)table.Categories.size();
+	table.BestFactors.assign(table.TypeCount * column_count, 0.0f);
+	table.AverageFactors.assign(table.TypeCount * column_count, 0.0f);
+
+	for (int type_idx = 0; type_idx < table.TypeCount; ++type_idx)
+	{
+		const GameObjectTypeClass *type = GameObjectTypeManager.Get_Game_Object_Type(type_idx);
+		if (!type) continue;
+
+		// Rows are looked up by type index, so fall back to the weighted lists if they don't line up.
+		FAIL_IF(type->Get_Type_Index() != type_idx)
+		{
+			table.BestFactors.resize(0);
+			table.AverageFactors.resize(0);
+			return;
+		}
+
+		for (int column = 0; column < column_count; ++column)
+		{
+			table.BestFactors[type_idx * column_count + column] = Calculate_Best_Contrast_Factor(type, ctypelist, table.Categories[column]);
+			table.AverageFactors[type_idx * column_count + column] = Calculate_Average_Contrast_Factor(type, ctypelist, table.Categories[column]);
+		}
+	}
+}
+
+/**
+ * Find the entry for a type and category in a contrast table.
+ * 
+ * @return index into the factor arrays, or -1 if the table doesn't cover it.
+ */
+int TargetContrastClass::Get_Contrast_Table_Index(const ContrastTableStruct &table, const GameObjectTypeClass *type, unsigned int category)
+{
+	int type_idx = type->Get_Type_Index();
+	if (table.BestFactors.empty() || type_idx < 0 || type_idx >= table.TypeCount)
+	{
+		return -1;
+	}
+
+	// Only single bit categories have a column
+	if (category == 0 || (category & (category - 1)) != 0)
+	{
+		return -1;
+	}
+
+	int bit = 0;
+	while ((category >>= 1) != 0) ++bit;
+	int column = table.ColumnByBit[bit];
+	if (column < 0)
+	{
+		return -1;
+	}
+	return type_idx * (int)table.Categories.size() + column;
 }
 
 float TargetContrastClass::Get_Best_Contrast_Factor(const GameObjectTypeClass *type, PlanDefinitionClass *def, unsigned int category)
 {
 	const TargetContrastClass::ContrastType &ctypelist = def ? def->Get_Contrast_Type_List() : 
 																					ContrastTypeList;
+	const ContrastTableStruct &table = Get_Contrast_Table(ctypelist);
+	int index = Get_Contrast_Table_Index(table, type, category);
+	if (index >= 0)
+	{
+		return table.BestFactors[index];
+	}
+
+	return Calculate_Best_Contrast_Factor(type, ctypelist, category);
+}
+
+float TargetContrastClass::Get_Average_Contrast_Factor(const GameObjectTypeClass *type, PlanDefinitionClass *def, unsigned int category)
+{
+	const TargetContrastClass::ContrastType &ctypelist = def ? def->Get_Contrast_Type_List() : 
+																					ContrastTypeList;
+	const ContrastTableStruct &table = Get_Contrast_Table(ctypelist);
+	int index = Get_Contrast_Table_Index(table, type, category);
+	if (index >= 0)
+	{
+		return table.AverageFactors[index];
+	}
+
+	return Calculate_Average_Contrast_Factor(type, ctypelist, category);
+}
+
+float TargetContrastClass::Calculate_Best_Contrast_Factor(const GameObjectTypeClass *type, const ContrastType &ctypelist, unsigned int category)
+{
 	ContrastType::const_iterator it = ctypelist.find(category);
 	if (it == ctypelist.end())
 	{
@@ -464,10 +873,8 @@ float TargetContrastClass::Get_Best_Contrast_Factor(const GameObjectTypeClass *t
 	return best_weight;
 }
 
-float TargetContrastClass::Get_Average_Contrast_Factor(const GameObjectTypeClass *type, PlanDefinitionClass *def, unsigned int category)
+float TargetContrastClass::Calculate_Average_Contrast_Factor(const GameObjectTypeClass *type, const ContrastType &ctypelist, unsigned int category)
 {
-	const TargetContrastClass::ContrastType &ctypelist = def ? def->Get_Contrast_Type_List() : 
-																					ContrastTypeList;
 	ContrastType::const_iterator it = ctypelist.find(category);
 	if (it == ctypelist.end())
 	{
@@ -88,9 +88,62 @@ public:
 
 	typedef stdext::hash_map<MovementClassType, float> EffectivenessType;
 	typedef stdext::hash_map<MapEnvironmentType, EffectivenessType> TerrainEffectivenessTableType;
-	typedef stdext::hash_map<unsigned int, SmartPtr<WeightedTypeListClass> > ContrastType;
+	typedef stdext::hash_map<unsigned int, SmartPtr<WeightedTypeListClass> > ContrastMapType;
 	typedef std::vector<ContrastForceStruct> ResultType;
 
+	enum { CONTRAST_CATEGORY_BITS = 32 };
+
+	/**
+	 * Best and average contrast factors of every object type against every category
+	 * of a contrast type list, stored [type index * category count + column].  The
+	 * column of a single bit category is ColumnByBit[bit], -1 if the list has none.
+	 */
+	struct ContrastTableStruct
+	{
+		ContrastTableStruct() : TypeCount(0) {}
+
+		int								TypeCount;
+		std::vector<unsigned int>	Categories;
+		int								ColumnByBit[CONTRAST_CATEGORY_BITS];
+		std::vector<float>			BestFactors;
+		std::vector<float>			AverageFactors;
+	};
+
+	/**
+	 * Weighted type list for each enemy category, along with the compiled table
+	 * of its factors.  Lists with the same weights share one table.
+	 */
+	class ContrastType : public ContrastMapType
+	{
+	public:
+		ContrastType() : Table(NULL), TableSerial(-1) {}
+
+		mutable const ContrastTableStruct	*Table;
+		mutable int									TableSerial;
+	};
+
+	/**
+	 * One weight of a contrast type list.  A list's weights in order identify its table.
+	 */
+	struct ContrastWeightStruct
+	{
+		unsigned int						Category;
+		const GameObjectTypeClass		*Type;
+		unsigned int						TypeCategory;
+		float									Weight;
+
+		bool operator<(const ContrastWeightStruct &other) const
+		{
+			if (Category != other.Category) return Category < other.Category;
+			if (Type != other.Type) return Type < other.Type;
+			if (TypeCategory != other.TypeCategory) return TypeCategory < other.TypeCategory;
+			return Weight < other.Weight;
+		}
+	};
+
+	typedef std::vector<ContrastWeightStruct> ContrastSignatureType;
+	typedef std::map<ContrastSignatureType, ContrastTableStruct> ContrastTableListType;
+
 
 	static void Parse_Lua_Contrast_String(float &min_factor, float &max_factor, ContrastType & result);
 	static void Parse_Terrain_Effectiveness();
@@ -102,6 +155,9 @@ public:
 
 	static float Get_Best_Contrast_Factor(const GameObjectTypeClass *type, PlanDefinitionClass *def, unsigned int category);
 	static float Get_Average_Contrast_Factor(const GameObjectTypeClass *type, PlanDefinitionClass *def, unsigned int category);
+	static void Compile_Contrast_Table(const ContrastType &ctypelist);
+	static void Invalidate_Contrast_Tables(void);
+	static int Get_Contrast_Table_Serial(void) { return ContrastChangeSerial; }
 
 	static float Get_Effectiveness_On_Terrain(const GameObjectTypeClass *type, MapEnvironmentType terrain_type);
 
@@ -112,6 +168,23 @@ public:
 	static float MaxContrastFactor;
 	static ContrastType ContrastTypeList;
 	static TerrainEffectivenessTableType TerrainEffectiveness;
+
+private:
+
+	static void Get_Force_Perception_List(AIPlayerClass *ai_player, AITargetLocationClass *target, const ContrastType &ctypelist, bool ground_forces, std::vector<float> &forces);
+	static void Get_Space_Force_Perception_List(AIPlayerClass *ai_player, AITargetLocationClass *target, const ContrastType &ctypelist, bool surrounding_forces_only, std::vector<float> &forces);
+	static float Query_Force_Perception(AIPlayerClass *ai_player, AITargetLocationClass *target, float category, bool ground_forces);
+	static void Add_Base_Force_Perception(AIPlayerClass *ai_player, AITargetLocationClass *target, bool ground_forces, const int *categories, int count, float *forces);
+
+	static const ContrastTableStruct &Get_Contrast_Table(const ContrastType &ctypelist);
+	static void Build_Contrast_Table(const ContrastType &ctypelist, ContrastTableStruct &table);
+	static int Get_Contrast_Table_Index(const ContrastTableStruct &table, const GameObjectTypeClass *type, unsigned int category);
+	static float Calculate_Best_Contrast_Factor(const GameObjectTypeClass *type, const ContrastType &ctypelist, unsigned int category);
+	static float Calculate_Average_Contrast_Factor(const GameObjectTypeClass *type, const ContrastType &ctypelist, unsigned int category);
+
+	static ContrastTableListType ContrastTables;
+	static int ContrastTableSerial;			// Compiled tables older than this are stale
+	static int ContrastChangeSerial;			// Bumped whenever a contrast list or table is rebuilt
 };
 
 
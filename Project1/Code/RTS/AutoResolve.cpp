@@ -30,6 +30,8 @@
 #include "BombingRunManager.h"
 #include "BombingRunEvent.h"
 #include "GameScoringManager.h"
+#include "AutoResolveSimulation.h"
+#include	<map>
 
 /*
 **	See documentation in AutoResolve.h
@@ -675,6 +677,209 @@ void AutoResolveClass::Kill_Retreating_Units(void)
 }
 
 
+/*!
+**	Queue indices of the units still waiting for attrition, in queue order.  Counts is a Fenwick tree
+**	over the queue, so the unit at a position among those still left is found and removed in log time
+**	and a SyncRandom draw picks the same unit that erasing it from the queue always did.
+*/
+class AttritionPickListClass
+{
+public:
+	void Reset(int count);
+	int Size(void) const { return Remaining; }
+	bool Is_Picked(int unit) const { return Picked[unit] != 0; }
+	int Pick(int position);
+	void Remove(int unit);
+
+private:
+	std::vector<int> Counts;						//!< 1-based Fenwick tree, 1 for each unit not yet picked
+	std::vector<char> Picked;
+	int Remaining;
+	int TopStep;										//!< Highest power of two not above the unit count
+};
+
+
+void AttritionPickListClass::Reset(int count)
+{
+	Remaining = count;
+
+	Picked.resize(0);
+	Picked.resize(count, 0);
+
+	Counts.resize(0);
+	Counts.resize(count + 1, 0);
+	for (int slot = 1; slot <= count; ++slot)
+	{
+		Counts[slot] += 1;
+		int parent = slot + (slot & -slot);
+		if (parent <= count)
+		{
+			Counts[parent] += Counts[slot];
+		}
+	}
+
+	TopStep = 1;
+	while (TopStep * 2 <= count)
+	{
+		TopStep *= 2;
+	}
+}
+
+
+/*!
+**	Remove and return the unit at a position among those still left, counting from 0.
+*/
+int AttritionPickListClass::Pick(int position)
+{
+	int count = static_cast<int>(Picked.size());
+
+	//Find the last slot with no more than position units left before it
+	int slot = 0;
+	for (int step = TopStep; step > 0; step >>= 1)
+	{
+		if (slot + step <= count && Counts[slot + step] <= position)
+		{
+			slot += step;
+			position -= Counts[slot];
+		}
+	}
+
+	Remove(slot);
+	return slot;
+}
+
+
+/*!
+**	Remove a unit that was picked without a draw.
+*/
+void AttritionPickListClass::Remove(int unit)
+{
+	assert(!Picked[unit]);
+	Picked[unit] = 1;
+
+	int count = static_cast<int>(Picked.size());
+	for (int i = unit + 1; i <= count; i += i & -i)
+	{
+		Counts[i]--;
+	}
+	Remaining--;
+}
+
+
+#ifndef NDEBUG
+/*!
+**	Fixed seed generator for Check_Attrition_Picks, drawn from the same way as SyncRandom.Get.
+*/
+class AttritionCheckRandomClass
+{
+public:
+	AttritionCheckRandomClass(unsigned int seed) : State(seed ? seed : 0x6b8b4567) {}
+
+	int Get(int min_value, int max_value)
+	{
+		State ^= State << 13;
+		State ^= State >> 17;
+		State ^= State << 5;
+		return min_value + static_cast<int>(State % static_cast<unsigned int>(max_value - min_value + 1));
+	}
+
+private:
+	unsigned int State;
+};
+
+
+/*!
+**	Debug check of the attrition pick order against the loop Apply_Attrition used to run, which
+**	erased each pick from the queue.  Queues of every size up to 200 with a changing mix of heroes
+**	and structures are run through both with the same fixed seed and must come out in the same order.
+**
+**	@return true if every seed picked the same order
+*/
+bool AutoResolveClass::Check_Attrition_Picks(int seed_count)
+{
+	std::vector<char> ordered;
+	std::vector<int> queue;
+	std::vector<int> erased_order;
+	std::vector<int> picked_order;
+	AttritionPickListClass picks;
+	int mismatches = 0;
+
+	for (int seed = 1; seed <= seed_count; ++seed)
+	{
+		AttritionCheckRandomClass setup(seed);
+		int count = setup.Get(0, 200);
+		int ordered_chance = setup.Get(0, 4);
+		ordered.resize(0);
+		for (int i = 0; i < count; ++i)
+		{
+			ordered.push_back(setup.Get(0, 9) < ordered_chance ? 1 : 0);
+		}
+
+		//The old loop: rescan for the first hero or structure, else draw, then erase the pick
+		AttritionCheckRandomClass erased_random(seed);
+		queue.resize(0);
+		for (int i = 0; i < count; ++i)
+		{
+			queue.push_back(i);
+		}
+		erased_order.resize(0);
+		while (queue.size() != 0)
+		{
+			int unit_index = -1;
+			for (unsigned int i = 0; i < queue.size(); ++i)
+			{
+				if (ordered[queue[i]])
+				{
+					unit_index = static_cast<int>(i);
+					break;
+				}
+			}
+			if (unit_index == -1)
+			{
+				unit_index = erased_random.Get(0, queue.size()-1);
+			}
+			erased_order.push_back(queue[unit_index]);
+			queue.erase(queue.begin() + unit_index);
+		}
+
+		//The pick list, the way Apply_Attrition drives it
+		AttritionCheckRandomClass picked_random(seed);
+		picks.Reset(count);
+		picked_order.resize(0);
+		while (picks.Size() != 0)
+		{
+			int unit_index = -1;
+			for (int i = 0; i < count; ++i)
+			{
+				if (!picks.Is_Picked(i) && ordered[i])
+				{
+					unit_index = i;
+					break;
+				}
+			}
+			if (unit_index == -1)
+			{
+				unit_index = picks.Pick(picked_random.Get(0, picks.Size()-1));
+			}
+			else
+			{
+				picks.Remove(unit_index);
+			}
+			picked_order.push_back(unit_index);
+		}
+
+		if (picked_order != erased_order)
+		{
+			Debug_Printf("AutoResolveClass::Check_Attrition_Picks -- seed %d, %d units: pick order differs from the erase loop\n", seed, count);
+			++mismatches;
+		}
+	}
+
+	return mismatches == 0;
+}
+#endif
+
+
 bool AutoResolveClass::Apply_Attrition(std::vector<ICombatantBehaviorPtr> &units, TargetContrastClass::ResultType &current, 
 													ICombatantBehaviorPtr &weakest_unit, bool is_loser, int index, ICombatantBehaviorPtr killer)
 {
@@ -694,14 +899,21 @@ bool AutoResolveClass::Apply_Attrition(std::vector<ICombatantBehaviorPtr> &units
 	}
 
 	static std::vector<ICombatantBehaviorPtr> left_overs;
+	static AttritionPickListClass random_picks;
 
-	while (units.size() != 0)
+	random_picks.Reset(static_cast<int>(units.size()));
+
+	while (random_picks.Size() != 0)
 	{
 		int unit_index = -1;
 		is_structure = false;
 
+		//Named heroes and ground structures take their attrition first, in queue order.  Rescanned each pass
+		//since what a unit contains is read from the live object and can change as the others are killed.
 		for (unsigned int i = 0; i < units.size(); ++i)
 		{
+			if (random_picks.Is_Picked(static_cast<int>(i))) continue;
+
 			const GameObjectClass *object = units[i]->Get_Object();
 			if (object && object->Contains_Named_Hero())
 			{
@@ -718,7 +930,12 @@ bool AutoResolveClass::Apply_Attrition(std::vector<ICombatantBehaviorPtr> &units
 
 		if (unit_index == -1)
 		{
-			unit_index = SyncRandom.Get(0, units.size()-1);
+			//Everyone else goes in random order, one SyncRandom pick over the units still left
+			unit_index = random_picks.Pick(SyncRandom.Get(0, random_picks.Size()-1));
+		}
+		else
+		{
+			random_picks.Remove(unit_index);
 		}
 
 		const GameObjectClass *object = units[unit_index]->Get_Object();
@@ -741,7 +958,7 @@ bool AutoResolveClass::Apply_Attrition(std::vector<ICombatantBehaviorPtr> &units
 				if (is_loser && mSides[index ? 0 : 1].mSuperWeaponKiller)
 				{
 					kill_unit = true;
-					if (weakest_unit == units[i]) weakest_unit.Release_Ref();
+					if (weakest_unit == units[unit_index]) weakest_unit.Release_Ref();
 				}
 			}
 			else if (is_loser && object->Behaves_Like(BEHAVIOR_PLANET))
@@ -872,8 +1089,6 @@ bool AutoResolveClass::Apply_Attrition(std::vector<ICombatantBehaviorPtr> &units
 		{
 			left_overs.push_back(units[unit_index]);
 		}
-
-		units.erase(units.begin()+unit_index);
 	}
 
 	units = left_overs;
@@ -904,6 +1119,7 @@ bool AutoResolveClass::Apply_Attrition(std::vector<ICombatantBehaviorPtr> &units
 void AutoResolveClass::Find_Contrast_Index(float remaining_power,
 														 const GameObjectTypeClass *type,
                                            const TargetContrastClass::ResultType &current,
+                                           MapEnvironmentType terrain,
                                            int &best_category)
 {
 	float best_weight = 0.0f;
@@ -920,9 +1136,9 @@ void AutoResolveClass::Find_Contrast_Index(float remaining_power,
 		}
 
 		float contrast_weight = TargetContrastClass::Get_Average_Contrast_Factor(type, NULL, current[i].Category);
-		if (mTerrainType != MAP_TYPE_INVALID)
+		if (terrain != MAP_TYPE_INVALID)
 		{
-			contrast_weight *= TargetContrastClass::Get_Effectiveness_On_Terrain(type, mTerrainType);
+			contrast_weight *= TargetContrastClass::Get_Effectiveness_On_Terrain(type, terrain);
 		}
 
 		if (contrast_weight <= 0.0f)
@@ -948,6 +1164,94 @@ void AutoResolveClass::Find_Contrast_Index(float remaining_power,
 }
 
 
+/*!
+**	What one combatant of a type adds to its side's force at a tech level.  The type's power metric,
+**	contrast category and garrison don't change during a game, so each is worked out once.
+*/
+struct AutoResolvePowerBreakdownStruct
+{
+	AutoResolvePowerBreakdownStruct(void) : Power(0.0f), Column(-1), Transport(false) {}
+
+	float Power;										//!< AI combat power of the type itself
+	int Column;											//!< Result column of the type's first contrast category, or -1 if it has none
+	bool Transport;
+	std::vector<std::pair<int, float> > GarrisonForce;								//!< Result column and total power of each garrison type
+	std::vector<std::pair<const GameObjectTypeClass *, int> > Garrison;		//!< Spawned unit types and starting counts
+};
+
+typedef std::map<std::pair<const GameObjectTypeClass *, int>, AutoResolvePowerBreakdownStruct> AutoResolvePowerBreakdownTableType;
+
+static AutoResolvePowerBreakdownTableType PowerBreakdowns;
+static int PowerBreakdownTypeCount = 0;
+static int PowerBreakdownContrastSerial = -1;
+
+
+/*!
+**	Result column that Calculate_Side_Force files a category mask under: the first contrast
+**	category it matches, offset past the ground and space totals.
+*/
+static int Get_Contrast_Column(unsigned int category_mask)
+{
+	int cidx = 2;
+	for (TargetContrastClass::ContrastType::const_iterator it = TargetContrastClass::ContrastTypeList.begin();
+			it != TargetContrastClass::ContrastTypeList.end();
+			it++, cidx++)
+	{
+		if (category_mask & it->first)
+		{
+			return cidx;
+		}
+	}
+	return -1;
+}
+
+
+/*!
+**	Get the power breakdown of a type at a tech level, building it on first use.  The table is
+**	thrown away whenever the type list changes size or a contrast list or table is rebuilt.
+*/
+static const AutoResolvePowerBreakdownStruct &Get_Power_Breakdown(const GameObjectTypeClass *type, int tech_level)
+{
+	if (PowerBreakdownTypeCount != GameObjectTypeManager.Get_Total_Object_Types() ||
+		 PowerBreakdownContrastSerial != TargetContrastClass::Get_Contrast_Table_Serial())
+	{
+		PowerBreakdowns.clear();
+		PowerBreakdownTypeCount = GameObjectTypeManager.Get_Total_Object_Types();
+		PowerBreakdownContrastSerial = TargetContrastClass::Get_Contrast_Table_Serial();
+	}
+
+	std::pair<AutoResolvePowerBreakdownTableType::iterator, bool> entry =
+		PowerBreakdowns.insert(std::make_pair(std::make_pair(type, tech_level), AutoResolvePowerBreakdownStruct()));
+	AutoResolvePowerBreakdownStruct &breakdown = entry.first->second;
+	if (!entry.second)
+	{
+		return breakdown;
+	}
+
+	breakdown.Power = type->Get_AI_Combat_Power_Metric();
+	breakdown.Column = Get_Contrast_Column((unsigned int)type->Get_Category_Mask());
+	breakdown.Transport = type->Behaves_Like(BEHAVIOR_TRANSPORT);
+
+	int garrison_type_count = type->Get_Spawned_Unit_Type_Count(tech_level);
+	for (int j = 0; j < garrison_type_count; ++j)
+	{
+		const GameObjectTypeClass *garrison_type = type->Get_Spawned_Unit_Type(tech_level, j);
+		FAIL_IF(!garrison_type) { continue; }
+
+		breakdown.Garrison.push_back(std::make_pair(garrison_type, (int)type->Get_Spawned_Unit_Starting_Count(tech_level, garrison_type)));
+
+		int column = Get_Contrast_Column((unsigned int)garrison_type->Get_Category_Mask());
+		if (column != -1)
+		{
+			float total_force = type->Get_Spawned_Unit_Starting_Count(tech_level, garrison_type) * garrison_type->Get_AI_Combat_Power_Metric();
+			breakdown.GarrisonForce.push_back(std::make_pair(column, total_force));
+		}
+	}
+
+	return breakdown;
+}
+
+
 void AutoResolveClass::Side_Attack(std::vector<ICombatantBehaviorPtr> &units, TargetContrastClass::ResultType &target_force, 
                                    TargetContrastClass::ResultType &result, int player_id)
 {
@@ -996,7 +1300,7 @@ void AutoResolveClass::Side_Attack(std::vector<ICombatantBehaviorPtr> &units, Ta
 		float remaining_power = mBomberType->Get_AI_Combat_Power_Metric();
 		while (remaining_power > 0.0f && best_category != 0)
 		{
-			Find_Contrast_Index(remaining_power, mBomberType, result, best_category);
+			Find_Contrast_Index(remaining_power, mBomberType, result, mTerrainType, best_category);
 			Apply_Unit_Contrast(remaining_power, mBomberType, result, best_category, cat_table, mTerrainType);
 			best_category = 0;
 		}	
@@ -1020,10 +1324,10 @@ void AutoResolveClass::Side_Attack(std::vector<ICombatantBehaviorPtr> &units, Ta
 				{
 					const GameObjectTypeClass *built_type = planet_data->Get_Persistent_Built_Tactical_Object_Type_At_Index(j);
 					FAIL_IF(!built_type) { continue; }
-					float remaining_power = built_type->Get_AI_Combat_Power_Metric();
+					float remaining_power = Get_Power_Breakdown(built_type, owner->Get_Tech_Level()).Power;
 					while (remaining_power > 0.0f && best_category != 0)
 					{
-						Find_Contrast_Index(remaining_power, built_type, result, best_category);
+						Find_Contrast_Index(remaining_power, built_type, result, mTerrainType, best_category);
 						Apply_Unit_Contrast(remaining_power, built_type, result, best_category, cat_table, mTerrainType);
 						best_category = 0;
 					}	
@@ -1038,22 +1342,20 @@ void AutoResolveClass::Side_Attack(std::vector<ICombatantBehaviorPtr> &units, Ta
 		{
 			add_garrison = false;
 		}
-		int tech_level = owner->Get_Tech_Level();
-		int garrison_type_count = type->Get_Spawned_Unit_Type_Count(tech_level);
+		const AutoResolvePowerBreakdownStruct &breakdown = Get_Power_Breakdown(type, owner->Get_Tech_Level());
 		if (add_garrison)
 		{
-			for (int j = 0; j < garrison_type_count; ++j)
+			for (int j = 0; j < (int)breakdown.Garrison.size(); ++j)
 			{
-				const GameObjectTypeClass *garrison_type = type->Get_Spawned_Unit_Type(tech_level, j);
-				FAIL_IF(!garrison_type) { continue; }
+				const GameObjectTypeClass *garrison_type = breakdown.Garrison[j].first;
 
-				int active_count = type->Get_Spawned_Unit_Starting_Count(tech_level, garrison_type);
+				int active_count = breakdown.Garrison[j].second;
 				for (int k = 0; k < active_count; ++k)
 				{
 					float remaining_power = garrison_type->Get_AI_Combat_Power_Metric();
 					while (remaining_power > 0.0f && best_category != 0)
 					{
-						Find_Contrast_Index(remaining_power, garrison_type, result, best_category);
+						Find_Contrast_Index(remaining_power, garrison_type, result, mTerrainType, best_category);
 						Apply_Unit_Contrast(remaining_power, garrison_type, result, best_category, cat_table, mTerrainType);
 						best_category = 0;
 					}
@@ -1061,12 +1363,12 @@ void AutoResolveClass::Side_Attack(std::vector<ICombatantBehaviorPtr> &units, Ta
 			}
 		}
 
-		if (type->Behaves_Like(BEHAVIOR_TRANSPORT) && mIsSpace) continue;
+		if (breakdown.Transport && mIsSpace) continue;
 
-		float remaining_power = type->Get_AI_Combat_Power_Metric();
+		float remaining_power = breakdown.Power;
 		while (remaining_power > 0.0f && best_category != 0)
 		{
-			Find_Contrast_Index(remaining_power, type, result, best_category);
+			Find_Contrast_Index(remaining_power, type, result, mTerrainType, best_category);
 			Apply_Unit_Contrast(remaining_power, type, result, best_category, cat_table, mTerrainType);
 			best_category = 0;
 		}
@@ -1131,6 +1433,8 @@ void AutoResolveClass::Calculate_Side_Force(std::vector<ICombatantBehaviorPtr> &
 	result[1].Ground = false;
 
 	float weakest_val = BIG_FLOAT;
+	int labeled_column = 1;
+	int last_column = (int)TargetContrastClass::ContrastTypeList.size() + 1;
 
 	for (i = 0; i < (int)units.size(); i++)
 	{
@@ -1149,18 +1453,11 @@ void AutoResolveClass::Calculate_Side_Force(std::vector<ICombatantBehaviorPtr> &
 					const GameObjectTypeClass *built_type = planet_data->Get_Persistent_Built_Tactical_Object_Type_At_Index(j);
 					FAIL_IF(!built_type) { continue; }
 
-					int cidx = 2;
-					for (TargetContrastClass::ContrastType::const_iterator it = TargetContrastClass::ContrastTypeList.begin();
-							it != TargetContrastClass::ContrastTypeList.end();
-							it++, cidx++)
+					const AutoResolvePowerBreakdownStruct &built_breakdown = Get_Power_Breakdown(built_type, owner->Get_Tech_Level());
+					if (built_breakdown.Column != -1)
 					{
-						unsigned int category = it->first;
-						if ((built_type->Get_Category_Mask() & category) != 0)
-						{
-							result[cidx].Force += built_type->Get_AI_Combat_Power_Metric();
-							result[0].Force += built_type->Get_AI_Combat_Power_Metric();
-							break;
-						}
+						result[built_breakdown.Column].Force += built_breakdown.Power;
+						result[0].Force += built_breakdown.Power;
 					}
 				}
 			}
@@ -1173,58 +1470,41 @@ void AutoResolveClass::Calculate_Side_Force(std::vector<ICombatantBehaviorPtr> &
 		{
 			add_garrison = false;
 		}
-		int tech_level = owner->Get_Tech_Level();
-		int garrison_type_count = type->Get_Spawned_Unit_Type_Count(tech_level);
+		const AutoResolvePowerBreakdownStruct &breakdown = Get_Power_Breakdown(type, owner->Get_Tech_Level());
 		if (add_garrison)
 		{
-			for (int j = 0; j < garrison_type_count; ++j)
+			for (int j = 0; j < (int)breakdown.GarrisonForce.size(); ++j)
 			{
-				const GameObjectTypeClass *garrison_type = type->Get_Spawned_Unit_Type(tech_level, j);
-				FAIL_IF(!garrison_type) { continue; }
-
-				int cidx = 2;
-				for (TargetContrastClass::ContrastType::const_iterator it = TargetContrastClass::ContrastTypeList.begin();
-						it != TargetContrastClass::ContrastTypeList.end();
-						it++, cidx++)
-				{
-
-					unsigned int category = it->first;
-					if ((unsigned int)garrison_type->Get_Category_Mask() & category)
-					{
-						float total_force = type->Get_Spawned_Unit_Starting_Count(tech_level, garrison_type) * garrison_type->Get_AI_Combat_Power_Metric();
-						result[cidx].Force += total_force;
-						result[mIsSpace ? 1 : 0].Force += total_force;
-						break;
-					}
-				}
+				result[breakdown.GarrisonForce[j].first].Force += breakdown.GarrisonForce[j].second;
+				result[mIsSpace ? 1 : 0].Force += breakdown.GarrisonForce[j].second;
 			}
 		}
 
-		if (type->Behaves_Like(BEHAVIOR_TRANSPORT) && mIsSpace) continue;
+		if (breakdown.Transport && mIsSpace) continue;
 
-		if (type->Get_AI_Combat_Power_Metric() < weakest_val)
+		if (breakdown.Power < weakest_val)
 		{
 			weakest_unit = units[i];
-			weakest_val = type->Get_AI_Combat_Power_Metric();
+			weakest_val = breakdown.Power;
 		}
 
-		int cidx = 2;
-		for (TargetContrastClass::ContrastType::const_iterator it = TargetContrastClass::ContrastTypeList.begin();
-				it != TargetContrastClass::ContrastTypeList.end();
-				it++, cidx++)
+		//Columns up to the type's own category get labeled, as do all of them if it has none
+		labeled_column = Max(labeled_column, breakdown.Column == -1 ? last_column : breakdown.Column);
+		if (breakdown.Column != -1)
 		{
-
-			unsigned int category = it->first;
-			result[cidx].Category = category;
-			result[cidx].Ground = !mIsSpace;
-			if ((unsigned int)type->Get_Category_Mask() & category)
-			{
-				result[cidx].Force += type->Get_AI_Combat_Power_Metric();
-				result[mIsSpace ? 1 : 0].Force += type->Get_AI_Combat_Power_Metric();
-				break;
-			}
+			result[breakdown.Column].Force += breakdown.Power;
+			result[mIsSpace ? 1 : 0].Force += breakdown.Power;
 		}
 	}
+
+	int cidx = 2;
+	for (TargetContrastClass::ContrastType::const_iterator it = TargetContrastClass::ContrastTypeList.begin();
+			it != TargetContrastClass::ContrastTypeList.end() && cidx <= labeled_column;
+			it++, cidx++)
+	{
+		result[cidx].Category = it->first;
+		result[cidx].Ground = !mIsSpace;
+	}
 }
 
 
@@ -1257,12 +1537,24 @@ HRESULT AutoResolveClass::Combat_Round(bool instant)
 		float winner_attrition_value = mRetreatInProgress ? TheGameConstants.Get_Retreat_Auto_Resolve_Winner_Attrition() :
 			TheGameConstants.Get_Auto_Resolve_Winner_Attrition();
 
+#ifndef NDEBUG
+		//Snapshot the sides before anything is applied, to check the headless simulation against this battle
+		AutoResolveSimulationClass simulation(mIsSpace, mTerrainType);
+		bool order_free[2];
+		bool check_simulation = Snapshot_Sides(simulation, order_free);
+#endif
+
 		TargetContrastClass::ResultType results[2];
 		Side_Attack(mSides[0].mQueue, mSides[1].mTotalForce, results[1], mSides[0].mOwnerID);
 		Side_Attack(mSides[1].mQueue, mSides[0].mTotalForce, results[0], mSides[1].mOwnerID);
 
 		int winner = Determine_Winner_Index(results[0], results[1]);
 		int loser = (winner == 0 ? 1 : 0);
+
+#ifndef NDEBUG
+		//A super weapon without its killer makes the other side retreat, which the simulation doesn't model
+		check_simulation = check_simulation && !mRetreatInProgress;
+#endif
       
 		PlayerClass *lplayer = PlayerList.Get_Player_By_ID(mSides[loser].mOwnerID);
 		bool pirate_player = false;
@@ -1303,6 +1595,13 @@ HRESULT AutoResolveClass::Combat_Round(bool instant)
 				Player_Retreats(mSides[i].mOwnerID);
 		}
 
+#ifndef NDEBUG
+		if (check_simulation)
+		{
+			Check_Simulation(simulation, winner, order_free);
+		}
+#endif
+
 		if (mSides[loser].mQueue.size() == 0 && mRetreatInProgress)
 		{
 			mRetreatInProgress = false;
@@ -2312,6 +2611,110 @@ const GameObjectTypeClass *AutoResolveClass::Get_Type_From_Combatant(ICombatantB
 	return type;
 }
 
+#ifndef NDEBUG
+/*!
+**	Debug snapshot of the live sides for AutoResolveSimulationClass, made the way a caller of the simulation
+**	would, through Add_Type, plus what only the live objects know.  A side is order free when every unit on it
+**	has the same type, so its number of survivors doesn't depend on the attrition order.
+**
+**	@return false if the battle has something the simulation doesn't model
+*/
+bool AutoResolveClass::Snapshot_Sides(AutoResolveSimulationClass &simulation, bool order_free[2])
+{
+	if (mRetreatInProgress || mMidTactical || mBomberType)
+	{
+		return false;
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(mSides); i++)
+	{
+		PlayerClass *owner = PlayerList.Get_Player_By_ID(mSides[i].mOwnerID);
+		if (!owner)
+		{
+			return false;
+		}
+
+		AutoResolveSimulationClass::SideStruct &side = simulation.Get_Side(i);
+		side.Playable = owner->Get_Faction()->Is_Playable();
+		side.Human = owner->Is_Human();
+
+		order_free[i] = true;
+		const GameObjectTypeClass *side_type = NULL;
+		for (unsigned int j = 0; j < mSides[i].mQueue.size(); ++j)
+		{
+			const GameObjectClass *object = mSides[i].mQueue[j]->Get_Object();
+			if (object->Behaves_Like(BEHAVIOR_PLANET) || (mIsSpace && object->Behaves_Like(BEHAVIOR_TRANSPORT)))
+			{
+				return false;
+			}
+
+			const GameObjectTypeClass *type = Get_Type_From_Combatant(mSides[i].mQueue[j]);
+			simulation.Add_Type(i, type, 1, owner->Get_Tech_Level(), mPlanet);
+
+			AutoResolveSimulationClass::UnitStruct &unit = side.Units.back();
+			unit.Hero = object->Contains_Named_Hero();
+			if (object->Get_Parent_Mode_ID() != INVALID_OBJECT_ID)
+			{
+				unit.Garrison.resize(0);
+			}
+
+			GameObjectClass *hero_object = PotentialPlanClass::Get_Hero_Object_From_Build_Object(const_cast<GameObjectClass *>(object));
+			const GameObjectTypeClass *hero_type = PotentialPlanClass::Get_Hero_Type_From_Build_Type(const_cast<GameObjectTypeClass *>(type));
+			unit.AbilityFactors.resize(0);
+			if (hero_type->Has_Special_Ability(hero_object))
+			{
+				unit.AbilityFactors = hero_type->Get_Special_Ability_Unit_Strength_Factors(hero_object, mPlanet);
+			}
+
+			if (side_type && side_type != type)
+			{
+				order_free[i] = false;
+			}
+			side_type = type;
+		}
+	}
+
+	simulation.Set_Aggressor(mAggressor == mSides[0].mOwnerID ? 0 : 1);
+	return true;
+}
+
+
+/*!
+**	Debug check of the headless simulation against the battle just fought.  The winner has to match, and so
+**	does the number of survivors on each order free side.
+*/
+void AutoResolveClass::Check_Simulation(const AutoResolveSimulationClass &simulation, int winner, const bool order_free[2])
+{
+	AutoResolveSimulationClass::OutcomeStruct predicted;
+	simulation.Simulate(1, 0, predicted);
+
+	if (predicted.Winner != winner)
+	{
+		Debug_Printf("AutoResolveClass::Check_Simulation -- simulation picked side %d to win, the battle side %d\n", predicted.Winner, winner);
+		assert(false);
+		return;
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(mSides); i++)
+	{
+		if (!order_free[i]) continue;
+
+		int survivors = 0;
+		for (unsigned int e = 0; e < predicted.Survivors[i].size(); ++e)
+		{
+			survivors += (int)(predicted.Survivors[i][e] + 0.5f);
+		}
+
+		if (survivors != (int)mSides[i].mQueue.size())
+		{
+			Debug_Printf("AutoResolveClass::Check_Simulation -- simulation left %d survivors on side %d, the battle %d\n",
+							 survivors, i, mSides[i].mQueue.size());
+			assert(false);
+		}
+	}
+}
+#endif
+
 int AutoResolveClass::Determine_Winner_Index(TargetContrastClass::ResultType &results_a, TargetContrastClass::ResultType &results_b)
 {
 	// Death Star hack.  Death star always wins unless Luke is on the opposition.
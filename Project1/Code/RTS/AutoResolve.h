@@ -18,6 +18,10 @@
 
 #define MAX_HISTORY 8
 
+class AutoResolveSimulationClass;
+
+bool Contains_Super_Weapon_Killer(const GameObjectTypeClass *type);
+
 struct AutoResolveKilled
 {
 	const GameObjectTypeClass *Object;
@@ -60,9 +64,12 @@ class AutoResolveClass : public IAutoResolveClass
 		bool Apply_Attrition(std::vector<ICombatantBehaviorPtr> &units, TargetContrastClass::ResultType &current, ICombatantBehaviorPtr &weakest_unit, 
 									bool is_loser, int index, ICombatantBehaviorPtr killer);
 		bool Apply_Transport_Losses(std::vector<ICombatantBehaviorPtr> &units, bool is_pirate, ICombatantBehaviorPtr killer);
-      void Find_Contrast_Index(float remaining_power, const GameObjectTypeClass *type, const TargetContrastClass::ResultType &current, 
-											int &best_category);
-		void Apply_Unit_Contrast(float &remaining_power, const GameObjectTypeClass *type, TargetContrastClass::ResultType &current, 
+#ifndef NDEBUG
+		static bool Check_Attrition_Picks(int seed_count);
+#endif
+      static void Find_Contrast_Index(float remaining_power, const GameObjectTypeClass *type, const TargetContrastClass::ResultType &current, 
+											MapEnvironmentType terrain, int &best_category);
+		static void Apply_Unit_Contrast(float &remaining_power, const GameObjectTypeClass *type, TargetContrastClass::ResultType &current, 
 											int best_category, const std::vector<float> &factor_table, MapEnvironmentType terrain);
 		void Side_Attack(std::vector<ICombatantBehaviorPtr> &units, TargetContrastClass::ResultType &target_force, TargetContrastClass::ResultType &result, int player_id);
 		void Calculate_Side_Force(std::vector<ICombatantBehaviorPtr> &units, TargetContrastClass::ResultType &result, 
@@ -146,6 +153,10 @@ class AutoResolveClass : public IAutoResolveClass
 		HRESULT Unit_Fire(SideStruct * side, SideStruct * otherside);
 		const GameObjectTypeClass *Get_Type_From_Combatant(ICombatantBehaviorPtr combatant);
 		int Determine_Winner_Index(TargetContrastClass::ResultType &results_a, TargetContrastClass::ResultType &results_b);
+#ifndef NDEBUG
+		bool Snapshot_Sides(AutoResolveSimulationClass &simulation, bool order_free[2]);
+		void Check_Simulation(const AutoResolveSimulationClass &simulation, int winner, const bool order_free[2]);
+#endif
 
 		bool mIsCombatPrepared;		//!< Combat has been given a space or land context
 
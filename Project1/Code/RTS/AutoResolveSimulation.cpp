@@ -0,0 +1,600 @@
+/***********************************************************************************************
+ ***              C O N F I D E N T I A L  ---  P E T R O G L Y P H   G A M E S, inc.        ***
+ ***********************************************************************************************/
+/** @file
+ *
+ *		The AutoResolveSimulationClass functions and methods are defined in this file.
+ */
+
+#pragma hdrstop
+#include	"Always.h"
+#include	"AutoResolveSimulation.h"
+#include	"AutoResolve.h"
+#include	"GameConstants.h"
+#include "AI/Planning/PotentialPlan.h"
+#include "Utils.h"
+#include "GameObjectTypeManager.h"
+#include "GameObjectCategoryType.h"
+
+
+/*!
+**	Xorshift generator used for the attrition order of one side in one trial.
+*/
+class SimulationRandomClass
+{
+	public:
+		SimulationRandomClass(unsigned int seed) : mState(seed ? seed : 0x6b8b4567) {}
+
+		int Get(int low, int high)
+		{
+			mState ^= mState << 13;
+			mState ^= mState >> 17;
+			mState ^= mState << 5;
+			return low + (int)(mState % (unsigned int)(high - low + 1));
+		}
+
+	private:
+		unsigned int mState;
+};
+
+
+/*!
+**	Spread neighbouring stream numbers across the seed space so trials don't share an order.
+*/
+static unsigned int Stream_Seed(unsigned int seed, unsigned int stream)
+{
+	unsigned int value = seed ^ (stream * 0x9e3779b9);
+	value ^= value >> 16;
+	value *= 0x85ebca6b;
+	value ^= value >> 13;
+	value *= 0xc2b2ae35;
+	value ^= value >> 16;
+	return value;
+}
+
+
+struct SimulationInstanceStruct
+{
+	SimulationInstanceStruct(int entry, bool weakest) : Entry(entry), Weakest(weakest) {}
+
+	int Entry;
+	bool Weakest;
+};
+
+
+/*
+**	See documentation in AutoResolveSimulation.h
+*/
+void AutoResolveSimulationClass::Add_Type(int side, const GameObjectTypeClass *type, int count, int tech_level, GameObjectClass *planet)
+{
+	FAIL_IF(side < 0 || side >= ARRAY_SIZE(mSides)) { return; }
+	FAIL_IF(!type) { return; }
+	if (count <= 0) return;
+
+	const GameObjectTypeClass *hero_type = PotentialPlanClass::Get_Hero_Type_From_Build_Type(const_cast<GameObjectTypeClass *>(type));
+
+	UnitStruct unit;
+	unit.Type = type;
+	unit.Count = count;
+	unit.Power = type->Get_AI_Combat_Power_Metric();
+	unit.CategoryMask = (unsigned int)type->Get_Category_Mask();
+	unit.Hero = hero_type->Is_Named_Hero();
+	unit.Structure = type->Behaves_Like(BEHAVIOR_DUMMY_GROUND_STRUCTURE);
+	unit.Transport = type->Behaves_Like(BEHAVIOR_TRANSPORT);
+	unit.SuperWeapon = hero_type->Is_Super_Weapon();
+	unit.SuperWeaponKiller = Contains_Super_Weapon_Killer(type);
+
+	int garrison_type_count = type->Get_Spawned_Unit_Type_Count(tech_level);
+	for (int j = 0; j < garrison_type_count; ++j)
+	{
+		const GameObjectTypeClass *garrison_type = type->Get_Spawned_Unit_Type(tech_level, j);
+		FAIL_IF(!garrison_type) { continue; }
+
+		unit.Garrison.push_back(std::make_pair(garrison_type, (int)type->Get_Spawned_Unit_Starting_Count(tech_level, garrison_type)));
+	}
+
+	if (hero_type->Has_Special_Ability(NULL))
+	{
+		unit.AbilityFactors = hero_type->Get_Special_Ability_Unit_Strength_Factors(NULL, planet);
+	}
+
+	mSides[side].Units.push_back(unit);
+}
+
+
+/*
+**	See documentation in AutoResolveSimulation.h
+*/
+void AutoResolveSimulationClass::Simulate(int trials, unsigned int seed, OutcomeStruct &outcome) const
+{
+	//Changes global state, which is why this has to run on the main thread
+	TargetContrastClass::Init_Contrast_Type_List();
+
+	TargetContrastClass::ResultType total_force[2];
+	int weakest_entry[2];
+	Calculate_Side_Force(mSides[0], total_force[0], weakest_entry[0]);
+	Calculate_Side_Force(mSides[1], total_force[1], weakest_entry[1]);
+
+	TargetContrastClass::ResultType results[2];
+	Side_Attack(mSides[0], total_force[1], results[1]);
+	Side_Attack(mSides[1], total_force[0], results[0]);
+
+	int winner = Determine_Winner_Index(results[0], results[1]);
+	int loser = (winner == 0 ? 1 : 0);
+
+	float loser_attrition_value = TheGameConstants.Get_Auto_Resolve_Loser_Attrition();
+	float winner_attrition_value = TheGameConstants.Get_Auto_Resolve_Winner_Attrition();
+
+	int global_index = mIsSpace ? 1 : 0;
+	results[loser][global_index].Force += ((total_force[loser][global_index].Force - results[loser][global_index].Force) *
+														(1.0f - loser_attrition_value));
+
+	results[winner][global_index].Force += ((total_force[winner][global_index].Force - results[winner][global_index].Force) *
+														(1.0f - winner_attrition_value));
+
+	weakest_entry[loser] = -1;
+	if (!mSides[loser].Playable)
+	{
+		results[loser][global_index].Force = 0.0f;
+	}
+
+	outcome.Trials = Max(trials, 0);
+	outcome.Winner = winner;
+
+	std::vector<int> survivors;
+	for (int i = 0; i < ARRAY_SIZE(mSides); i++)
+	{
+		outcome.WipedOutChance[i] = 0.0f;
+		outcome.SurvivingPower[i] = 0.0f;
+		outcome.MinSurvivingPower[i] = BIG_FLOAT;
+		outcome.MaxSurvivingPower[i] = 0.0f;
+		outcome.Survivors[i].resize(0);
+		outcome.Survivors[i].resize(mSides[i].Units.size(), 0.0f);
+	}
+
+	for (int trial = 0; trial < outcome.Trials; ++trial)
+	{
+		for (int i = 0; i < ARRAY_SIZE(mSides); i++)
+		{
+			float power = Apply_Attrition(i, i == loser, results[i][global_index].Force, weakest_entry[i],
+													Stream_Seed(seed, trial * ARRAY_SIZE(mSides) + i), survivors);
+
+			int survivor_count = 0;
+			for (unsigned int e = 0; e < survivors.size(); ++e)
+			{
+				outcome.Survivors[i][e] += (float)survivors[e];
+				survivor_count += survivors[e];
+			}
+
+			if (survivor_count == 0)
+			{
+				outcome.WipedOutChance[i] += 1.0f;
+			}
+			outcome.SurvivingPower[i] += power;
+			outcome.MinSurvivingPower[i] = Min(outcome.MinSurvivingPower[i], power);
+			outcome.MaxSurvivingPower[i] = Max(outcome.MaxSurvivingPower[i], power);
+		}
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(mSides); i++)
+	{
+		if (outcome.Trials == 0)
+		{
+			outcome.MinSurvivingPower[i] = 0.0f;
+			continue;
+		}
+
+		float scale = 1.0f / (float)outcome.Trials;
+		outcome.WipedOutChance[i] *= scale;
+		outcome.SurvivingPower[i] *= scale;
+		for (unsigned int e = 0; e < outcome.Survivors[i].size(); ++e)
+		{
+			outcome.Survivors[i][e] *= scale;
+		}
+	}
+}
+
+
+/*!
+**	Same sums as AutoResolveClass::Calculate_Side_Force, one unit at a time.  Planets aren't part of a
+**	snapshot; a caller wanting base defenses adds the built tactical objects as units.
+*/
+void AutoResolveSimulationClass::Calculate_Side_Force(const SideStruct &side, TargetContrastClass::ResultType &result, int &weakest_entry) const
+{
+	result.resize(0);
+	result.resize(TargetContrastClass::ContrastTypeList.size() + 2);
+
+	result[0].Ground = true;
+	result[1].Ground = false;
+
+	weakest_entry = -1;
+	float weakest_val = BIG_FLOAT;
+
+	for (int e = 0; e < (int)side.Units.size(); e++)
+	{
+		const UnitStruct &unit = side.Units[e];
+
+		for (int n = 0; n < unit.Count; n++)
+		{
+			for (int j = 0; j < (int)unit.Garrison.size(); ++j)
+			{
+				const GameObjectTypeClass *garrison_type = unit.Garrison[j].first;
+
+				int cidx = 2;
+				for (TargetContrastClass::ContrastType::const_iterator it = TargetContrastClass::ContrastTypeList.begin();
+						it != TargetContrastClass::ContrastTypeList.end();
+						it++, cidx++)
+				{
+					unsigned int category = it->first;
+					if ((unsigned int)garrison_type->Get_Category_Mask() & category)
+					{
+						float total_force = unit.Garrison[j].second * garrison_type->Get_AI_Combat_Power_Metric();
+						result[cidx].Force += total_force;
+						result[mIsSpace ? 1 : 0].Force += total_force;
+						break;
+					}
+				}
+			}
+
+			if (unit.Transport && mIsSpace) continue;
+
+			if (unit.Power < weakest_val)
+			{
+				weakest_entry = e;
+				weakest_val = unit.Power;
+			}
+
+			int cidx = 2;
+			for (TargetContrastClass::ContrastType::const_iterator it = TargetContrastClass::ContrastTypeList.begin();
+					it != TargetContrastClass::ContrastTypeList.end();
+					it++, cidx++)
+			{
+				unsigned int category = it->first;
+				result[cidx].Category = category;
+				result[cidx].Ground = !mIsSpace;
+				if (unit.CategoryMask & category)
+				{
+					result[cidx].Force += unit.Power;
+					result[mIsSpace ? 1 : 0].Force += unit.Power;
+					break;
+				}
+			}
+		}
+	}
+}
+
+
+/*!
+**	Same as AutoResolveClass::Side_Attack.  As there, each unit only gets to apply its first garrison
+**	unit, or itself if it has no garrison.
+*/
+void AutoResolveSimulationClass::Side_Attack(const SideStruct &side, const TargetContrastClass::ResultType &target_force,
+															TargetContrastClass::ResultType &result) const
+{
+	result = target_force;
+
+	std::vector<float> cat_table;
+	cat_table.resize(32, 0.0f);
+
+	for (int e = 0; e < (int)side.Units.size(); e++)
+	{
+		const UnitStruct &unit = side.Units[e];
+		if (unit.Count <= 0) continue;
+
+		for (int t = 0; t < (int)unit.AbilityFactors.size(); t++) {
+			float weight = unit.AbilityFactors[t].second - 1.0f;
+			int idx = GET_FIRST_BIT_SET((unsigned int)(unit.AbilityFactors[t].first));
+			if (idx > -1 && weight > cat_table[idx]) {
+				cat_table[idx] = weight;
+			}
+		}
+	}
+
+	result[0].Ground = true;
+	result[1].Ground = false;
+
+	for (int e = 0; e < (int)side.Units.size(); e++)
+	{
+		const UnitStruct &unit = side.Units[e];
+
+		for (int n = 0; n < unit.Count; n++)
+		{
+			int best_category = -1;
+
+			for (int j = 0; j < (int)unit.Garrison.size(); ++j)
+			{
+				const GameObjectTypeClass *garrison_type = unit.Garrison[j].first;
+
+				for (int k = 0; k < unit.Garrison[j].second; ++k)
+				{
+					float remaining_power = garrison_type->Get_AI_Combat_Power_Metric();
+					while (remaining_power > 0.0f && best_category != 0)
+					{
+						AutoResolveClass::Find_Contrast_Index(remaining_power, garrison_type, result, mTerrainType, best_category);
+						AutoResolveClass::Apply_Unit_Contrast(remaining_power, garrison_type, result, best_category, cat_table, mTerrainType);
+						best_category = 0;
+					}
+				}
+			}
+
+			if (unit.Transport && mIsSpace) continue;
+
+			float remaining_power = unit.Power;
+			while (remaining_power > 0.0f && best_category != 0)
+			{
+				AutoResolveClass::Find_Contrast_Index(remaining_power, unit.Type, result, mTerrainType, best_category);
+				AutoResolveClass::Apply_Unit_Contrast(remaining_power, unit.Type, result, best_category, cat_table, mTerrainType);
+				best_category = 0;
+			}
+		}
+	}
+}
+
+
+/*!
+**	Same as AutoResolveClass::Determine_Winner_Index.  A side facing a super weapon it can't kill
+**	retreats, which hands the win to the other side.
+*/
+int AutoResolveSimulationClass::Determine_Winner_Index(const TargetContrastClass::ResultType &results_a,
+																		 const TargetContrastClass::ResultType &results_b) const
+{
+	if (Has_Super_Weapon(mSides[0]) && !Has_Super_Weapon_Killer(mSides[1]))
+	{
+		return 0;
+	}
+	else if (Has_Super_Weapon(mSides[1]) && !Has_Super_Weapon_Killer(mSides[0]))
+	{
+		return 1;
+	}
+
+	float total_a = 0.0f;
+	bool any_positive_a = false;
+	for (unsigned int i = 0; i < results_a.size(); ++i)
+	{
+		if (results_a[i].Force > 0.0f)
+		{
+			any_positive_a = true;
+			total_a += results_a[i].Force;
+		}
+	}
+
+	float total_b = 0.0f;
+	bool any_positive_b = false;
+	for (unsigned int i = 0; i < results_b.size(); ++i)
+	{
+		if (results_b[i].Force > 0.0f)
+		{
+			any_positive_b = true;
+			total_b += results_b[i].Force;
+		}
+	}
+
+	if (any_positive_a && any_positive_b)
+	{
+		//If there's a human involved then go by force remaining.  Otherwise we award the win
+		//to the AI that's controlling the playable faction
+		if (mSides[0].Human || mSides[1].Human)
+		{
+			return (total_a > total_b ? 0 : 1);
+		}
+		else if (!mSides[0].Playable)
+		{
+			return 1;
+		}
+		else if (!mSides[1].Playable)
+		{
+			return 0;
+		}
+		else
+		{
+			return (total_a > total_b ? 0 : 1);
+		}
+	}
+	else if ((any_positive_a || any_positive_b) && total_a != total_b)
+	{
+		return (total_a > total_b ? 0 : 1);
+	}
+	else
+	{
+		return (mAggressor == 0 ? 0 : 1);
+	}
+}
+
+
+/*!
+**	One trial of AutoResolveClass::Apply_Transport_Losses and Apply_Attrition for a side.  Heroes and
+**	structures take their attrition first, in order, and the rest in random order.
+**
+**	@return the surviving combat power; survivors gets the number left of each unit entry
+*/
+float AutoResolveSimulationClass::Apply_Attrition(int index, bool is_loser, float force, int weakest_entry, unsigned int seed,
+																  std::vector<int> &survivors) const
+{
+	const SideStruct &side = mSides[index];
+	bool enemy_has_killer = Has_Super_Weapon_Killer(mSides[index ? 0 : 1]);
+
+	survivors.resize(0);
+	survivors.resize(side.Units.size(), 0);
+
+	// Transports sit out space battles.  The loser only gets some of them away, heroes first.
+	if (mIsSpace)
+	{
+		int tcnt = 0;
+		for (int e = 0; e < (int)side.Units.size(); e++)
+		{
+			if (side.Units[e].Transport) tcnt += side.Units[e].Count;
+		}
+
+		int rcnt = tcnt;
+		if (is_loser)
+		{
+			float transport_losses = TheGameConstants.Get_Auto_Resolve_Transport_Losses();
+			rcnt = tcnt == 1 ? 0 : (int)(((float)tcnt) * (1.0f - transport_losses) + 0.5f);
+			if (!side.Playable)
+			{
+				rcnt = 0;
+			}
+		}
+
+		int kept = 0;
+		for (int e = 0; e < (int)side.Units.size() && kept < rcnt; e++)
+		{
+			if (side.Units[e].Transport && side.Units[e].Hero)
+			{
+				survivors[e] = Min(side.Units[e].Count, rcnt - kept);
+				kept += survivors[e];
+			}
+		}
+
+		for (int e = 0; e < (int)side.Units.size() && kept < rcnt; e++)
+		{
+			if (side.Units[e].Transport)
+			{
+				int keep = Min(side.Units[e].Count - survivors[e], rcnt - kept);
+				survivors[e] += keep;
+				kept += keep;
+			}
+		}
+	}
+
+	std::vector<SimulationInstanceStruct> first;
+	std::vector<SimulationInstanceStruct> rest;
+	for (int e = 0; e < (int)side.Units.size(); e++)
+	{
+		const UnitStruct &unit = side.Units[e];
+		if (unit.Transport && mIsSpace) continue;
+
+		for (int n = 0; n < unit.Count; n++)
+		{
+			SimulationInstanceStruct instance(e, e == weakest_entry && n == 0);
+			if (unit.Hero || unit.Structure)
+			{
+				first.push_back(instance);
+			}
+			else
+			{
+				rest.push_back(instance);
+			}
+		}
+	}
+
+	SimulationRandomClass random(seed);
+	bool has_weakest = (weakest_entry >= 0);
+
+	unsigned int first_index = 0;
+	while (first_index < first.size() || rest.size() != 0)
+	{
+		SimulationInstanceStruct instance(-1, false);
+		if (first_index < first.size())
+		{
+			instance = first[first_index++];
+		}
+		else
+		{
+			int unit_index = random.Get(0, rest.size()-1);
+			instance = rest[unit_index];
+			rest[unit_index] = rest.back();
+			rest.pop_back();
+		}
+
+		bool release_weakest = false;
+		if (!Attrition_Kills(side, side.Units[instance.Entry], is_loser, enemy_has_killer, force, release_weakest))
+		{
+			survivors[instance.Entry]++;
+		}
+
+		if (instance.Weakest && release_weakest)
+		{
+			has_weakest = false;
+		}
+	}
+
+	bool any_survivors = false;
+	for (unsigned int e = 0; e < survivors.size(); ++e)
+	{
+		if (survivors[e] != 0)
+		{
+			any_survivors = true;
+			break;
+		}
+	}
+
+	// The winner always keeps at least its weakest unit
+	if (!any_survivors && !is_loser && has_weakest)
+	{
+		survivors[weakest_entry]++;
+	}
+
+	float power = 0.0f;
+	for (unsigned int e = 0; e < survivors.size(); ++e)
+	{
+		power += survivors[e] * side.Units[e].Power;
+	}
+	return power;
+}
+
+
+/*!
+**	Whether Apply_Attrition kills one unit.  A surviving unit's strength, and its garrison's, come out
+**	of the side's remaining force.
+*/
+bool AutoResolveSimulationClass::Attrition_Kills(const SideStruct &side, const UnitStruct &unit, bool is_loser, bool enemy_has_killer,
+																 float &force, bool &release_weakest) const
+{
+	if (is_loser && !side.Playable)
+	{
+		//Non-playable factions are wiped out when they lose.
+		return true;
+	}
+	else if (unit.SuperWeapon)
+	{
+		if (is_loser && enemy_has_killer)
+		{
+			release_weakest = true;
+			return true;
+		}
+		return false;
+	}
+	else if (is_loser && unit.Structure)
+	{
+		return true;
+	}
+
+	//Apply garrison units
+	for (int j = 0; j < (int)unit.Garrison.size(); ++j)
+	{
+		float total_force = unit.Garrison[j].second * unit.Garrison[j].first->Get_AI_Combat_Power_Metric();
+		force -= total_force;
+		force = Max(force, 0.0f);
+	}
+
+	float attrition_allowance_factor = TheGameConstants.Get_Auto_Resolve_Attrition_Allowance_Factor();
+	if (force - (unit.Power * attrition_allowance_factor) > 0.0f)
+	{
+		force -= unit.Power;
+		force = Max(force, 0.0f);
+		return false;
+	}
+
+	return true;
+}
+
+
+bool AutoResolveSimulationClass::Has_Super_Weapon(const SideStruct &side)
+{
+	for (int e = 0; e < (int)side.Units.size(); e++)
+	{
+		if (side.Units[e].SuperWeapon && side.Units[e].Count > 0) return true;
+	}
+	return false;
+}
+
+
+bool AutoResolveSimulationClass::Has_Super_Weapon_Killer(const SideStruct &side)
+{
+	for (int e = 0; e < (int)side.Units.size(); e++)
+	{
+		if (side.Units[e].SuperWeaponKiller && side.Units[e].Count > 0) return true;
+	}
+	return false;
+}
@@ -0,0 +1,111 @@
+/***********************************************************************************************
+ ***              C O N F I D E N T I A L  ---  P E T R O G L Y P H   G A M E S, inc.        ***
+ ***********************************************************************************************/
+/** @file
+ *
+ *		This file contains the headless auto-resolve simulation class declaration.
+ */
+//#pragma once
+
+#ifndef AUTO_RESOLVE_SIMULATION_H
+#define AUTO_RESOLVE_SIMULATION_H
+
+#include "AI/Planning/TargetContrast.h"
+#include "GameObjectCategoryType.h"
+#include	<vector>
+
+class GameObjectClass;
+class GameObjectTypeClass;
+
+/*!
+**	Runs the auto-resolve combat math on snapshots of two sides instead of live combatants, so a
+**	battle can be predicted without starting one.  Nothing in the game is touched: no damage is
+**	applied, no battle history is logged and SyncRandom is never drawn from.
+**
+**	The side forces and the winner don't depend on chance, so they are worked out once.  Only the
+**	attrition order is random; each trial draws it from its own generator seeded from the
+**	simulation seed and the trial number, so any trial can be reproduced on its own.
+**
+**	Scripts reach it through Simulate_Auto_Resolve.  Debug builds check it against every auto resolved
+**	battle it can model (AutoResolveClass::Check_Simulation), so the two can't drift apart unnoticed.
+*/
+class AutoResolveSimulationClass
+{
+	public:
+
+		/*!
+		**	One entry per unit type on a side.  Add_Type fills these in from the type; callers with
+		**	better knowledge of a live unit can fill them in directly.
+		*/
+		struct UnitStruct
+		{
+			UnitStruct(void) : Type(NULL), Count(0), Power(0.0f), CategoryMask(0), Hero(false), Structure(false),
+									 Transport(false), SuperWeapon(false), SuperWeaponKiller(false) {}
+
+			const GameObjectTypeClass *Type;			//!< Combat type, used for contrast and terrain factors
+			int Count;										//!< Number of units of this type
+			float Power;									//!< AI combat power of one unit
+			unsigned int CategoryMask;					//!< Category mask of one unit
+			bool Hero;										//!< Named heroes take their attrition first
+			bool Structure;								//!< So do ground structures, which always die with the loser
+			bool Transport;								//!< Transports don't fight in space
+			bool SuperWeapon;
+			bool SuperWeaponKiller;
+			std::vector<std::pair<const GameObjectTypeClass *, int> > Garrison;			//!< Spawned unit types and starting counts
+			std::vector<std::pair<GameObjectCategoryType, float> > AbilityFactors;	//!< Hero special ability strength factors
+		};
+
+		struct SideStruct
+		{
+			SideStruct(void) : Playable(true), Human(false) {}
+
+			std::vector<UnitStruct> Units;
+			bool Playable;									//!< Non-playable factions are wiped out when they lose
+			bool Human;										//!< Draws involving a human go by force remaining
+		};
+
+		/*!
+		**	Results over all the trials of a simulation.
+		*/
+		struct OutcomeStruct
+		{
+			int Trials;
+			int Winner;										//!< Side index, the same for every trial
+			float WipedOutChance[2];					//!< Fraction of trials in which nothing on the side survived
+			float SurvivingPower[2];					//!< Average surviving combat power
+			float MinSurvivingPower[2];
+			float MaxSurvivingPower[2];
+			std::vector<float> Survivors[2];			//!< Average survivors of each unit entry
+		};
+
+		AutoResolveSimulationClass(bool is_space, MapEnvironmentType terrain = MAP_TYPE_INVALID) :
+			mIsSpace(is_space), mTerrainType(terrain), mAggressor(0) {}
+
+		SideStruct &Get_Side(int side) { return mSides[side]; }
+		void Set_Aggressor(int side) { mAggressor = side; }
+		void Add_Type(int side, const GameObjectTypeClass *type, int count, int tech_level, GameObjectClass *planet = NULL);
+
+		/*!
+		**	Run the trials.  Main thread only: it builds the contrast type list if need be, and the
+		**	contrast lookups it makes fill caches shared with the rest of the AI.
+		*/
+		void Simulate(int trials, unsigned int seed, OutcomeStruct &outcome) const;
+
+	private:
+
+		void Calculate_Side_Force(const SideStruct &side, TargetContrastClass::ResultType &result, int &weakest_entry) const;
+		void Side_Attack(const SideStruct &side, const TargetContrastClass::ResultType &target_force, TargetContrastClass::ResultType &result) const;
+		int Determine_Winner_Index(const TargetContrastClass::ResultType &results_a, const TargetContrastClass::ResultType &results_b) const;
+		float Apply_Attrition(int index, bool is_loser, float force, int weakest_entry, unsigned int seed, std::vector<int> &survivors) const;
+		bool Attrition_Kills(const SideStruct &side, const UnitStruct &unit, bool is_loser, bool enemy_has_killer, float &force,
+									bool &release_weakest) const;
+		static bool Has_Super_Weapon(const SideStruct &side);
+		static bool Has_Super_Weapon_Killer(const SideStruct &side);
+
+		bool mIsSpace;
+		MapEnvironmentType mTerrainType;
+		int mAggressor;								//!< Side index of the aggressor, who wins ties
+		SideStruct mSides[2];
+};
+
+#endif AUTO_RESOLVE_SIMULATION_H
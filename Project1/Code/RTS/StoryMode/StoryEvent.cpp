@@ -92,11 +92,57 @@
 #include "BlackMarketItemList.h"
 #include "BlackMarketItem.h"
 #include "Abilities/GalacticSabotageAbility.h"
+#include <algorithm>
 
 #define MAX_SPEECH_TIME 60
 
 
+const GameObjectTypeClass *StoryTypeListClass::Get_Type(const std::vector<std::string> &names, unsigned int index)
+{
+	return (Get_Types(names)[index]);
+}
+
+
+
+
+
+// Names that don't match a type come back as NULL, so the list always lines up with the names
+const std::vector<const GameObjectTypeClass *> &StoryTypeListClass::Get_Types(const std::vector<std::string> &names)
+{
+	if (!Resolved || (Types.size() != names.size()))
+	{
+		Resolve(names);
+	}
+	return (Types);
+}
+
+
+
+
+
+void StoryTypeListClass::Resolve(const std::vector<std::string> &names)
+{
+	Types.resize(names.size());
+	for (unsigned int i=0; i<names.size(); i++)
+	{
+		// Only an exact name match counts, the same as the string compare this replaces
+		const GameObjectTypeClass *type = GameObjectTypeManager.Find_Object_Type(names[i].c_str());
+		if ((type != NULL) && (*type->Get_Name() != names[i]))
+		{
+			type = NULL;
+		}
+		Types[i] = type;
+	}
+	Resolved = true;
+}
+
+
+
+
+
 std::map<CRCValue,int> StoryEventClass::EnumLookup;
+unsigned int StoryEventClass::DispatchKeySerial = 0;
+unsigned int StoryEventClass::EventStateSerial = 0;
 
 enum ShowSlotType
 {
@@ -1243,6 +1289,7 @@ void StoryEventClass::Event_Triggered(GameObjectClass *planet, bool inactive)
 			Active = true;
 			StartTime = GameModeManager.Get_Frame_Timer() * FrameSynchronizer.Get_Inv_Logical_FPS();
 		}
+		Event_State_Changed();
 	}
 }
 
@@ -1287,6 +1334,7 @@ void StoryEventClass::Parent_Triggered()
 		if (allactive == true)
 		{
 			Active = true;
+			Event_State_Changed();
 
 			// Save off the start time and add it to the timeout list if a timeout is specified
 			StartTime = GameModeManager.Get_Frame_Timer() * FrameSynchronizer.Get_Inv_Logical_FPS();
@@ -7400,6 +7448,7 @@ void StoryEventStartTacticalClass::Shutdown()
 **************************************************************************************************/
 void StoryEventStartTacticalClass::Set_Param(int index, std::vector<std::string> *param)
 {
+	PlanetTypes.Invalidate();
 	assert(param);
 
 	if (index == 0)
@@ -7471,7 +7520,7 @@ void StoryEventStartTacticalClass::Evaluate_Event(void *param1, void *param2)
 	{
 		for (unsigned int i=0; i<Planet.size(); i++)
 		{
-			if (Planet[i] == *planet->Get_Type()->Get_Name())
+			if (PlanetTypes.Get_Type(Planet,i) == planet->Get_Type())
 			{
 	  			Event_Triggered(planet);
 				#ifdef STORY_LOGGING
@@ -7492,6 +7541,7 @@ void StoryEventStartTacticalClass::Evaluate_Event(void *param1, void *param2)
 
 void StoryEventStartTacticalClass::Replace_Variable(const std::string &var_name, const std::string &new_name)
 {
+	PlanetTypes.Invalidate();
 	for (unsigned int i=0; i<Planet.size(); i++)
 	{
 		if (Planet[i] == var_name)
@@ -7511,6 +7561,7 @@ void StoryEventStartTacticalClass::Replace_Variable(const std::string &var_name,
 
 void StoryEventStartTacticalClass::Planet_Destroyed(const std::string &planet_name)
 {
+	PlanetTypes.Invalidate();
 	std::vector<std::string>::iterator nameptr;
 
 	for (nameptr = Planet.begin(); nameptr != Planet.end(); nameptr++)
@@ -7681,6 +7732,9 @@ void StoryEventEnterClass::Shutdown()
 **************************************************************************************************/
 void StoryEventEnterClass::Set_Param(int index, std::vector<std::string> *param)
 {
+	PlanetTypes.Invalidate();
+	OrbitingShipTypes.Invalidate();
+	Dispatch_Keys_Changed();
 	assert(param);
 
 	if (index == 0)
@@ -7811,7 +7865,7 @@ void StoryEventEnterClass::Evaluate_Event(void *param1, void *param2)
 
 	for (unsigned int i=0; i<Planet.size(); i++)
 	{
-		if (Planet[i] == *planet->Get_Type()->Get_Name())
+		if (PlanetTypes.Get_Type(Planet,i) == planet->Get_Type())
 		{
 			if ((fleet == NULL) || Event_Filter_Matches(fleet,Filter))
 			{
@@ -7831,6 +7885,9 @@ void StoryEventEnterClass::Evaluate_Event(void *param1, void *param2)
 
 void StoryEventEnterClass::Replace_Variable(const std::string &var_name, const std::string &new_name)
 {
+	PlanetTypes.Invalidate();
+	OrbitingShipTypes.Invalidate();
+	Dispatch_Keys_Changed();
 	for (unsigned int i=0; i<Planet.size(); i++)
 	{
 		if (Planet[i] == var_name)
@@ -7850,6 +7907,9 @@ void StoryEventEnterClass::Replace_Variable(const std::string &var_name, const s
 
 void StoryEventEnterClass::Planet_Destroyed(const std::string &planet_name)
 {
+	PlanetTypes.Invalidate();
+	OrbitingShipTypes.Invalidate();
+	Dispatch_Keys_Changed();
 	std::vector<std::string>::iterator nameptr;
 
 	for (nameptr = Planet.begin(); nameptr != Planet.end(); nameptr++)
@@ -7873,6 +7933,26 @@ void StoryEventEnterClass::Planet_Destroyed(const std::string &planet_name)
 
 
 
+bool StoryEventEnterClass::Get_Dispatch_Keys(std::vector<CRCValue> &keys)
+{
+	// No planet in the script means any planet will do
+	if (Planet.empty())
+	{
+		return (false);
+	}
+
+	for (unsigned int i=0; i<Planet.size(); i++)
+	{
+		keys.push_back(Get_Dispatch_Key(Planet[i]));
+	}
+
+	return (true);
+}
+
+
+
+
+
 bool StoryEventEnterClass::Check_Special_Land_Tactical_Map(GameObjectClass *, GameObjectClass *planet)
 {
 	// Only true if the reward is a linked tactical map
@@ -7884,7 +7964,7 @@ bool StoryEventEnterClass::Check_Special_Land_Tactical_Map(GameObjectClass *, Ga
 	// Check to see if this is the right planet to trigger the event
 	for (unsigned int i=0; i<Planet.size(); i++)
 	{
-		if (Planet[i] == *planet->Get_Type()->Get_Name())
+		if (PlanetTypes.Get_Type(Planet,i) == planet->Get_Type())
 		{
 			return (true);
 		}
@@ -7902,7 +7982,7 @@ bool StoryEventEnterClass::Check_Planet_Entry_Restrictions(GameObjectClass *flee
 
 	for (unsigned int i=0; i<Planet.size(); i++)
 	{
-		if (Planet[i] == *planet->Get_Type()->Get_Name())
+		if (PlanetTypes.Get_Type(Planet,i) == planet->Get_Type())
 		{
 			if ((fleet == NULL) || Event_Filter_Matches(fleet,Filter))
 			{
@@ -7953,7 +8033,7 @@ bool StoryEventEnterClass::Check_Special_Space_Tactical_Map(GameObjectClass *her
 
 	for (unsigned int i=0; i<Planet.size(); i++)
 	{
-		if (Planet[i] == *planet->Get_Type()->Get_Name())
+		if (PlanetTypes.Get_Type(Planet,i) == planet->Get_Type())
 		{
 			return true;
 		}
@@ -8060,7 +8140,7 @@ bool StoryEventEnterClass::Check_Orbit_Contents(GameObjectClass *planet)
 			GameObjectClass *ship = fleet_objects[i];
 			for (unsigned int j=0; j<OrbitingShip.size(); j++)
 			{
-				if (OrbitingShip[j] == *ship->Get_Original_Object_Type()->Get_Name())
+				if (OrbitingShipTypes.Get_Type(OrbitingShip,j) == ship->Get_Original_Object_Type())
 				{
 					return (true);
 				}
@@ -8104,6 +8184,9 @@ bool StoryEventEnterClass::Save(ChunkWriterClass *writer)
 
 bool StoryEventEnterClass::Load(ChunkReaderClass *reader)
 {
+	PlanetTypes.Invalidate();
+	OrbitingShipTypes.Invalidate();
+	Dispatch_Keys_Changed();
 	assert( reader != NULL );
 
 	bool ok = true;
@@ -8183,6 +8266,7 @@ void StoryEventSingleObjectNameClass::Shutdown()
 **************************************************************************************************/
 void StoryEventSingleObjectNameClass::Set_Param(int index, std::vector<std::string> *param)
 {
+	Dispatch_Keys_Changed();
 	assert(param);
 
 	if (index == 0)
@@ -8311,6 +8395,7 @@ void StoryEventSingleObjectNameClass::Reset()
 
 void StoryEventSingleObjectNameClass::Replace_Variable(const std::string &var_name, const std::string &new_name)
 {
+	Dispatch_Keys_Changed();
 	for (unsigned int i=0; i<ObjectName.size(); i++)
 	{
 		if (ObjectName[i] == var_name)
@@ -8329,6 +8414,22 @@ void StoryEventSingleObjectNameClass::Replace_Variable(const std::string &var_na
 
 
 
+bool StoryEventSingleObjectNameClass::Get_Dispatch_Keys(std::vector<CRCValue> &keys)
+{
+	for (unsigned int i=0; i<ObjectName.size(); i++)
+	{
+		keys.push_back(Get_Dispatch_Key(ObjectName[i]));
+	}
+
+	return (true);
+}
+
+
+
+
+
+
+
 /**************************************************************************************************
 * StoryEventSingleObjectNameClass::Load -- Custom load for event
 *
@@ -8341,6 +8442,7 @@ void StoryEventSingleObjectNameClass::Replace_Variable(const std::string &var_na
 **************************************************************************************************/
 bool StoryEventSingleObjectNameClass::Load(ChunkReaderClass *reader)
 {
+	Dispatch_Keys_Changed();
 	assert( reader != NULL );
 
 	bool ok = true;
@@ -8484,6 +8586,7 @@ void StoryEventConstructLevelClass::Shutdown()
 **************************************************************************************************/
 void StoryEventConstructLevelClass::Set_Param(int index, std::vector<std::string> *param)
 {
+	PlanetTypes.Invalidate();
 	assert(param);
 
 	if (index == 0)
@@ -8546,12 +8649,11 @@ void StoryEventConstructLevelClass::Evaluate_Event(void *param1, void *param2)
 	}
 
 	GameObjectClass *planet = (GameObjectClass *)param1;
-	const std::string *planetname = planet->Get_Type()->Get_Name();
 	const GameObjectTypeClass *type = (const GameObjectTypeClass *)param2;
 
 	for (unsigned int i=0; i<Planet.size(); i++)
 	{
-		if (Planet[i] == *planetname)
+		if (PlanetTypes.Get_Type(Planet,i) == planet->Get_Type())
 		{
 			switch (Filter)
 			{
@@ -8587,6 +8689,7 @@ void StoryEventConstructLevelClass::Evaluate_Event(void *param1, void *param2)
 
 void StoryEventConstructLevelClass::Replace_Variable(const std::string &var_name, const std::string &new_name)
 {
+	PlanetTypes.Invalidate();
 	for (unsigned int i=0; i<Planet.size(); i++)
 	{
 		if (Planet[i] == var_name)
@@ -8606,6 +8709,7 @@ void StoryEventConstructLevelClass::Replace_Variable(const std::string &var_name
 
 void StoryEventConstructLevelClass::Planet_Destroyed(const std::string &planet_name)
 {
+	PlanetTypes.Invalidate();
 	std::vector<std::string>::iterator nameptr;
 
 	for (nameptr = Planet.begin(); nameptr != Planet.end(); nameptr++)
@@ -8641,6 +8745,7 @@ void StoryEventConstructLevelClass::Planet_Destroyed(const std::string &planet_n
 **************************************************************************************************/
 bool StoryEventConstructLevelClass::Load(ChunkReaderClass *reader)
 {
+	PlanetTypes.Invalidate();
 	assert( reader != NULL );
 
 	bool ok = true;
@@ -8758,6 +8863,7 @@ void StoryEventCorruptionLevelClass::Shutdown()
 **************************************************************************************************/
 void StoryEventCorruptionLevelClass::Set_Param(int index, std::vector<std::string> *param)
 {
+	PlanetTypes.Invalidate();
 	assert(param);
 
 	if (index == 0)
@@ -8812,14 +8918,13 @@ void StoryEventCorruptionLevelClass::Evaluate_Event(void *param1, void *param2)
 
 	GameObjectClass *planet = (GameObjectClass *)param1;
 	assert(planet);
-	const std::string *planetname = planet->Get_Type()->Get_Name();
 	CorruptionTypeEnum corruption_type = *(CorruptionTypeEnum *)param2;
 
 	if ((corruption_type == CorruptionType) || ((CorruptionType == CORRUPTION_ANY) && (corruption_type != CORRUPTION_NONE)))
 	{
 		for (unsigned int i=0; i<Planet.size(); i++)
 		{
-			if (Planet[i] == *planetname)
+			if (PlanetTypes.Get_Type(Planet,i) == planet->Get_Type())
 			{
 				Event_Triggered(planet);
 				return;
@@ -8836,6 +8941,7 @@ void StoryEventCorruptionLevelClass::Evaluate_Event(void *param1, void *param2)
 
 void StoryEventCorruptionLevelClass::Replace_Variable(const std::string &var_name, const std::string &new_name)
 {
+	PlanetTypes.Invalidate();
 	for (unsigned int i=0; i<Planet.size(); i++)
 	{
 		if (Planet[i] == var_name)
@@ -8901,6 +9007,7 @@ void StoryEventHeroMoveClass::Shutdown()
 **************************************************************************************************/
 void StoryEventHeroMoveClass::Set_Param(int index, std::vector<std::string> *param)
 {
+	PlanetTypes.Invalidate();
 	assert(param);
 
 	if (index == 0)
@@ -8980,7 +9087,6 @@ void StoryEventHeroMoveClass::Evaluate_Event(void *param1, void *param2)
 
 	std::string *heroname = (std::string *)param1;
 	GameObjectClass *planet = (GameObjectClass *)param2;
-	const std::string *planetname = planet->Get_Type()->Get_Name();
 
 	bool herofound = false;
 
@@ -8997,7 +9103,7 @@ void StoryEventHeroMoveClass::Evaluate_Event(void *param1, void *param2)
 	{
 		for (unsigned int i=0; i<Planet.size(); i++)
 		{
-			if (Planet[i] == *planetname)
+			if (PlanetTypes.Get_Type(Planet,i) == planet->Get_Type())
 			{
 				Event_Triggered(planet);
 				return;
@@ -9045,7 +9151,7 @@ bool StoryEventHeroMoveClass::Check_Special_Land_Tactical_Map(GameObjectClass *h
 		// Check to see if this is the right planet to trigger the event
 		for (unsigned int i=0; i<Planet.size(); i++)
 		{
-			if (Planet[i] == *planet->Get_Type()->Get_Name())
+			if (PlanetTypes.Get_Type(Planet,i) == planet->Get_Type())
 			{
 				return (true);
 			}
@@ -9077,7 +9183,7 @@ bool StoryEventHeroMoveClass::Check_Planet_Entry_Restrictions(GameObjectClass *f
 	{
 		for (unsigned int i=0; i<Planet.size(); i++)
 		{
-			if (Planet[i] == *planet->Get_Type()->Get_Name())
+			if (PlanetTypes.Get_Type(Planet,i) == planet->Get_Type())
 			{
 				return true;
 			}
@@ -9123,7 +9229,7 @@ bool StoryEventHeroMoveClass::Check_Special_Space_Tactical_Map(GameObjectClass *
 
 	for (unsigned int i=0; i<Planet.size(); i++)
 	{
-		if (Planet[i] == *planet->Get_Type()->Get_Name())
+		if (PlanetTypes.Get_Type(Planet,i) == planet->Get_Type())
 		{
 			return true;
 		}
@@ -9140,6 +9246,7 @@ bool StoryEventHeroMoveClass::Check_Special_Space_Tactical_Map(GameObjectClass *
 
 void StoryEventHeroMoveClass::Replace_Variable(const std::string &var_name, const std::string &new_name)
 {
+	PlanetTypes.Invalidate();
 	for (unsigned int i=0; i<Planet.size(); i++)
 	{
 		if (Planet[i] == var_name)
@@ -9169,6 +9276,7 @@ void StoryEventHeroMoveClass::Replace_Variable(const std::string &var_name, cons
 
 void StoryEventHeroMoveClass::Planet_Destroyed(const std::string &planet_name)
 {
+	PlanetTypes.Invalidate();
 	std::vector<std::string>::iterator nameptr;
 
 	for (nameptr = Planet.begin(); nameptr != Planet.end(); nameptr++)
@@ -9190,6 +9298,7 @@ void StoryEventHeroMoveClass::Planet_Destroyed(const std::string &planet_name)
 
 bool StoryEventHeroMoveClass::Load(ChunkReaderClass *reader)
 {
+	PlanetTypes.Invalidate();
 	assert( reader != NULL );
 
 	bool ok = true;
@@ -9906,6 +10015,9 @@ void StoryEventDestroyClass::Shutdown()
 **************************************************************************************************/
 void StoryEventDestroyClass::Set_Param(int index, std::vector<std::string> *param)
 {
+	ObjectTypes.Invalidate();
+	PlanetTypes.Invalidate();
+	Dispatch_Keys_Changed();
 	assert(param);
 
 	if (index == 0)
@@ -10004,18 +10116,12 @@ void StoryEventDestroyClass::Evaluate_Event(void *param1, void *param2)
 	}
 
 	const GameObjectTypeClass *object_type = (const GameObjectTypeClass *)param1;
-	const std::string *objname = object_type->Get_Name();
 	GameObjectClass *planet = (GameObjectClass *)param2;
-	const std::string *planetname = NULL;
-	if (planet)
-	{
-		planetname = planet->Get_Type()->Get_Name();
-	}
 	bool objfound = false;
 
 	for (unsigned int i=0; i<Object.size(); i++)
 	{
-		if (Object[i] == *objname)
+		if (ObjectTypes.Get_Type(Object,i) == object_type)
 		{
 			objfound = true;
 			break;
@@ -10039,7 +10145,7 @@ void StoryEventDestroyClass::Evaluate_Event(void *param1, void *param2)
 		{
 			for (unsigned int i=0; i<Planet.size(); i++)
 			{
-				if (planetname && (Planet[i] == *planetname))
+				if (planet && (PlanetTypes.Get_Type(Planet,i) == planet->Get_Type()))
 				{
 					if (Event_Filter_Matches(planet,Filter))
 					{
@@ -10081,6 +10187,9 @@ void StoryEventDestroyClass::Reset()
 
 void StoryEventDestroyClass::Replace_Variable(const std::string &var_name, const std::string &new_name)
 {
+	ObjectTypes.Invalidate();
+	PlanetTypes.Invalidate();
+	Dispatch_Keys_Changed();
 	for (unsigned int i=0; i<Planet.size(); i++)
 	{
 		if (Planet[i] == var_name)
@@ -10106,6 +10215,20 @@ void StoryEventDestroyClass::Replace_Variable(const std::string &var_name, const
 
 
 
+bool StoryEventDestroyClass::Get_Dispatch_Keys(std::vector<CRCValue> &keys)
+{
+	for (unsigned int i=0; i<Object.size(); i++)
+	{
+		keys.push_back(Get_Dispatch_Key(Object[i]));
+	}
+
+	return (true);
+}
+
+
+
+
+
 /**************************************************************************************************
 * StoryEventDestroyClass::Load -- Custom load for event
 *
@@ -10118,6 +10241,9 @@ void StoryEventDestroyClass::Replace_Variable(const std::string &var_name, const
 **************************************************************************************************/
 bool StoryEventDestroyClass::Load(ChunkReaderClass *reader)
 {
+	ObjectTypes.Invalidate();
+	PlanetTypes.Invalidate();
+	Dispatch_Keys_Changed();
 	assert( reader != NULL );
 
 	bool ok = true;
@@ -10226,6 +10352,7 @@ void StoryEventDestroyBaseClass::Shutdown()
 
 void StoryEventDestroyBaseClass::Set_Param(int index, std::vector<std::string> *param)
 {
+	PlanetTypes.Invalidate();
 	assert(param);
 
 	if (index == 0)
@@ -10278,7 +10405,6 @@ void StoryEventDestroyBaseClass::Evaluate_Event(void *param1, void *param2)
 	}
 
 	GameObjectClass *planet = (GameObjectClass *)param1;
-	const std::string *planetname = planet->Get_Type()->Get_Name();
 	StoryBaseFilter type = *(StoryBaseFilter *)param2;
 
 	if (Planet.empty())
@@ -10296,7 +10422,7 @@ void StoryEventDestroyBaseClass::Evaluate_Event(void *param1, void *param2)
 	{
 		for (unsigned int i=0; i<Planet.size(); i++)
 		{
-			if (Planet[i] == *planetname)
+			if (PlanetTypes.Get_Type(Planet,i) == planet->Get_Type())
 			{
 				if (Event_Filter_Matches(planet,OwnerFilter))
 				{
@@ -10319,6 +10445,7 @@ void StoryEventDestroyBaseClass::Evaluate_Event(void *param1, void *param2)
 
 void StoryEventDestroyBaseClass::Replace_Variable(const std::string &var_name, const std::string &new_name)
 {
+	PlanetTypes.Invalidate();
 	for (unsigned int i=0; i<Planet.size(); i++)
 	{
 		if (Planet[i] == var_name)
@@ -10336,6 +10463,7 @@ void StoryEventDestroyBaseClass::Replace_Variable(const std::string &var_name, c
 
 void StoryEventDestroyBaseClass::Planet_Destroyed(const std::string &planet_name)
 {
+	PlanetTypes.Invalidate();
 	std::vector<std::string>::iterator nameptr;
 
 	for (nameptr = Planet.begin(); nameptr != Planet.end(); nameptr++)
@@ -10376,6 +10504,7 @@ void StoryEventDestroyBaseClass::Planet_Destroyed(const std::string &planet_name
 **************************************************************************************************/
 void StoryEventWinBattlesClass::Set_Param(int index, std::vector<std::string> *param)
 {
+	PlanetTypes.Invalidate();
 	assert(param);
 
 	if (index == 0)
@@ -10461,10 +10590,9 @@ void StoryEventWinBattlesClass::Evaluate_Event(void *param1, void *param2)
 				}
 				else
 				{
-					const std::string *planetname = planet->Get_Type()->Get_Name();
 					for (unsigned int i=0; i<Planet.size(); i++)
 					{
-						if (Planet[i] == *planetname)
+						if (PlanetTypes.Get_Type(Planet,i) == planet->Get_Type())
 						{
 							Event_Triggered(planet);
 							break;
@@ -10609,6 +10737,7 @@ bool StoryEventWinBattlesClass::Content_Matches(GameObjectClass *planet)
 **************************************************************************************************/
 bool StoryEventWinBattlesClass::Load(ChunkReaderClass *reader)
 {
+	PlanetTypes.Invalidate();
 	assert( reader != NULL );
 
 	bool ok = true;
@@ -11206,54 +11335,297 @@ void StoryEventGuardUnitClass::Replace_Variable(const std::string &var_name, con
 
 
 
-void StoryEventProximityClass::Evaluate_Event(void *param1, void *)
+#define PROXIMITY_GRID_CELL_SIZE		500.0f
+
+bool StoryProximityGridClass::Update(int player_id)
 {
-	if (param1 == NULL)
+	bool changed = !Valid || (EventStateSerial != StoryEventClass::Get_Event_State_Serial());
+	EventStateSerial = StoryEventClass::Get_Event_State_Serial();
+	Valid = true;
+
+	if (Update_Units(player_id))
 	{
-		return;
+		Build();
+		changed = true;
 	}
 
-	GameObjectClass *object = (GameObjectClass *)param1;
-	if (object == NULL)
+	if (Update_Targets())
 	{
-		return;
+		changed = true;
 	}
 
-	Vector3 pos = object->Get_Position();
+	return (changed);
+}
+
+
+
+
 
-	if (UnitName.empty())
+bool StoryProximityGridClass::Update_Units(int player_id)
+{
+	bool changed = false;
+	unsigned int count = 0;
+
+	ReferenceListClass<GameObjectClass> *selection_list = GAME_OBJECT_MANAGER.Get_Selectable_Objects();
+	ReferenceListIterator<GameObjectClass> it(selection_list);
+	for (; !it.Is_Done(); it.Next())
 	{
-		Check_For_Proximity(pos);
+		GameObjectClass *object = it.Current_Object();
+		if ((object->Get_Owner() == player_id) && (!object->Behaves_Like(BEHAVIOR_PROJECTILE)))
+		{
+			if (count == SeenUnits.size())
+			{
+				SeenUnits.resize(count + 1);
+				changed = true;
+			}
+
+			SeenUnitStruct &seen = SeenUnits[count++];
+			if (changed || (seen.Type != object->Get_Type()) || !Same_Position(seen.Position, object->Get_Position()))
+			{
+				seen.Type = object->Get_Type();
+				seen.Position = object->Get_Position();
+				changed = true;
+			}
+		}
 	}
-	else
+
+	if (count != SeenUnits.size())
 	{
-		for (unsigned int i=0; i<UnitName.size(); i++)
+		SeenUnits.resize(count);
+		changed = true;
+	}
+	return (changed);
+}
+
+
+
+
+
+bool StoryProximityGridClass::Update_Targets()
+{
+	bool changed = false;
+	unsigned int count = 0;
+
+	for (unsigned int j=0; j<TargetTypes.size(); j++)
+	{
+		const DynamicVectorClass<GameObjectClass *> *target_list = GAME_OBJECT_MANAGER.Find_All_Objects_Of_Type(TargetTypes[j]);
+		for (int k=0; k<target_list->Size(); k++)
 		{
-			if (UnitName[i] == *object->Get_Type()->Get_Name())
+			const Vector3 &pos = (*target_list)[k]->Get_Position();
+			if (count == TargetPositions.size())
+			{
+				TargetPositions.push_back(pos);
+				changed = true;
+			}
+			else if (!Same_Position(TargetPositions[count], pos))
 			{
-				Check_For_Proximity(pos);
+				TargetPositions[count] = pos;
+				changed = true;
 			}
+			count++;
 		}
 	}
+
+	if (count != TargetPositions.size())
+	{
+		TargetPositions.resize(count);
+		changed = true;
+	}
+	return (changed);
 }
 
 
 
 
 
-void StoryEventProximityClass::Check_For_Proximity(Vector3 &pos)
+void StoryProximityGridClass::Watch_Target_Types(const std::vector<const GameObjectTypeClass *> &target_types)
 {
-	for (unsigned int j=0; j<TargetName.size(); j++)
+	for (unsigned int i=0; i<target_types.size(); i++)
 	{
-		const GameObjectTypeClass *type = GameObjectTypeManager.Find_Object_Type(TargetName[j].c_str());
-		const DynamicVectorClass<GameObjectClass *> *target_list = GAME_OBJECT_MANAGER.Find_All_Objects_Of_Type(type);
+		if (target_types[i] && (std::find(WatchedTypes.begin(), WatchedTypes.end(), target_types[i]) == WatchedTypes.end()))
+		{
+			WatchedTypes.push_back(target_types[i]);
+		}
+	}
+}
+
+
+
+
+
+void StoryProximityGridClass::End_Watch()
+{
+	// Only active proximity events are sent the grid, so types of events that have triggered or
+	// been deactivated drop out here.  Added or removed types change the target positions seen by
+	// the next Update, which reports it as a change.
+	if (WatchedTypes != TargetTypes)
+	{
+		TargetTypes.swap(WatchedTypes);
+	}
+}
+
+
+
+
+
+void StoryProximityGridClass::Build()
+{
+	Units.resize(SeenUnits.size());
+	Cells.clear();
+
+	for (unsigned int i=0; i<SeenUnits.size(); i++)
+	{
+		UnitStruct &unit = Units[i];
+		unit.Position = SeenUnits[i].Position;
+		unit.Type = SeenUnits[i].Type;
+		unit.Cell = Cell_Key((int)floorf(unit.Position.X / PROXIMITY_GRID_CELL_SIZE), (int)floorf(unit.Position.Y / PROXIMITY_GRID_CELL_SIZE));
+	}
+
+	// Units in the same cell end up next to each other, each cell just remembers its range
+	std::sort(Units.begin(), Units.end(), UnitCellLessStruct());
+	for (unsigned int i=0; i<Units.size(); i++)
+	{
+		CellListType::iterator cell = Cells.find(Units[i].Cell);
+		if (cell == Cells.end())
+		{
+			Cells[Units[i].Cell] = std::make_pair((int)i, (int)i + 1);
+		}
+		else
+		{
+			cell->second.second = (int)i + 1;
+		}
+	}
+}
+
+
+
+
+
+bool StoryProximityGridClass::Type_Matches(const GameObjectTypeClass *type, const std::vector<const GameObjectTypeClass *> &unit_types)
+{
+	if (unit_types.empty())
+	{
+		return (true);
+	}
+
+	for (unsigned int i=0; i<unit_types.size(); i++)
+	{
+		if (unit_types[i] == type)
+		{
+			return (true);
+		}
+	}
+	return (false);
+}
+
+
+
+
+
+bool StoryProximityGridClass::Is_Unit_Within(const Vector3 &pos, float max_dist, const std::vector<const GameObjectTypeClass *> &unit_types) const
+{
+	if (max_dist <= 0.0f)
+	{
+		return (false);
+	}
+
+	float max_dist2 = max_dist * max_dist;
+	int min_x = (int)floorf((pos.X - max_dist) / PROXIMITY_GRID_CELL_SIZE);
+	int max_x = (int)floorf((pos.X + max_dist) / PROXIMITY_GRID_CELL_SIZE);
+	int min_y = (int)floorf((pos.Y - max_dist) / PROXIMITY_GRID_CELL_SIZE);
+	int max_y = (int)floorf((pos.Y + max_dist) / PROXIMITY_GRID_CELL_SIZE);
+
+	// A huge radius covers more cells than there are units, so just check them all
+	if ((float)(max_x - min_x + 1) * (float)(max_y - min_y + 1) > (float)Units.size())
+	{
+		for (unsigned int i=0; i<Units.size(); i++)
+		{
+			if (((Units[i].Position - pos).Length2() < max_dist2) && Type_Matches(Units[i].Type, unit_types))
+			{
+				return (true);
+			}
+		}
+		return (false);
+	}
+
+	for (int y=min_y; y<=max_y; y++)
+	{
+		for (int x=min_x; x<=max_x; x++)
+		{
+			CellListType::const_iterator cell = Cells.find(Cell_Key(x, y));
+			if (cell == Cells.end())
+			{
+				continue;
+			}
+
+			for (int i=cell->second.first; i<cell->second.second; i++)
+			{
+				if (((Units[i].Position - pos).Length2() < max_dist2) && Type_Matches(Units[i].Type, unit_types))
+				{
+					return (true);
+				}
+			}
+		}
+	}
+	return (false);
+}
+
+
+
+
+
+void StoryEventProximityClass::Set_Param(int index, std::vector<std::string> *param)
+{
+	StoryEventCommandUnitClass::Set_Param(index,param);
+	UnitTypes.Invalidate();
+	TargetTypes.Invalidate();
+	Event_State_Changed();
+}
+
+
+
+
+
+void StoryEventProximityClass::Replace_Variable(const std::string &var_name, const std::string &new_name)
+{
+	StoryEventCommandUnitClass::Replace_Variable(var_name,new_name);
+	UnitTypes.Invalidate();
+	TargetTypes.Invalidate();
+	Event_State_Changed();
+}
+
+
+
+
+
+void StoryEventProximityClass::Evaluate_Event(void *param1, void *)
+{
+	if (param1 == NULL)
+	{
+		return;
+	}
+
+	StoryProximityGridClass *grid = (StoryProximityGridClass *)param1;
+	const std::vector<const GameObjectTypeClass *> &target_types = TargetTypes.Get_Types(TargetName);
+	grid->Watch_Target_Types(target_types);
+	if (grid->Is_Empty())
+	{
+		return;
+	}
+
+	const std::vector<const GameObjectTypeClass *> &unit_types = UnitTypes.Get_Types(UnitName);
+	for (unsigned int j=0; j<target_types.size(); j++)
+	{
+		if (target_types[j] == NULL)
+		{
+			continue;
+		}
+
+		const DynamicVectorClass<GameObjectClass *> *target_list = GAME_OBJECT_MANAGER.Find_All_Objects_Of_Type(target_types[j]);
 		for (int k=0; k<target_list->Size(); k++)
 		{
 			GameObjectClass *target = (*target_list)[k];
-			Vector3 targetpos = target->Get_Position();
-			Vector3 v = targetpos - pos;
-			float dist = v.Length();
-			if (dist < MaxDist)
+			if (grid->Is_Unit_Within(target->Get_Position(), MaxDist, unit_types))
 			{
 				Event_Triggered();
 				return;
@@ -11309,9 +11681,12 @@ void StoryEventFlagClass::Set_Param(int index, std::vector<std::string> *param)
 	assert(param);
 	char name[ 256 ];
 
+	Checked = false;
+
 	if (index == 0)
 	{
 		FlagNames.resize(0);
+		FlagCRCs.resize(0);
 		for (unsigned int i=0; i<param->size(); i++)
 		{
 			if ((*param)[i].size())
@@ -11320,6 +11695,7 @@ void StoryEventFlagClass::Set_Param(int index, std::vector<std::string> *param)
 				_strupr( name );
 				std::string flag_name(name);
 				FlagNames.push_back(flag_name);
+				FlagCRCs.push_back(StoryModeClass::Get_Flag_CRC(name));
 			}
 		}
 	}
@@ -11340,12 +11716,45 @@ void StoryEventFlagClass::Set_Param(int index, std::vector<std::string> *param)
 
 
 
+bool StoryEventFlagClass::Needs_Evaluation()
+{
+	// Events waiting on inaction have their timer reset every time the condition holds, so keep
+	// checking those every frame
+	if (!Checked || (InactiveDelay > 0))
+	{
+		return (true);
+	}
+
+	unsigned int serial = StoryModeClass::Get_Flag_Change_Serial();
+	if (serial == CheckedSerial)
+	{
+		return (false);
+	}
+
+	for (unsigned int i=0; i<FlagCRCs.size(); i++)
+	{
+		if (StoryModeClass::Has_Flag_Changed_Since(FlagCRCs[i], CheckedSerial))
+		{
+			return (true);
+		}
+	}
+
+	// Other flags changed but none of ours, nothing to look at again until the next change
+	CheckedSerial = serial;
+	return (false);
+}
+
+
+
+
+
 void StoryEventFlagClass::Evaluate_Event(void *, void *)
 {
-	for (unsigned int i=0; i<FlagNames.size(); i++)
+	CheckedSerial = StoryModeClass::Get_Flag_Change_Serial();
+
+	for (unsigned int i=0; i<FlagCRCs.size(); i++)
 	{
-		std::string *name = &FlagNames[i];
-		int value = StoryModeClass::Get_Flag(name->c_str());
+		int value = StoryModeClass::Get_Flag(FlagCRCs[i]);
 
 		if (value != UNDEFINED_STORY_FLAG)
 		{
@@ -11392,6 +11801,9 @@ void StoryEventFlagClass::Evaluate_Event(void *, void *)
 			}
 		}
 	}
+
+	// A triggered event may be cleared and become active again, so only remember the check if it didn't fire
+	Checked = !Triggered;
 }
 
 
@@ -11439,6 +11851,8 @@ void StoryEventLoadTacticalClass::Shutdown()
 **************************************************************************************************/
 void StoryEventLoadTacticalClass::Set_Param(int index, std::vector<std::string> *param)
 {
+	HeroTypes.Invalidate();
+	PlanetTypes.Invalidate();
 	assert(param);
 
 	if (index == 0)
@@ -11521,7 +11935,6 @@ void StoryEventLoadTacticalClass::Evaluate_Event(void *param1, void *param2)
 	}
 
 	GameObjectClass *planet = (GameObjectClass *)param1;
-	const std::string *planetname = planet->Get_Type()->Get_Name();
 	StoryBaseFilter *location = (StoryBaseFilter *)param2;
 
 	if (*location != Base)
@@ -11533,7 +11946,7 @@ void StoryEventLoadTacticalClass::Evaluate_Event(void *param1, void *param2)
 
 	for (unsigned int i=0; i<Planet.size(); i++)
 	{
-		if (Planet[i] == *planetname)
+		if (PlanetTypes.Get_Type(Planet,i) == planet->Get_Type())
 		{
 			planetfound = true;
 			break;
@@ -11591,6 +12004,8 @@ void StoryEventLoadTacticalClass::Evaluate_Event(void *param1, void *param2)
 
 void StoryEventLoadTacticalClass::Replace_Variable(const std::string &var_name, const std::string &new_name)
 {
+	HeroTypes.Invalidate();
+	PlanetTypes.Invalidate();
 	for (unsigned int i=0; i<Planet.size(); i++)
 	{
 		if (Planet[i] == var_name)
@@ -11620,6 +12035,8 @@ void StoryEventLoadTacticalClass::Replace_Variable(const std::string &var_name,
 
 void StoryEventLoadTacticalClass::Planet_Destroyed(const std::string &planet_name)
 {
+	HeroTypes.Invalidate();
+	PlanetTypes.Invalidate();
 	std::vector<std::string>::iterator nameptr;
 
 	for (nameptr = Planet.begin(); nameptr != Planet.end(); nameptr++)
@@ -11652,8 +12069,6 @@ bool StoryEventLoadTacticalClass::Check_Special_Land_Tactical_Map(GameObjectClas
 		return (false);
 	}
 
-	const std::string *planetname = planet->Get_Type()->Get_Name();
-
 	// We're only checking for special land tactical maps
 	if (Base != BASE_GROUND)
 	{
@@ -11665,7 +12080,7 @@ bool StoryEventLoadTacticalClass::Check_Special_Land_Tactical_Map(GameObjectClas
 	// See if the supplied planet is in the planet list
 	for (unsigned int i=0; i<Planet.size(); i++)
 	{
-		if (Planet[i] == *planetname)
+		if (PlanetTypes.Get_Type(Planet,i) == planet->Get_Type())
 		{
 			planetfound = true;
 			break;
@@ -11681,11 +12096,10 @@ bool StoryEventLoadTacticalClass::Check_Special_Land_Tactical_Map(GameObjectClas
 		}
 		else
 		{
-			const std::string *heroname = hero->Get_Type()->Get_Name();
 			// See if the supplied hero is in the hero list
 			for (unsigned int i=0; i<Hero.size(); i++)
 			{
-				if (Hero[i] == *heroname)
+				if (HeroTypes.Get_Type(Hero,i) == hero->Get_Type())
 				{
 					return (true);
 				}
@@ -12237,6 +12651,7 @@ void StoryEventObjectiveTimeoutClass::Activate()
 
 void StoryEventCaptureClass::Set_Param(int index, std::vector<std::string> *param)
 {
+	StructureTypes.Invalidate();
 	assert(param);
 	char name[ 256 ];
 
@@ -12290,7 +12705,7 @@ void StoryEventCaptureClass::Evaluate_Event(void *param1, void *param2)
 
 	for (unsigned int i=0; i<Structure.size(); i++)
 	{
-		if (Structure[i] == *object->Get_Type()->Get_Name())
+		if (StructureTypes.Get_Type(Structure,i) == object->Get_Type())
 		{
 			if (new_faction == NewFaction)
 			{
@@ -12310,6 +12725,7 @@ void StoryEventCaptureClass::Evaluate_Event(void *param1, void *param2)
 
 void StoryEventCaptureClass::Replace_Variable(const std::string &var_name, const std::string &new_name)
 {
+	StructureTypes.Invalidate();
 	for (unsigned int i=0; i<Structure.size(); i++)
 	{
 		if (Structure[i] == var_name)
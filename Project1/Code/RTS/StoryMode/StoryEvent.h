@@ -48,6 +48,7 @@
 
 
 class GameObjectClass;
+class GameObjectTypeClass;
 class StoryEventClass;
 class StorySubPlotClass;
 class ChunkReaderClass;
@@ -510,6 +511,31 @@ private:
 
 
 
+// Object type names from a story script, looked up once and kept in the same order as the
+// names, so events compare type pointers on each dispatch instead of strings.  Names that aren't
+// a type, like variables waiting on Replace_Variable, come back NULL and never match.  Call
+// Invalidate whenever the names are changed in place.
+class StoryTypeListClass
+{
+public:
+
+	StoryTypeListClass() : Resolved(false) {}
+
+	void Invalidate() { Resolved = false; }
+	const GameObjectTypeClass *Get_Type(const std::vector<std::string> &names, unsigned int index);
+	const std::vector<const GameObjectTypeClass *> &Get_Types(const std::vector<std::string> &names);
+
+private:
+
+	void Resolve(const std::vector<std::string> &names);
+
+	std::vector<const GameObjectTypeClass *> Types;
+	bool Resolved;
+};
+
+
+
+
 class StoryEventClass : public SignalGeneratorClass
 {
 public:
@@ -528,9 +554,9 @@ public:
 	StoryRewardEnum Get_Reward_Type() { return (RewardType); }
 	void Set_Reward_Type(StoryRewardEnum type) { RewardType = type; }
 	bool Is_Triggered() { return (Triggered); }
-	void Set_Triggered(bool onoff) { Triggered = onoff; }
+	void Set_Triggered(bool onoff) { Triggered = onoff; Event_State_Changed(); }
 	bool Is_Active() { return (Active); }
-	void Set_Active(bool onoff) { Active = onoff; }
+	void Set_Active(bool onoff) { Active = onoff; Event_State_Changed(); }
 	bool Is_Multiplayer_Active() { return (Multiplayer); }
 	void Set_Multiplayer_Active(bool onoff) { Multiplayer = onoff; }
 	const std::string *Get_Reward_Param(int index) { return (&RewardParam[index]); }
@@ -561,7 +587,7 @@ public:
 	void Set_Start_Time(float starttime) { StartTime = starttime; }
 	float Get_Start_Time() { return (StartTime); }
 
-	void Disable_Event(bool onoff) { Disabled = onoff; }
+	void Disable_Event(bool onoff) { Disabled = onoff; Event_State_Changed(); }
 	bool Is_Disabled() { return (Disabled); }
 
 	void Set_Branch_Name(const std::string &name) { BranchName = name; }
@@ -588,11 +614,22 @@ public:
 
 	virtual void Activate() {}
 
+	// Names this event can match, for the event types the sub plot dispatches through its index.
+	// Returns false if the event has to see every dispatch of its type.
+	virtual bool Get_Dispatch_Keys(std::vector<CRCValue> &) { return (false); }
+	static CRCValue Get_Dispatch_Key(const std::string &name) { return (CRCClass::Calculate_CRC(name.c_str(), name.size())); }
+	static unsigned int Get_Dispatch_Key_Serial() { return (DispatchKeySerial); }
+
+	// Bumped whenever an event may have started or stopped waiting to trigger, for dispatchers
+	// that only send an event type when something it looks at has changed.
+	static void Event_State_Changed() { EventStateSerial++; }
+	static unsigned int Get_Event_State_Serial() { return (EventStateSerial); }
+
 	virtual bool Load( ChunkReaderClass *reader );
 	virtual bool Save( ChunkWriterClass *writer );
 
 	void Event_Triggered(GameObjectClass *planet = NULL, bool inactive = false);
-	void Clear_Triggered() { Triggered = false; Reset(); }
+	void Clear_Triggered() { Triggered = false; Reset(); Event_State_Changed(); }
 
 	// Look into script for a special case where we want to load a specific map
 	virtual bool Check_Special_Land_Tactical_Map(GameObjectClass *, GameObjectClass *) { return (false); }
@@ -759,8 +796,13 @@ protected:
 	bool All_Structures_Destroyed(PlayerClass *player);
 	bool All_Units_Destroyed(PlayerClass *player, bool check_structures);
 	bool All_Indigenous_Spawners_Destroyed(const GameObjectTypeClass *type);
+
+	// Call whenever the names returned by Get_Dispatch_Keys change
+	static void Dispatch_Keys_Changed() { DispatchKeySerial++; }
 	
 	static std::map<CRCValue,int> EnumLookup;
+	static unsigned int DispatchKeySerial;
+	static unsigned int EventStateSerial;
 
 	std::string EventName;
 	StoryEventEnum EventType;
@@ -857,6 +899,7 @@ public:
 private:
 
 	std::vector<std::string> Planet;
+	StoryTypeListClass PlanetTypes;
 	std::string ScriptName;
 };
 
@@ -899,6 +942,7 @@ public:
 	virtual bool Check_Special_Land_Tactical_Map(GameObjectClass *hero, GameObjectClass *planet);
 	virtual bool Check_Planet_Entry_Restrictions(GameObjectClass *fleet, GameObjectClass *planet);
 	virtual bool Check_Special_Space_Tactical_Map(GameObjectClass *hero, GameObjectClass *planet);
+	virtual bool Get_Dispatch_Keys(std::vector<CRCValue> &keys);
 
 	virtual bool Load( ChunkReaderClass *reader );
 	virtual bool Save( ChunkWriterClass *writer );
@@ -909,8 +953,10 @@ private:
 	bool Check_Orbit_Contents(GameObjectClass *planet);
 
 	std::vector<std::string> Planet;
+	StoryTypeListClass PlanetTypes;
 	std::vector<std::string> EnteringShip;
 	std::vector<std::string> OrbitingShip;
+	StoryTypeListClass OrbitingShipTypes;
 	StoryEventFilter Filter;
 	bool AllowStealth;
 	bool ExclusiveEnter;
@@ -933,6 +979,7 @@ public:
 	virtual void Set_Param(int index, std::vector<std::string> *param);
 	virtual void Replace_Variable(const std::string &var_name, const std::string &new_name);
 	virtual void Reset(); 
+	virtual bool Get_Dispatch_Keys(std::vector<CRCValue> &keys);
 
 	virtual bool Load( ChunkReaderClass *reader );
 	virtual bool Save( ChunkWriterClass *writer );
@@ -968,6 +1015,7 @@ private:
 	unsigned int Level;
 	StoryBaseFilter Filter;
 	std::vector<std::string> Planet;
+	StoryTypeListClass PlanetTypes;
 };
 
 
@@ -988,6 +1036,7 @@ private:
 
 	StoryBaseFilter Filter;
 	std::vector<std::string> Planet;
+	StoryTypeListClass PlanetTypes;
 	StoryEventFilter OwnerFilter;
 };
 
@@ -1004,6 +1053,7 @@ public:
 	virtual void Set_Param(int index, std::vector<std::string> *param);
 	virtual void Replace_Variable(const std::string &var_name, const std::string &new_name);
 	virtual void Reset();
+	virtual bool Get_Dispatch_Keys(std::vector<CRCValue> &keys);
 
 	virtual bool Load( ChunkReaderClass *reader );
 	virtual bool Save( ChunkWriterClass *writer );
@@ -1011,7 +1061,9 @@ public:
 private:
 
 	std::vector<std::string> Object;
+	StoryTypeListClass ObjectTypes;
 	std::vector<std::string> Planet;
+	StoryTypeListClass PlanetTypes;
 	std::vector<int> Count;
 	std::vector<int> CountCopy;
 	StoryEventFilter Filter;
@@ -1055,6 +1107,7 @@ private:
 
 	CorruptionTypeEnum CorruptionType;
 	std::vector<std::string> Planet;
+	StoryTypeListClass PlanetTypes;
 };
 
 
@@ -1081,6 +1134,7 @@ private:
 
 	std::vector<std::string> Hero;
 	std::vector<std::string> Planet;
+	StoryTypeListClass PlanetTypes;
 };
 
 
@@ -1172,6 +1226,7 @@ private:
 	FleetContentEnum ContentFilter;
 	DynamicVectorClass<ShipClassType> ContentTypes;
 	std::vector<std::string> Planet;
+	StoryTypeListClass PlanetTypes;
 };
 
 
@@ -1235,13 +1290,82 @@ private:
 
 
 
+// Local player units bucketed into a uniform XY grid, so each proximity event asks one
+// question per target object instead of walking every unit.  Update only reports a change,
+// and the proximity event is only sent, when a unit or a watched target moved, appeared or
+// went away, or when a story event started or stopped waiting to trigger.  The watched
+// target types are the ones the active proximity events asked for during the last send.
+class StoryProximityGridClass
+{
+public:
+
+	StoryProximityGridClass() : Valid(false), EventStateSerial(0) {}
+
+	bool Update(int player_id);
+	void Begin_Watch() { WatchedTypes.resize(0); }
+	void Watch_Target_Types(const std::vector<const GameObjectTypeClass *> &target_types);
+	void End_Watch();
+	bool Is_Empty() const { return (Units.empty()); }
+	bool Is_Unit_Within(const Vector3 &pos, float max_dist, const std::vector<const GameObjectTypeClass *> &unit_types) const;
+
+private:
+
+	struct UnitStruct
+	{
+		Vector3 Position;
+		const GameObjectTypeClass *Type;
+		int Cell;
+	};
+
+	struct SeenUnitStruct
+	{
+		Vector3 Position;
+		const GameObjectTypeClass *Type;
+	};
+
+	struct UnitCellLessStruct
+	{
+		bool operator()(const UnitStruct &left, const UnitStruct &right) const { return (left.Cell < right.Cell); }
+	};
+
+	static int Cell_Key(int cell_x, int cell_y) { return ((int)(((unsigned int)cell_x & 0xffff) | ((unsigned int)cell_y << 16))); }
+	static bool Type_Matches(const GameObjectTypeClass *type, const std::vector<const GameObjectTypeClass *> &unit_types);
+	static bool Same_Position(const Vector3 &a, const Vector3 &b) { return ((a.X == b.X) && (a.Y == b.Y) && (a.Z == b.Z)); }
+
+	bool Update_Units(int player_id);
+	bool Update_Targets();
+	void Build();
+
+	std::vector<UnitStruct> Units;
+	typedef stdext::hash_map<int, std::pair<int, int> > CellListType;
+	CellListType Cells;
+
+	// What the last Update saw, to tell whether anything moved since
+	std::vector<SeenUnitStruct> SeenUnits;
+	std::vector<const GameObjectTypeClass *> TargetTypes;
+	std::vector<Vector3> TargetPositions;
+	// Target types asked for so far during the current send
+	std::vector<const GameObjectTypeClass *> WatchedTypes;
+	bool Valid;
+	unsigned int EventStateSerial;
+};
+
+
+
+
 class StoryEventProximityClass : public StoryEventCommandUnitClass
 {
 public:
+
 	virtual void Evaluate_Event(void *param1, void *);
+	virtual void Set_Param(int index, std::vector<std::string> *param);
+	virtual void Replace_Variable(const std::string &var_name, const std::string &new_name);
 
 private:
-	void Check_For_Proximity(Vector3 &pos);
+
+	// Types looked up from UnitName and TargetName, redone whenever the names change
+	StoryTypeListClass UnitTypes;
+	StoryTypeListClass TargetTypes;
 };
 
 
@@ -1264,16 +1388,25 @@ class StoryEventFlagClass : public StoryEventClass
 {
 public:
 
-	StoryEventFlagClass() : Value(0), Comparison(COMPARE_EQUAL_TO) {};
+	StoryEventFlagClass() : Value(0), Comparison(COMPARE_EQUAL_TO), Checked(false), CheckedSerial(0) {};
 
 	virtual void Evaluate_Event(void * param1, void *);
 	virtual void Set_Param(int index, std::vector<std::string> *param);
 
+	// Change tracking for StorySubPlotClass::Check_Flags
+	bool Needs_Evaluation();
+	void Clear_Checked() { Checked = false; }
+
 private:
 
 	std::vector<std::string> FlagNames;
+	std::vector<CRCValue> FlagCRCs;
 	int Value;
 	StoryCompareEnum Comparison;
+
+	// Set once the flags have been read while active, with the flag change serial at the time
+	bool Checked;
+	unsigned int CheckedSerial;
 };
 
 
@@ -1296,7 +1429,9 @@ public:
 private:
 
 	std::vector<std::string> Hero;
+	StoryTypeListClass HeroTypes;
 	std::vector<std::string> Planet;
+	StoryTypeListClass PlanetTypes;
 	StoryBaseFilter Base;
 };
 
@@ -1394,6 +1529,7 @@ public:
 private:
 
 	std::vector<std::string> Structure;
+	StoryTypeListClass StructureTypes;
 	const FactionClass *NewFaction;
 };
 
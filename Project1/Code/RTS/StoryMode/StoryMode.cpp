@@ -56,11 +56,15 @@
 #include "SpawnIndigenousUnitsBehavior.h"
 #include "FleetBehavior.h"
 #include "ScheduledEventQueue.h"
+#include "LuaScript.h"
 
 static const char *XML_DATA_FILE_PATH = ".\\Data\\XML\\";
 //StoryModeClass TheStoryMode;
 
 StoryModeClass::StoryFlagListType StoryModeClass::Flags;
+StoryModeClass::FlagChangeListType StoryModeClass::FlagChanges;
+unsigned int StoryModeClass::FlagChangeSerial = 0;
+unsigned int StoryModeClass::AllFlagsChangeSerial = 0;
 DynamicVectorClass<int> StoryModeClass::LandForces;
 const bool *StoryModeClass::IsForegroundApp = NULL;
 
@@ -220,6 +224,10 @@ bool StoryModeClass::Load_Plots(const std::string &name, PlayerClass *player)
 	PlotName = name;
 	std::string fullname = ".\\Data\\XML\\" + name;
 
+	// We're behind the loading screen, so this is the time to load the script pools the
+	// mode is expected to need.  Does nothing if another mode already preloaded them.
+	LuaScriptClass::Preload_Script_Pools();
+
 	//
 	// Allocate and read a temporary database of the filenames
 	//
@@ -481,6 +489,9 @@ void StoryModeClass::Story_Event(StoryEventEnum event, PlayerClass *player, void
 **************************************************************************************************/
 void StoryModeClass::Check_Plots(float elapsed)
 {
+	// Script pools are part of the sync CRC, so grow them from the game frame.
+	LuaScriptClass::Top_Up_Script_Pools();
+
 	SubPlotListType::iterator plotptr;
 	for (plotptr = SubPlots.begin(); plotptr != SubPlots.end(); plotptr++)
 	{
@@ -1768,23 +1779,17 @@ void StoryModeClass::Check_Proximity()
 	// so we need to eliminate them.  Testing shows that pre-placed units do seem to work ok now.
 	// (jason) Get_Selectable_Objects call fails to include units placed on the map by the designers
 	// Get selectable objects should be more efficient
-	//const DynamicVectorClass<GameObjectClass *> *object_list = GAME_OBJECT_MANAGER.Find_Objects( BEHAVIOR_SELECTABLE, player_id );
-	ReferenceListClass<GameObjectClass> *selection_list = GAME_OBJECT_MANAGER.Get_Selectable_Objects();
-	ReferenceListIterator<GameObjectClass> it(selection_list);
-
-	//for (int i=0; i<object_list->Size(); i++)
-	for (; !it.Is_Done(); it.Next())
+	// Bucket the local player's units once and send a single event with the whole grid, rather than
+	// one event per unit that every proximity event then has to check against every target.
+	// Nothing is sent while the units, the watched targets and the events' states stay the same.
+	if (!ProximityGrid.Update(player_id) || ProximityGrid.Is_Empty())
 	{
-		//GameObjectClass *object = (*object_list)[i];
-		GameObjectClass *object = it.Current_Object();
-
-		// Don't need to do this if check since the Find_Objects already screens for player ownership
-		// (gth) not using Find_Objects now
-		if ((object->Get_Owner() == player_id) && (!object->Behaves_Like(BEHAVIOR_PROJECTILE)))
-		{
-			Story_Event(STORY_UNIT_PROXIMITY,PlayerList.Get_Local_Player(),object,NULL);
-		}
+		return;
 	}
+
+	ProximityGrid.Begin_Watch();
+	Story_Event(STORY_UNIT_PROXIMITY,PlayerList.Get_Local_Player(),&ProximityGrid,NULL);
+	ProximityGrid.End_Watch();
 }
 
 
@@ -1813,7 +1818,7 @@ bool StoryModeClass::Load(ChunkReaderClass *reader)
 
 	bool ok = true;
 
-	Flags.clear();
+	Reset_Flags();
 	Remove_Plots();
 
 	std::wstring displayText;
@@ -2101,6 +2106,11 @@ void StoryModeClass::Set_Flag(const char *name, int value)
 	var.Value = value;
 
 	CRCValue crc = CRCClass::Calculate_CRC( var.Name, strlen(var.Name) );
+	StoryFlagListType::iterator varptr = Flags.find(crc);
+	if ((varptr == Flags.end()) || (varptr->second.Value != value))
+	{
+		Flag_Changed(crc);
+	}
 	Flags[crc] = var;
 
 	Story_Debug_Printf("Flag %s set to value %d, CRC %u\r\n",new_name,value,crc);
@@ -2114,13 +2124,16 @@ void StoryModeClass::Set_Flag(const char *name, int value)
 int StoryModeClass::Get_Flag(const char *name)
 {
 	assert(name);
+	return (Get_Flag(Get_Flag_CRC(name)));
+}
 
-	// Just make all variables upper case to remove any case mismatching
-	char new_name[256];
-	strcpy(new_name,name);
-	_strupr(new_name);
 
-	CRCValue crc = CRCClass::Calculate_CRC( new_name, strlen(new_name) );
+
+
+
+
+int StoryModeClass::Get_Flag(CRCValue crc)
+{
 	StoryFlagListType::iterator varptr;
 
 	varptr = Flags.find(crc);
@@ -2157,6 +2170,10 @@ int StoryModeClass::Increment_Flag(const char *name, int increment)
 	{
 		FlagStruct *var = &varptr->second;
 		var->Value += increment;
+		if (increment != 0)
+		{
+			Flag_Changed(crc);
+		}
 
 		Story_Debug_Printf("Flag %s incremented by %d to new value %d\r\n",var->Name,increment,var->Value);
 		return (var->Value);
@@ -2175,6 +2192,72 @@ int StoryModeClass::Increment_Flag(const char *name, int increment)
 
 
 
+CRCValue StoryModeClass::Get_Flag_CRC(const char *name)
+{
+	assert(name);
+
+	// Just make all variables upper case to remove any case mismatching
+	char new_name[256];
+	strcpy(new_name,name);
+	_strupr(new_name);
+
+	return (CRCClass::Calculate_CRC( new_name, strlen(new_name) ));
+}
+
+
+
+
+
+
+void StoryModeClass::Reset_Flags()
+{
+	Flags.clear();
+	All_Flags_Changed();
+}
+
+
+
+
+
+
+void StoryModeClass::Flag_Changed(CRCValue crc)
+{
+	FlagChanges[crc] = ++FlagChangeSerial;
+}
+
+
+
+
+
+
+void StoryModeClass::All_Flags_Changed()
+{
+	// Old per flag serials are all older than this one now
+	FlagChanges.clear();
+	AllFlagsChangeSerial = ++FlagChangeSerial;
+}
+
+
+
+
+
+
+bool StoryModeClass::Has_Flag_Changed_Since(CRCValue crc, unsigned int serial)
+{
+	if (AllFlagsChangeSerial > serial)
+	{
+		return (true);
+	}
+
+	FlagChangeListType::iterator changeptr = FlagChanges.find(crc);
+	return ((changeptr != FlagChanges.end()) && (changeptr->second > serial));
+}
+
+
+
+
+
+
 void StoryModeClass::Load_Tactical_Map(GameObjectClass *planet, StoryBaseFilter *location)
 {
 	if (planet && location)
@@ -190,8 +190,15 @@ public:
 	// Script defined variables.  They're available across all scripts
 	static void Set_Flag(const char *name, int value);
 	static int Get_Flag(const char *name);
+	static int Get_Flag(CRCValue crc);
 	static int Increment_Flag(const char *name, int increment);
-	static void Reset_Flags() { Flags.clear(); }
+	static void Reset_Flags();
+	static CRCValue Get_Flag_CRC(const char *name);
+
+	// Every flag change bumps a serial, so flag events can tell whether anything they read has
+	// changed since they last looked instead of reading every flag every frame
+	static unsigned int Get_Flag_Change_Serial() { return (FlagChangeSerial); }
+	static bool Has_Flag_Changed_Since(CRCValue crc, unsigned int serial);
 
 	// Objectives
 	void Add_Objective(const std::string &objective, const std::wstring *display_text = NULL, bool suggestion = false, int index = -1);
@@ -245,8 +252,18 @@ private:
 
 	bool DelayedBattleEnd;
 
+	// Local player units for STORY_UNIT_PROXIMITY, rebuilt when they move
+	StoryProximityGridClass ProximityGrid;
+
+	static void Flag_Changed(CRCValue crc);
+	static void All_Flags_Changed();
+
 	static DynamicVectorClass<int> LandForces;
 	static StoryFlagListType Flags;
+	typedef stdext::hash_map<CRCValue, unsigned int> FlagChangeListType;
+	static FlagChangeListType FlagChanges;
+	static unsigned int FlagChangeSerial;
+	static unsigned int AllFlagsChangeSerial;
 	static const bool *IsForegroundApp;
 };
 
@@ -9,6 +9,7 @@
 #include "UtilityCommands.h"
 #include "AI/TheAIDataManager.h"
 #include "FleetBehavior.h"
+#include <algorithm>
 
 static const char *XML_DATA_FILE_PATH = ".\\Data\\XML\\";
 
@@ -321,17 +322,67 @@ void StorySubPlotClass::Sort_Events_And_Compute_Dependants()
 
 void StorySubPlotClass::Story_Event(StoryEventEnum event_type, PlayerClass *player, void *param1, void *param2)
 {
+	if ((player != NULL) && (player != LocalPlayer))
+	{
+		return;
+	}
+
+	GameModeClass::GameModeType game_type = GameModeManager.Get_Type();
+	bool multiplayer = (game_type != GameModeClass::SOLO) && (game_type != GameModeClass::SKIRMISH);
+
 	// Pass this event on to all the events of this type in the plot
 	DynamicVectorClass<StoryEventClass *> *enter_events;
 
 	enter_events = &SortedEvents[event_type];
+
+	CRCValue key;
+	if (Get_Dispatch_Key(event_type, param1, key))
+	{
+		// Only the events that name this object can trigger, so look them up instead of walking every
+		// event of the type.  They're still evaluated in SortedEvents order.
+		DispatchIndexStruct &index = DispatchIndex[event_type];
+		if ((index.KeySerial != StoryEventClass::Get_Dispatch_Key_Serial()) || (index.EventCount != enter_events->Size()))
+		{
+			Build_Dispatch_Index(event_type);
+		}
+
+		// Work from a copy, since a triggered event can change the names and rebuild the index
+		std::vector<int> candidates;
+		DispatchKeyListType::iterator keyptr = index.Keyed.find(key);
+		if (keyptr == index.Keyed.end())
+		{
+			candidates = index.Unkeyed;
+		}
+		else
+		{
+			candidates.resize(index.Unkeyed.size() + keyptr->second.size());
+			std::merge(index.Unkeyed.begin(), index.Unkeyed.end(), keyptr->second.begin(), keyptr->second.end(), candidates.begin());
+		}
+
+		for (unsigned int i=0; i<candidates.size(); i++)
+		{
+			if (candidates[i] >= enter_events->Size())
+			{
+				break;
+			}
+
+			StoryEventClass *event = (*enter_events)[candidates[i]];
+			if (Is_Event_Active(event, multiplayer))
+			{
+				event->Evaluate_Event(param1,param2);
+			}
+		}
+
+		return;
+	}
+
 	for (int i=0; i<enter_events->Size(); i++)
 	{
 		StoryEventClass *event = (*enter_events)[i];
 
 		if (event)
 		{
-			if (Is_Event_Active(event) && ((player == NULL) || (player == LocalPlayer)) )
+			if (Is_Event_Active(event, multiplayer))
 			{
 				event->Evaluate_Event(param1,param2);
 			}
@@ -343,17 +394,99 @@ void StorySubPlotClass::Story_Event(StoryEventEnum event_type, PlayerClass *play
 
 
 
-bool StorySubPlotClass::Is_Event_Active(StoryEventClass *event)
+bool StorySubPlotClass::Get_Dispatch_Key(StoryEventEnum event_type, void *param1, CRCValue &key)
 {
-	if (!event || !event->Is_Active() || event->Is_Triggered() || event->Is_Disabled())
+	if (param1 == NULL)
 	{
 		return (false);
 	}
 
+	switch (event_type)
+	{
+		case STORY_ENTER:
+			key = StoryEventClass::Get_Dispatch_Key(*((GameObjectClass *)param1)->Get_Type()->Get_Name());
+			return (true);
+
+		case STORY_CONQUER:
+		case STORY_CONSTRUCT:
+			key = StoryEventClass::Get_Dispatch_Key(*(std::string *)param1);
+			return (true);
+
+		case STORY_DESTROY:
+			key = StoryEventClass::Get_Dispatch_Key(*((const GameObjectTypeClass *)param1)->Get_Name());
+			return (true);
+
+		default:
+			return (false);
+	}
+}
+
+
+
+
+
+void StorySubPlotClass::Build_Dispatch_Index(StoryEventEnum event_type)
+{
+	DynamicVectorClass<StoryEventClass *> *events = &SortedEvents[event_type];
+	DispatchIndexStruct &index = DispatchIndex[event_type];
+
+	index.KeySerial = StoryEventClass::Get_Dispatch_Key_Serial();
+	index.EventCount = events->Size();
+	index.Keyed.clear();
+	index.Unkeyed.resize(0);
+
+	std::vector<CRCValue> keys;
+	for (int i=0; i<events->Size(); i++)
+	{
+		StoryEventClass *event = (*events)[i];
+		if (event == NULL)
+		{
+			continue;
+		}
+
+		keys.resize(0);
+		if (!event->Get_Dispatch_Keys(keys))
+		{
+			index.Unkeyed.push_back(i);
+			continue;
+		}
+
+		// An event listing the same name twice is only evaluated once
+		for (unsigned int k=0; k<keys.size(); k++)
+		{
+			std::vector<int> &key_events = index.Keyed[keys[k]];
+			if (key_events.empty() || (key_events.back() != i))
+			{
+				key_events.push_back(i);
+			}
+		}
+	}
+}
+
+
+
+
+
+bool StorySubPlotClass::Is_Event_Active(StoryEventClass *event)
+{
 	GameModeClass::GameModeType game_type = GameModeManager.Get_Type();
 
+	return (Is_Event_Active(event, (game_type != GameModeClass::SOLO) && (game_type != GameModeClass::SKIRMISH)));
+}
+
+
+
+
+
+bool StorySubPlotClass::Is_Event_Active(StoryEventClass *event, bool multiplayer)
+{
+	if (!event || !event->Is_Active() || event->Is_Triggered() || event->Is_Disabled())
+	{
+		return (false);
+	}
+
 	// Event is active and not triggered, but some events don't occur in multiplayer
-	if ((game_type == GameModeClass::SOLO) || (game_type == GameModeClass::SKIRMISH))
+	if (!multiplayer)
 	{
 		// Not a multiplayer game, so no reason to disable
 		return (true);
@@ -776,12 +909,21 @@ void StorySubPlotClass::Check_Flags()
 {
 	DynamicVectorClass<StoryEventClass *> *events = &SortedEvents[STORY_FLAG];
 
+	// Flag events only read their flags again when one of them has changed, or when the event
+	// has just become active
 	for (int i=0; i<events->Size(); i++)
 	{
-		StoryEventClass *event = (*events)[i];
+		StoryEventFlagClass *event = (StoryEventFlagClass *)(*events)[i];
 		if (Is_Event_Active(event))
 		{
-			event->Evaluate_Event(NULL,NULL);
+			if (event->Needs_Evaluation())
+			{
+				event->Evaluate_Event(NULL,NULL);
+			}
+		}
+		else if (event)
+		{
+			event->Clear_Checked();
 		}
 	}
 }
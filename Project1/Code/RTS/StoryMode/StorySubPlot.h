@@ -34,7 +34,7 @@ public:
 
 	const std::string &Get_Name() { return (Name); }
 	bool Is_Active() { return (Active); }
-	void Set_Active(bool onoff) { Active = onoff; }
+	void Set_Active(bool onoff) { Active = onoff; StoryEventClass::Event_State_Changed(); }
 
 	void Set_Local_Player(PlayerClass *player) { LocalPlayer = player; }
 	PlayerClass *Get_Local_Player() { return (LocalPlayer); }
@@ -85,10 +85,28 @@ public:
 
 private:
 
+	typedef stdext::hash_map<CRCValue, std::vector<int> > DispatchKeyListType;
+
+	// Events of one type keyed by the names they can match, as indices into SortedEvents
+	struct DispatchIndexStruct
+	{
+		DispatchIndexStruct() : KeySerial(0), EventCount(-1) {}
+
+		unsigned int KeySerial;
+		int EventCount;
+		DispatchKeyListType Keyed;
+		std::vector<int> Unkeyed;				// Events that see every dispatch of this type
+	};
+
 	bool Is_Event_Active(StoryEventClass *event);
+	bool Is_Event_Active(StoryEventClass *event, bool multiplayer);
+
+	static bool Get_Dispatch_Key(StoryEventEnum event_type, void *param1, CRCValue &key);
+	void Build_Dispatch_Index(StoryEventEnum event_type);
 
 	StoryEventListType StoryEvents;													// All events
 	DynamicVectorClass<StoryEventClass *> SortedEvents[STORY_COUNT];		// All events sorted by type
+	DispatchIndexStruct DispatchIndex[STORY_COUNT];								// Built on first dispatch of an indexed type
 	SmartPtr<LuaScriptClass> LuaScript;
 	DynamicVectorClass<StoryEventClass *> TimeoutEvents;						// Some events timeout after awhile
 